@@ -0,0 +1,35 @@
+//===- vec_math.h -----------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+/// \file
+/// Elementwise math functions on v8float, the native float vector of AIE.
+/// They are built from polynomial approximations and Newton iterations on the
+/// vector unit, instead of calling scalar libm once per lane. The
+/// convert-vector-to-aievec lowering replaces math.exp, math.tanh, math.rsqrt
+/// and sigmoid expressions (1 / (1 + exp(-x))) on float vectors with calls to
+/// these functions.
+
+#ifndef AIE_RUNTIME_LIB_AIE_VEC_MATH_H
+#define AIE_RUNTIME_LIB_AIE_VEC_MATH_H
+
+/// e^x. Inputs are clamped to [-87, 88], so that the result stays a normal
+/// float. The relative error is below 2e-7.
+extern "C" v8float vec_exp_v8float(v8float x);
+
+/// tanh(x), computed from e^(-2|x|). The absolute error is below 3e-7.
+extern "C" v8float vec_tanh_v8float(v8float x);
+
+/// 1 / (1 + e^(-x)). The absolute error is below 3e-7.
+extern "C" v8float vec_sigmoid_v8float(v8float x);
+
+/// 1 / sqrt(x), for positive normal x. The relative error is below 1e-6.
+extern "C" v8float vec_rsqrt_v8float(v8float x);
+
+#endif // AIE_RUNTIME_LIB_AIE_VEC_MATH_H
@@ -0,0 +1,28 @@
+//===- vec_math.cpp ---------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+/// \file
+/// The functions declared in vec_math.h, on the v16float vectors of AIE-ML.
+/// The implementation is shared by every target, see vec_math_impl.h.
+
+#include "vec_math.h"
+#include "vec_math_impl.h"
+
+using VecMath = vec_math::VecMath<16>;
+
+extern "C" v16float vec_exp_v16float(v16float x) { return VecMath::exp(x); }
+
+extern "C" v16float vec_tanh_v16float(v16float x) { return VecMath::tanh(x); }
+
+extern "C" v16float vec_sigmoid_v16float(v16float x) {
+  return VecMath::sigmoid(x);
+}
+
+extern "C" v16float vec_rsqrt_v16float(v16float x) { return VecMath::rsqrt(x); }
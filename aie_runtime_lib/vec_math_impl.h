@@ -0,0 +1,110 @@
+//===- vec_math_impl.h ------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+/// \file
+/// Vectorized implementation of the functions declared in
+/// <target>/vec_math.h, shared by every target and parameterized on the number
+/// of float lanes of its native vector. Every function works on whole
+/// vectors: range reductions are done with float adds and integer operations
+/// on the bit patterns, so that no lane ever goes through a scalar libm call.
+
+#ifndef AIE_RUNTIME_LIB_VEC_MATH_IMPL_H
+#define AIE_RUNTIME_LIB_VEC_MATH_IMPL_H
+
+#include <aie_api/aie.hpp>
+
+namespace vec_math {
+
+template <unsigned Lanes> struct VecMath {
+  using vfloat = aie::vector<float, Lanes>;
+  using vint = aie::vector<int32, Lanes>;
+
+  static vfloat splat(float value) {
+    return aie::broadcast<float, Lanes>(value);
+  }
+
+  static vint splat(int32 value) { return aie::broadcast<int32, Lanes>(value); }
+
+  static vfloat mul(vfloat a, vfloat b) {
+    return aie::mul(a, b).template to_vector<float>();
+  }
+
+  // a * b + c
+  static vfloat mulAdd(vfloat a, vfloat b, vfloat c) {
+    return aie::add(mul(a, b), c);
+  }
+
+  static vint asInt(vfloat v) { return aie::vector_cast<int32>(v); }
+
+  static vfloat asFloat(vint v) { return aie::vector_cast<float>(v); }
+
+  // 1 / d, for positive normal d: the initial estimate comes from the bit
+  // pattern of d, and is refined with three Newton iterations.
+  static vfloat reciprocal(vfloat d) {
+    vfloat y = asFloat(aie::sub(splat(int32(0x7ef311c3)), asInt(d)));
+    for (unsigned i = 0; i < 3; i++)
+      y = mul(y, aie::sub(splat(2.0f), mul(d, y)));
+    return y;
+  }
+
+  static vfloat exp(vfloat in) {
+    vfloat x = aie::min(aie::max(in, -87.0f), 88.0f);
+
+    // x = n * ln(2) + r, with n the nearest integer to x / ln(2). Adding
+    // 1.5 * 2^23 rounds to the nearest integer, and leaves it in the low bits
+    // of the mantissa.
+    const float roundingBias = 12582912.0f;
+    vfloat t = mulAdd(x, splat(1.44269504f), splat(roundingBias));
+    vint n = aie::sub(asInt(t), asInt(splat(roundingBias)));
+    vfloat nf = aie::sub(t, splat(roundingBias));
+    vfloat r = mulAdd(nf, splat(-0.693359375f), x);
+    r = mulAdd(nf, splat(2.12194440e-4f), r);
+
+    // e^r on [-ln(2) / 2, ln(2) / 2].
+    vfloat p = splat(1.9875691500e-4f);
+    p = mulAdd(p, r, splat(1.3981999507e-3f));
+    p = mulAdd(p, r, splat(8.3334519073e-3f));
+    p = mulAdd(p, r, splat(4.1665795894e-2f));
+    p = mulAdd(p, r, splat(1.6666665459e-1f));
+    p = mulAdd(p, r, splat(5.0000001201e-1f));
+    p = mulAdd(p, mul(r, r), aie::add(r, splat(1.0f)));
+
+    // Scale by 2^n by adding n to the exponent.
+    return asFloat(aie::add(asInt(p), aie::upshift(n, 23)));
+  }
+
+  static vfloat tanh(vfloat x) {
+    // tanh(|x|) = (1 - e^(-2|x|)) / (1 + e^(-2|x|)), which doesn't overflow.
+    vfloat e = exp(mul(aie::abs(x), splat(-2.0f)));
+    vfloat t = mul(aie::sub(splat(1.0f), e),
+                   reciprocal(aie::add(splat(1.0f), e)));
+    // tanh is odd: copy the sign of x.
+    vint sign = aie::bit_and(asInt(x), splat(int32(0x80000000)));
+    return asFloat(aie::bit_or(asInt(t), sign));
+  }
+
+  static vfloat sigmoid(vfloat x) {
+    vfloat e = exp(mul(x, splat(-1.0f)));
+    return reciprocal(aie::add(splat(1.0f), e));
+  }
+
+  static vfloat rsqrt(vfloat x) {
+    vfloat halfX = mul(x, splat(0.5f));
+    vfloat y = asFloat(
+        aie::sub(splat(int32(0x5f3759df)), aie::downshift(asInt(x), 1)));
+    for (unsigned i = 0; i < 3; i++)
+      y = mul(y, aie::sub(splat(1.5f), mul(halfX, mul(y, y))));
+    return y;
+  }
+};
+
+} // namespace vec_math
+
+#endif // AIE_RUNTIME_LIB_VEC_MATH_IMPL_H
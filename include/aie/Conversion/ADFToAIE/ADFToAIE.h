@@ -0,0 +1,29 @@
+//===- ADFToAIE.h - ADF graph to AIE dialect conversion ---------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_CONVERSION_ADFTOAIE_ADFTOAIE_H
+#define AIE_CONVERSION_ADFTOAIE_ADFTOAIE_H
+
+#include <memory>
+
+namespace mlir {
+class ModuleOp;
+template <typename T>
+class OperationPass;
+} // namespace mlir
+
+namespace xilinx {
+namespace ADF {
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+createConvertADFToAIEPass();
+} // namespace ADF
+} // namespace xilinx
+
+#endif // AIE_CONVERSION_ADFTOAIE_ADFTOAIE_H
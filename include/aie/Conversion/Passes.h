@@ -11,6 +11,7 @@
 #ifndef AIE_CONVERSION_PASSES_H
 #define AIE_CONVERSION_PASSES_H
 
+#include "aie/Conversion/ADFToAIE/ADFToAIE.h"
 #include "aie/Conversion/AIEVecToLLVM/AIEVecToLLVM.h"
 
 namespace xilinx {
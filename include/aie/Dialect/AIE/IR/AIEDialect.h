@@ -70,6 +70,16 @@ namespace AIE {
 
 void registerAIETranslations();
 
+// Generate the GNU linker script (resp. Chess bcf) for the core at the given
+// tile.  These back the aie-generate-ldscript and aie-generate-bcf
+// translations.
+mlir::LogicalResult AIETranslateToLdScript(mlir::ModuleOp module,
+                                           llvm::raw_ostream &output,
+                                           int tileCol, int tileRow);
+mlir::LogicalResult AIETranslateToBCF(mlir::ModuleOp module,
+                                      llvm::raw_ostream &output, int tileCol,
+                                      int tileRow);
+
 // FIXME: use this
 //#include "AIEDialect.h.inc"
 
@@ -198,6 +208,12 @@ const xilinx::AIE::AIETargetModel &getTargetModel(Operation *op);
 } // namespace AIE
 } // namespace xilinx
 
+namespace mlir {
+namespace vector {
+class VectorDialect;
+} // namespace vector
+} // namespace mlir
+
 // include TableGen generated Op definitions
 #define GET_OP_CLASSES
 #include "aie/Dialect/AIE/IR/AIE.h.inc"
@@ -219,10 +235,13 @@ std::unique_ptr<OperationPass<ModuleOp>> createAIERouteFlowsPass();
 std::unique_ptr<OperationPass<DeviceOp>> createAIERoutePacketFlowsPass();
 std::unique_ptr<OperationPass<func::FuncOp>> createAIEVectorOptPass();
 std::unique_ptr<OperationPass<DeviceOp>> createAIEPathfinderPass();
+std::unique_ptr<OperationPass<DeviceOp>> createAIEPlaceTilesPass();
+std::unique_ptr<OperationPass<ModuleOp>> createAIETilingSearchPass();
 std::unique_ptr<OperationPass<DeviceOp>>
 createAIEObjectFifoStatefulTransformPass();
 std::unique_ptr<OperationPass<DeviceOp>>
 createAIEObjectFifoRegisterProcessPass();
+std::unique_ptr<OperationPass<DeviceOp>> createAIEObjectFifoCascadePass();
 
 /// Generate the code for registering passes.
 #define GEN_PASS_REGISTRATION
@@ -103,6 +103,11 @@ public:
   virtual bool isLegalMemAffinity(int coreCol, int coreRow, int memCol,
                                   int memRow) const = 0;
 
+  /// Return true if the cascade output of the core in src can feed the
+  /// cascade input of the core in dst
+  virtual bool isLegalCascade(int srcCol, int srcRow, int dstCol,
+                              int dstRow) const = 0;
+
   /// Return the base address in the local address map of differnet memories.
   virtual uint32_t getMemInternalBaseAddress(TileID src) const = 0;
   virtual uint32_t getMemSouthBaseAddress() const = 0;
@@ -174,6 +179,8 @@ public:
 
   bool isLegalMemAffinity(int coreCol, int coreRow, int memCol,
                           int memRow) const override;
+  bool isLegalCascade(int srcCol, int srcRow, int dstCol,
+                      int dstRow) const override;
 
   uint32_t getMemInternalBaseAddress(TileID src) const override {
     bool IsEvenRow = ((src.second % 2) == 0);
@@ -230,6 +237,8 @@ public:
 
   bool isLegalMemAffinity(int coreCol, int coreRow, int memCol,
                           int memRow) const override;
+  bool isLegalCascade(int srcCol, int srcRow, int dstCol,
+                      int dstRow) const override;
 
   uint32_t getMemInternalBaseAddress(TileID src) const override {
     return getMemEastBaseAddress();
@@ -50,10 +50,18 @@ struct ConvertVectorToAIEVecOptions
                                       aieTarget};
   }
 
+  LegalizeVectorForAIEVecOptions getLegalizeVectorForAIEVecOptions() const {
+    return LegalizeVectorForAIEVecOptions{aieTarget};
+  }
+
   CanonicalizeForAIEVecOptions getCanonicalizeForAIEVecOptions() const {
     return CanonicalizeForAIEVecOptions{aieTarget};
   }
 
+  LowerVectorMathToAIEVecOptions getLowerVectorMathToAIEVecOptions() const {
+    return LowerVectorMathToAIEVecOptions{aieTarget};
+  }
+
   AIEVecTransformationOptions getAIEVecTransformationOptions() const {
     return AIEVecTransformationOptions{aieTarget};
   }
@@ -0,0 +1,471 @@
+//===- ADFToAIE.cpp - ADF graph to AIE dialect conversion -------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass maps an ADF graph onto an AIE device. Every kernel of the graph
+// runs on its own core tile, and every graph port is bound to its own shim NOC
+// tile. Window connections become objectFifos and stream connections become
+// flows, so that the buffers, locks, DMAs and routes of the graph are produced
+// by the usual AIE passes.
+
+#include "../PassDetail.h"
+
+#include "aie/Conversion/ADFToAIE/ADFToAIE.h"
+#include "aie/Dialect/ADF/ADFDialect.h"
+#include "aie/Dialect/ADF/ADFOps.h"
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/SymbolTable.h"
+
+#include "llvm/ADT/DenseMap.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::ADF;
+
+// Depth of the objectFifos that implement windows, so that the producer can
+// fill one window while the consumers work on the previous one.
+static const int windowDepth = 2;
+
+// Return the element type used on the AIE side for an ADF data type, or a null
+// type if the data type is not supported.
+static Type convertDataType(Type type) {
+  MLIRContext *ctx = type.getContext();
+  if (type.isa<int8Type, uint8Type>())
+    return IntegerType::get(ctx, 8);
+  if (type.isa<int16Type, uint16Type>())
+    return IntegerType::get(ctx, 16);
+  if (type.isa<int32Type, uint32Type>())
+    return IntegerType::get(ctx, 32);
+  if (type.isa<int64Type, uint64Type>())
+    return IntegerType::get(ctx, 64);
+  if (type.isa<floatType>())
+    return Float32Type::get(ctx);
+  return {};
+}
+
+// Return the memref holding one window, or a null type if the window can't be
+// represented.
+static MemRefType convertWindowType(WindowType window) {
+  Type elementType = convertDataType(window.getType());
+  if (!elementType)
+    return {};
+  int64_t elementBytes = elementType.getIntOrFloatBitWidth() / 8;
+  if (window.getSize() <= 0 || window.getSize() % elementBytes)
+    return {};
+  return MemRefType::get({window.getSize() / elementBytes}, elementType);
+}
+
+// Check that a port of a kernel or of the graph can be mapped to the AIE
+// dialect.
+static LogicalResult verifyPortType(Operation *op, Type type) {
+  if (type.isa<ParameterType>())
+    return op->emitOpError("runtime parameters are not supported");
+  if (auto window = type.dyn_cast<WindowType>()) {
+    if (window.getOverlap() != 0)
+      return op->emitOpError("overlapping windows are not supported");
+    if (!convertWindowType(window))
+      return op->emitOpError("unsupported window type ") << window;
+    return success();
+  }
+  if (auto stream = type.dyn_cast<StreamType>()) {
+    if (!convertDataType(stream.getType()))
+      return op->emitOpError("unsupported stream type ") << stream;
+    return success();
+  }
+  return op->emitOpError("unsupported port type ") << type;
+}
+
+// Return the uses of a value in the order of the graph, so that the connections
+// are created in the order in which they were written.
+static SmallVector<OpOperand *> getUsesInOrder(Value value) {
+  SmallVector<OpOperand *> uses;
+  for (OpOperand &use : value.getUses())
+    uses.push_back(&use);
+  llvm::sort(uses, [](OpOperand *a, OpOperand *b) {
+    if (a->getOwner() != b->getOwner())
+      return a->getOwner()->isBeforeInBlock(b->getOwner());
+    return a->getOperandNumber() < b->getOperandNumber();
+  });
+  return uses;
+}
+
+namespace {
+
+// An endpoint of a stream connection.
+struct StreamPort {
+  AIE::TileOp tile;
+  AIE::WireBundle bundle;
+  int channel;
+};
+
+class GraphConverter {
+public:
+  GraphConverter(GraphOp graph, unsigned iterations)
+      : graph(graph), iterations(iterations) {}
+
+  LogicalResult convert(AIE::AIEDevice deviceKind);
+
+private:
+  // Return the window or stream type carried by a value of the graph, as seen
+  // by its producer.
+  Type getProducedType(Value value);
+
+  // Return the window or stream type expected by the consumer of a use.
+  Type getConsumedType(OpOperand &use);
+
+  func::FuncOp getKernelFunc(KernelOp kernel) {
+    return SymbolTable::lookupNearestSymbolFrom<func::FuncOp>(
+        graph, kernel.getCalleeAttr());
+  }
+
+  LogicalResult verify();
+  LogicalResult createTiles(OpBuilder &builder,
+                            const AIE::AIETargetModel &targetModel);
+  void createConnections(OpBuilder &builder);
+  void createCore(OpBuilder &builder, KernelOp kernel);
+  void convertKernelFunc(func::FuncOp funcOp);
+
+  GraphOp graph;
+  unsigned iterations;
+  SmallVector<KernelOp> kernels;
+  // Values of the graph produced by a graph input or a kernel.
+  SmallVector<Value> producedValues;
+  // The tile of each kernel and graph port.
+  DenseMap<Operation *, AIE::TileOp> tiles;
+  // The objectFifo implementing each window.
+  DenseMap<Value, AIE::ObjectFifoCreateOp> windowFifos;
+  // The kernel functions, in order of first use.
+  SmallVector<func::FuncOp> kernelFuncs;
+};
+
+} // namespace
+
+Type GraphConverter::getProducedType(Value value) {
+  Operation *producer = value.getDefiningOp();
+  if (auto kernel = dyn_cast<KernelOp>(producer))
+    return getKernelFunc(kernel).getFunctionType().getResult(0);
+
+  // The interface of a graph input is given as [isStream, windowBytes].
+  auto input = cast<GraphInputOp>(producer);
+  auto dataType =
+      input.getOutput().getType().cast<InterfaceType>().getType();
+  auto interface = input.getValue();
+  auto isStream = interface[0].cast<IntegerAttr>().getValue();
+  if (!isStream.isZero())
+    return StreamType::get(graph.getContext(), dataType);
+  int size = interface[1].cast<IntegerAttr>().getInt();
+  return WindowType::get(graph.getContext(), dataType, size, /*overlap=*/0);
+}
+
+Type GraphConverter::getConsumedType(OpOperand &use) {
+  if (auto kernel = dyn_cast<KernelOp>(use.getOwner()))
+    return getKernelFunc(kernel).getFunctionType().getInput(
+        use.getOperandNumber());
+  return getProducedType(use.get());
+}
+
+LogicalResult GraphConverter::verify() {
+  for (Operation &op : graph.getRegion().getOps()) {
+    if (isa<GraphInOutOp>(op))
+      return op.emitOpError("inout ports are not supported");
+
+    if (auto input = dyn_cast<GraphInputOp>(op)) {
+      auto interface = input.getValue();
+      if (interface.size() != 2 || !interface[0].isa<IntegerAttr>() ||
+          !interface[1].isa<IntegerAttr>())
+        return input.emitOpError(
+            "expected the interface to be [isStream, windowBytes]");
+      if (failed(verifyPortType(input, getProducedType(input.getOutput()))))
+        return failure();
+      producedValues.push_back(input.getOutput());
+    }
+
+    if (auto kernel = dyn_cast<KernelOp>(op)) {
+      func::FuncOp funcOp = getKernelFunc(kernel);
+      if (!funcOp)
+        return kernel.emitOpError("unknown kernel function ")
+               << kernel.getCalleeAttr();
+      // Kernel functions are retyped to take memrefs, which their body, if
+      // they had one, would still access as ADF ports.
+      if (!funcOp.isDeclaration())
+        return kernel.emitOpError("kernel function ")
+               << kernel.getCalleeAttr() << " must be a declaration";
+      FunctionType funcType = funcOp.getFunctionType();
+      if (funcType.getNumInputs() != kernel.getKernelInputs().size() ||
+          funcType.getNumResults() != 1)
+        return kernel.emitOpError("doesn't match the signature of ")
+               << kernel.getCalleeAttr();
+      for (Type type : funcType.getInputs())
+        if (failed(verifyPortType(funcOp, type)))
+          return failure();
+      if (failed(verifyPortType(funcOp, funcType.getResult(0))))
+        return failure();
+      if (kernel->use_empty())
+        return kernel.emitOpError("output is not connected");
+      kernels.push_back(kernel);
+      if (!llvm::is_contained(kernelFuncs, funcOp))
+        kernelFuncs.push_back(funcOp);
+      producedValues.push_back(kernel->getResult(0));
+    }
+  }
+
+  // Both ends of a connection must agree on how the data is transferred.
+  for (Value value : producedValues) {
+    Type producedType = getProducedType(value);
+    for (OpOperand &use : value.getUses())
+      if (getConsumedType(use) != producedType)
+        return use.getOwner()->emitOpError("expects ")
+               << getConsumedType(use) << " but operand "
+               << use.getOperandNumber() << " provides " << producedType;
+  }
+  return success();
+}
+
+LogicalResult
+GraphConverter::createTiles(OpBuilder &builder,
+                            const AIE::AIETargetModel &targetModel) {
+  SmallVector<AIE::TileID> shimTiles;
+  for (int col = 0; col < targetModel.columns(); ++col)
+    if (targetModel.isShimNOCTile(col, 0))
+      shimTiles.push_back({col, 0});
+  if (shimTiles.empty())
+    return graph.emitOpError("device has no shim NOC tile");
+
+  // Fill the core rows from the first shim NOC column, so that kernels start
+  // out close to the ports of the graph.
+  SmallVector<AIE::TileID> coreTiles;
+  for (int row = 0; row < targetModel.rows(); ++row)
+    for (int col = shimTiles.front().first; col < targetModel.columns(); ++col)
+      if (targetModel.isCoreTile(col, row))
+        coreTiles.push_back({col, row});
+
+  unsigned numShimTiles = 0;
+  unsigned numCoreTiles = 0;
+  for (Operation &op : graph.getRegion().getOps()) {
+    AIE::TileID id;
+    if (isa<GraphInputOp, GraphOutputOp>(op)) {
+      if (numShimTiles == shimTiles.size())
+        return op.emitOpError("exceeds the ")
+               << shimTiles.size() << " shim NOC tiles of the device";
+      id = shimTiles[numShimTiles++];
+    } else if (isa<KernelOp>(op)) {
+      if (numCoreTiles == coreTiles.size())
+        return op.emitOpError("exceeds the ")
+               << coreTiles.size() << " core tiles available to the graph";
+      id = coreTiles[numCoreTiles++];
+    } else {
+      continue;
+    }
+    tiles[&op] = builder.create<AIE::TileOp>(builder.getUnknownLoc(),
+                                             id.first, id.second);
+  }
+
+  // Each stream input of a kernel needs its own Core port.
+  for (KernelOp kernel : kernels) {
+    AIE::TileID id = tiles[kernel].getTileID();
+    int numStreams = llvm::count_if(
+        getKernelFunc(kernel).getFunctionType().getInputs(),
+        [](Type type) { return type.isa<StreamType>(); });
+    int numPorts = targetModel.getNumDestSwitchboxConnections(
+        id.first, id.second, AIE::WireBundle::Core);
+    if (numStreams > numPorts)
+      return kernel.emitOpError("has ")
+             << numStreams << " stream inputs but a core only has "
+             << numPorts;
+  }
+  return success();
+}
+
+void GraphConverter::createConnections(OpBuilder &builder) {
+  for (Value value : producedValues) {
+    Operation *producer = value.getDefiningOp();
+    AIE::TileOp producerTile = tiles[producer];
+
+    if (auto window = getProducedType(value).dyn_cast<WindowType>()) {
+      SmallVector<Value> consumerTiles;
+      for (OpOperand *use : getUsesInOrder(value)) {
+        Value tile = tiles[use->getOwner()];
+        if (!llvm::is_contained(consumerTiles, tile))
+          consumerTiles.push_back(tile);
+      }
+      auto fifo = builder.create<AIE::ObjectFifoCreateOp>(
+          builder.getUnknownLoc(),
+          AIE::AIEObjectFifoType::get(convertWindowType(window)),
+          producerTile, consumerTiles, windowDepth);
+      // Name the objectFifos after the graph inputs, and after the kernels as
+      // numbered by the C++ graph generator.
+      std::string name;
+      if (auto input = dyn_cast<GraphInputOp>(producer))
+        name = input.getName().str();
+      else
+        name = "k" +
+               std::to_string(llvm::find(kernels, cast<KernelOp>(producer)) -
+                              kernels.begin() + 1) +
+               "_out";
+      fifo->setAttr(SymbolTable::getSymbolAttrName(),
+                    builder.getStringAttr(name));
+      windowFifos[value] = fifo;
+      continue;
+    }
+
+    // Streams leave kernels through their first Core port, and enter kernels
+    // through the Core port numbered after the stream inputs before them.
+    StreamPort source = {producerTile, AIE::WireBundle::Core, 0};
+    if (isa<GraphInputOp>(producer))
+      source.bundle = AIE::WireBundle::DMA;
+    for (OpOperand *use : getUsesInOrder(value)) {
+      StreamPort dest = {tiles[use->getOwner()], AIE::WireBundle::DMA, 0};
+      if (auto kernel = dyn_cast<KernelOp>(use->getOwner())) {
+        auto inputs = getKernelFunc(kernel).getFunctionType().getInputs();
+        dest.bundle = AIE::WireBundle::Core;
+        dest.channel = llvm::count_if(
+            inputs.take_front(use->getOperandNumber()),
+            [](Type type) { return type.isa<StreamType>(); });
+      }
+      builder.create<AIE::FlowOp>(builder.getUnknownLoc(), source.tile,
+                                  source.bundle, source.channel, dest.tile,
+                                  dest.bundle, dest.channel);
+    }
+  }
+}
+
+void GraphConverter::createCore(OpBuilder &builder, KernelOp kernel) {
+  Location loc = kernel.getLoc();
+  auto coreOp = builder.create<AIE::CoreOp>(loc, builder.getIndexType(),
+                                            tiles[kernel]);
+  Region &r = coreOp.getBody();
+  r.push_back(new Block);
+  OpBuilder::InsertionGuard guard(builder);
+  builder.setInsertionPointToStart(&r.back());
+  builder.create<AIE::EndOp>(loc);
+  builder.setInsertionPointToStart(&r.back());
+
+  if (iterations > 1) {
+    Value lowerBound = builder.create<arith::ConstantIndexOp>(loc, 0);
+    Value upperBound = builder.create<arith::ConstantIndexOp>(loc, iterations);
+    Value step = builder.create<arith::ConstantIndexOp>(loc, 1);
+    auto forLoop =
+        builder.create<scf::ForOp>(loc, lowerBound, upperBound, step);
+    builder.setInsertionPointToStart(forLoop.getBody());
+  }
+
+  // Acquire one element of every window, in the order of the kernel
+  // arguments. A window used by several inputs is acquired only once.
+  SmallVector<std::pair<AIE::ObjectFifoCreateOp, AIE::ObjectFifoPort>>
+      acquired;
+  DenseMap<Operation *, Value> elements;
+  auto acquire = [&](Value window, AIE::ObjectFifoPort port) {
+    AIE::ObjectFifoCreateOp fifo = windowFifos[window];
+    auto it = elements.find(fifo);
+    if (it != elements.end())
+      return it->second;
+    auto fifoType = fifo.getFifo().getType().cast<AIE::AIEObjectFifoType>();
+    Type elementType = fifoType.getElementType();
+    auto portAttr = AIE::ObjectFifoPortAttr::get(builder.getContext(), port);
+    auto acquireOp = builder.create<AIE::ObjectFifoAcquireOp>(
+        loc, AIE::AIEObjectFifoSubviewType::get(elementType), portAttr, fifo,
+        builder.getI32IntegerAttr(1));
+    Value element = builder.create<AIE::ObjectFifoSubviewAccessOp>(
+        loc, elementType, acquireOp.getSubview(), builder.getI32IntegerAttr(0));
+    acquired.push_back({fifo, port});
+    elements[fifo] = element;
+    return element;
+  };
+
+  SmallVector<Value> operands;
+  for (Value input : kernel.getKernelInputs())
+    if (windowFifos.count(input))
+      operands.push_back(acquire(input, AIE::ObjectFifoPort::Consume));
+  if (windowFifos.count(kernel->getResult(0)))
+    operands.push_back(
+        acquire(kernel->getResult(0), AIE::ObjectFifoPort::Produce));
+
+  builder.create<func::CallOp>(loc, getKernelFunc(kernel), operands);
+
+  for (auto [fifo, port] : acquired)
+    builder.create<AIE::ObjectFifoReleaseOp>(
+        loc, AIE::ObjectFifoPortAttr::get(builder.getContext(), port), fifo,
+        builder.getI32IntegerAttr(1));
+}
+
+// Kernels take their windows as memrefs, inputs first. Streams are accessed
+// through the stream intrinsics in the kernel body and aren't arguments.
+void GraphConverter::convertKernelFunc(func::FuncOp funcOp) {
+  FunctionType funcType = funcOp.getFunctionType();
+  SmallVector<Type> inputs;
+  for (Type type : llvm::concat<const Type>(funcType.getInputs(),
+                                            funcType.getResults()))
+    if (auto window = type.dyn_cast<WindowType>())
+      inputs.push_back(convertWindowType(window));
+  funcOp.setType(FunctionType::get(funcOp.getContext(), inputs, {}));
+}
+
+LogicalResult GraphConverter::convert(AIE::AIEDevice deviceKind) {
+  if (failed(verify()))
+    return failure();
+
+  OpBuilder builder(graph);
+  auto device = builder.create<AIE::DeviceOp>(
+      graph.getLoc(),
+      AIE::AIEDeviceAttr::get(builder.getContext(), deviceKind));
+  device.getRegion().emplaceBlock();
+  builder.setInsertionPointToStart(&device.getRegion().front());
+
+  if (failed(createTiles(builder, device.getTargetModel()))) {
+    device.erase();
+    return failure();
+  }
+  createConnections(builder);
+
+  // The device is isolated from above, so the kernels it calls must be
+  // declared inside of it.
+  for (func::FuncOp funcOp : kernelFuncs) {
+    convertKernelFunc(funcOp);
+    funcOp->moveBefore(builder.getInsertionBlock(),
+                       builder.getInsertionPoint());
+  }
+
+  for (KernelOp kernel : kernels)
+    createCore(builder, kernel);
+
+  graph.erase();
+  return success();
+}
+
+struct ConvertADFToAIEPass : public ConvertADFToAIEBase<ConvertADFToAIEPass> {
+  void runOnOperation() override {
+    ModuleOp module = getOperation();
+    auto graphs = llvm::to_vector(module.getOps<GraphOp>());
+    if (graphs.empty())
+      return;
+    if (graphs.size() > 1) {
+      graphs[1].emitOpError("only one graph per module is supported");
+      return signalPassFailure();
+    }
+
+    auto deviceKind = AIE::symbolizeAIEDevice(device.getValue());
+    if (!deviceKind) {
+      module.emitError("unknown device ") << device.getValue();
+      return signalPassFailure();
+    }
+
+    GraphConverter converter(graphs.front(), iterations);
+    if (failed(converter.convert(*deviceKind)))
+      signalPassFailure();
+  }
+};
+
+std::unique_ptr<OperationPass<ModuleOp>>
+xilinx::ADF::createConvertADFToAIEPass() {
+  return std::make_unique<ConvertADFToAIEPass>();
+}
@@ -12,6 +12,7 @@
 #include "mlir/Conversion/LLVMCommon/ConversionTarget.h"
 #include "mlir/Conversion/LLVMCommon/Pattern.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
 #include "mlir/IR/TypeUtilities.h"
 
 #include "aie/Conversion/AIEVecToLLVM/AIEVecToLLVM.h"
@@ -43,7 +44,12 @@ std::string getVectorTypeString(VectorType type, bool abbrev = false,
   if (auto intType = type.getElementType().dyn_cast<IntegerType>()) {
     ss << (acc ? "acc" : abbrev ? "i" : "int") << intType.getWidth();
   } else if (auto floatType = type.getElementType().dyn_cast<FloatType>()) {
-    ss << (abbrev ? "f" : "float");
+    if (acc)
+      ss << "accfloat";
+    else if (floatType.isBF16())
+      ss << (abbrev ? "bf16" : "bfloat16");
+    else
+      ss << (abbrev ? "f" : "float");
   }
   return ss.str();
 }
@@ -96,6 +102,45 @@ void encodeConf(uint32_t conf[2], const BufferParams &x, const BufferParams &z,
   conf[1] |= sub << 17;
 }
 
+// Returns the declaration of the intrinsic `intrinsicName`, inserting it at
+// the start of `module` with type `funcType` if it doesn't exist yet.
+LLVM::LLVMFuncOp getOrInsertIntrinsic(ConversionPatternRewriter &rewriter,
+                                      ModuleOp module,
+                                      StringRef intrinsicName,
+                                      LLVM::LLVMFunctionType funcType) {
+  auto func = module.lookupSymbol<LLVM::LLVMFuncOp>(
+      StringAttr::get(rewriter.getContext(), intrinsicName));
+  if (!func) {
+    OpBuilder::InsertionGuard guard(rewriter);
+    rewriter.setInsertionPointToStart(module.getBody());
+    func = rewriter.create<LLVM::LLVMFuncOp>(rewriter.getUnknownLoc(),
+                                             intrinsicName, funcType);
+  }
+  return func;
+}
+
+// Replaces `op` with a call to the intrinsic `intrinsicName` on `operands`.
+// The intrinsic returns the LLVM equivalent of the result type of `op`.
+void replaceOpWithIntrinsicCall(ConversionPatternRewriter &rewriter,
+                                LLVMTypeConverter &typeConverter,
+                                Operation *op, StringRef intrinsicName,
+                                ValueRange operands) {
+  auto module = op->getParentOfType<ModuleOp>();
+  Type resultType = typeConverter.convertType(op->getResult(0).getType());
+  SmallVector<Type> operandTypes(operands.getTypes());
+  auto func = getOrInsertIntrinsic(
+      rewriter, module, intrinsicName,
+      LLVM::LLVMFunctionType::get(resultType, operandTypes));
+  rewriter.replaceOpWithNewOp<LLVM::CallOp>(op, func, operands);
+}
+
+// Creates an i32 constant for an immediate operand of an intrinsic.
+Value createI32Constant(ConversionPatternRewriter &rewriter, Location loc,
+                        int32_t value) {
+  return rewriter.create<LLVM::ConstantOp>(loc, rewriter.getI32Type(),
+                                           rewriter.getI32IntegerAttr(value));
+}
+
 class AddOpConversion
     : public mlir::ConvertOpToLLVMPattern<xilinx::aievec::AddOp> {
 public:
@@ -283,11 +328,23 @@ class UPSOpConversion
 public:
   using ConvertOpToLLVMPattern<xilinx::aievec::UPSOp>::ConvertOpToLLVMPattern;
 
+  static std::string getIntrinsicName(xilinx::aievec::UPSOp op) {
+    auto sourceType = op.getSource().getType().cast<VectorType>();
+    auto resultType = op.getResult().getType().cast<VectorType>();
+    std::stringstream ss;
+    ss << "llvm.aie.ups." << getVectorTypeString(resultType, false, true)
+       << "." << getVectorTypeString(sourceType, true);
+    return ss.str();
+  }
+
   LogicalResult
   matchAndRewrite(xilinx::aievec::UPSOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
-    op.emitWarning() << "aie.ups conversion is not implemented\n";
-    return failure();
+    auto shiftVal = createI32Constant(rewriter, op->getLoc(), op.getShift());
+    replaceOpWithIntrinsicCall(rewriter, *getTypeConverter(), op,
+                               getIntrinsicName(op),
+                               {adaptor.getSource(), shiftVal});
+    return success();
   }
 };
 
@@ -378,11 +435,25 @@ public:
     int vecSizeInBits =
         getVectorSizeInBits(op.getResult().getType().cast<VectorType>());
 
-    auto ptr = this->getStridedElementPtr(
+    Value ptr = this->getStridedElementPtr(
         op->getLoc(), op.getSource().getType().cast<MemRefType>(),
         adaptor.getSource(), adaptor.getIndices(), rewriter);
 
-    // TODO: handle the offset field
+    // The offset is given in bits, and it must be a multiple of the element
+    // size for the access to be addressable.
+    if (op.getOffset() != 0) {
+      int32_t elementSizeInBits =
+          getElementSizeInBits(op.getResult().getType().cast<VectorType>());
+      if (op.getOffset() % elementSizeInBits)
+        return rewriter.notifyMatchFailure(
+            op, "offset is not a multiple of the element size");
+      auto offsetVal = rewriter.create<LLVM::ConstantOp>(
+          op->getLoc(), getIndexType(),
+          rewriter.getIntegerAttr(getIndexType(),
+                                  op.getOffset() / elementSizeInBits));
+      ptr = rewriter.create<LLVM::GEPOp>(op->getLoc(), ptr.getType(), ptr,
+                                         ValueRange{offsetVal});
+    }
 
     if (vecSizeInBits <= 256) {
       // Total <=256-bit updates are much simpler:
@@ -703,6 +774,328 @@ public:
   }
 };
 
+// Converts the AIE-ML lane-wise binary ops (add_elem, sub_elem, min, max) to
+// calls to the `llvm.aie2.<name>.<type>` intrinsics.
+template <typename SrcOpTy>
+class BinaryElemOpConversion : public mlir::ConvertOpToLLVMPattern<SrcOpTy> {
+public:
+  using OpAdaptor = typename SrcOpTy::Adaptor;
+
+  BinaryElemOpConversion(LLVMTypeConverter &converter, StringRef name)
+      : ConvertOpToLLVMPattern<SrcOpTy>(converter), name(name) {}
+
+  LogicalResult
+  matchAndRewrite(SrcOpTy op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto resultType = op.getResult().getType().template cast<VectorType>();
+    std::stringstream ss;
+    ss << "llvm.aie2." << name << "." << getVectorTypeString(resultType);
+    replaceOpWithIntrinsicCall(rewriter, *this->getTypeConverter(), op,
+                               ss.str(), {adaptor.getLhs(), adaptor.getRhs()});
+    return success();
+  }
+
+private:
+  std::string name;
+};
+
+class MulElemOpConversion
+    : public mlir::ConvertOpToLLVMPattern<xilinx::aievec::MulElemOp> {
+public:
+  using ConvertOpToLLVMPattern<
+      xilinx::aievec::MulElemOp>::ConvertOpToLLVMPattern;
+
+  static std::string getIntrinsicName(xilinx::aievec::MulElemOp op) {
+    auto lhsType = op.getLhs().getType().cast<VectorType>();
+    auto resultType = op.getResult().getType().cast<VectorType>();
+    std::stringstream ss;
+    ss << "llvm.aie2.mul.elem." << getVectorTypeString(lhsType, true) << "."
+       << getVectorTypeString(resultType, false, true);
+    return ss.str();
+  }
+
+  LogicalResult
+  matchAndRewrite(xilinx::aievec::MulElemOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    replaceOpWithIntrinsicCall(rewriter, *getTypeConverter(), op,
+                               getIntrinsicName(op),
+                               {adaptor.getLhs(), adaptor.getRhs()});
+    return success();
+  }
+};
+
+class FMAElemOpConversion
+    : public mlir::ConvertOpToLLVMPattern<xilinx::aievec::FMAElemOp> {
+public:
+  using ConvertOpToLLVMPattern<
+      xilinx::aievec::FMAElemOp>::ConvertOpToLLVMPattern;
+
+  static std::string getIntrinsicName(xilinx::aievec::FMAElemOp op) {
+    auto lhsType = op.getLhs().getType().cast<VectorType>();
+    auto resultType = op.getResult().getType().cast<VectorType>();
+    std::stringstream ss;
+    ss << "llvm.aie2." << (op.getFmsub() ? "msc" : "mac") << ".elem."
+       << getVectorTypeString(lhsType, true) << "."
+       << getVectorTypeString(resultType, false, true);
+    return ss.str();
+  }
+
+  LogicalResult
+  matchAndRewrite(xilinx::aievec::FMAElemOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    replaceOpWithIntrinsicCall(
+        rewriter, *getTypeConverter(), op, getIntrinsicName(op),
+        {adaptor.getLhs(), adaptor.getRhs(), adaptor.getAcc()});
+    return success();
+  }
+};
+
+class MulConvOpConversion
+    : public mlir::ConvertOpToLLVMPattern<xilinx::aievec::MulConvOp> {
+public:
+  using ConvertOpToLLVMPattern<
+      xilinx::aievec::MulConvOp>::ConvertOpToLLVMPattern;
+
+  static std::string getIntrinsicName(xilinx::aievec::MulConvOp op) {
+    auto lhsType = op.getLhs().getType().cast<VectorType>();
+    std::stringstream ss;
+    ss << "llvm.aie2.mul.conv." << op.getM() << "x" << op.getN() << "."
+       << getVectorTypeString(lhsType, true);
+    return ss.str();
+  }
+
+  LogicalResult
+  matchAndRewrite(xilinx::aievec::MulConvOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    replaceOpWithIntrinsicCall(rewriter, *getTypeConverter(), op,
+                               getIntrinsicName(op),
+                               {adaptor.getLhs(), adaptor.getRhs()});
+    return success();
+  }
+};
+
+class FMAConvOpConversion
+    : public mlir::ConvertOpToLLVMPattern<xilinx::aievec::FMAConvOp> {
+public:
+  using ConvertOpToLLVMPattern<
+      xilinx::aievec::FMAConvOp>::ConvertOpToLLVMPattern;
+
+  static std::string getIntrinsicName(xilinx::aievec::FMAConvOp op) {
+    auto lhsType = op.getLhs().getType().cast<VectorType>();
+    std::stringstream ss;
+    ss << "llvm.aie2." << (op.getFmsub() ? "msc" : "mac") << ".conv."
+       << op.getM() << "x" << op.getN() << "."
+       << getVectorTypeString(lhsType, true);
+    return ss.str();
+  }
+
+  LogicalResult
+  matchAndRewrite(xilinx::aievec::FMAConvOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    replaceOpWithIntrinsicCall(
+        rewriter, *getTypeConverter(), op, getIntrinsicName(op),
+        {adaptor.getLhs(), adaptor.getRhs(), adaptor.getAcc()});
+    return success();
+  }
+};
+
+class CmpOpConversion
+    : public mlir::ConvertOpToLLVMPattern<xilinx::aievec::CmpOp> {
+public:
+  using ConvertOpToLLVMPattern<xilinx::aievec::CmpOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(xilinx::aievec::CmpOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    static constexpr StringLiteral predicates[] = {
+        "eq", "ne", "slt", "ult", "sle", "ule", "sgt", "ugt", "sge", "uge"};
+    StringRef pred = op.getPred();
+    if (!llvm::is_contained(predicates, pred))
+      return rewriter.notifyMatchFailure(op, "unknown comparison predicate");
+
+    // The result is a mask with one bit per lane
+    auto lhsType = op.getLhs().getType().cast<VectorType>();
+    std::stringstream ss;
+    ss << "llvm.aie2.cmp." << pred.str() << "."
+       << getVectorTypeString(lhsType);
+    replaceOpWithIntrinsicCall(rewriter, *getTypeConverter(), op, ss.str(),
+                               {adaptor.getLhs(), adaptor.getRhs()});
+    return success();
+  }
+};
+
+class SelOpConversion
+    : public mlir::ConvertOpToLLVMPattern<xilinx::aievec::SelOp> {
+public:
+  using ConvertOpToLLVMPattern<xilinx::aievec::SelOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(xilinx::aievec::SelOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto resultType = op.getResult().getType().cast<VectorType>();
+    std::stringstream ss;
+    ss << "llvm.aie2.sel." << getVectorTypeString(resultType);
+    replaceOpWithIntrinsicCall(
+        rewriter, *getTypeConverter(), op, ss.str(),
+        {adaptor.getLhs(), adaptor.getRhs(), adaptor.getSel()});
+    return success();
+  }
+};
+
+class ShiftOpConversion
+    : public mlir::ConvertOpToLLVMPattern<xilinx::aievec::ShiftOp> {
+public:
+  using ConvertOpToLLVMPattern<
+      xilinx::aievec::ShiftOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(xilinx::aievec::ShiftOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto resultType = op.getResult().getType().cast<VectorType>();
+    std::stringstream ss;
+    ss << "llvm.aie2.shift."
+       << getVectorTypeString(resultType, false, op.getIsAcc());
+    replaceOpWithIntrinsicCall(
+        rewriter, *getTypeConverter(), op, ss.str(),
+        {adaptor.getLhs(), adaptor.getRhs(), adaptor.getShift()});
+    return success();
+  }
+};
+
+class ShuffleOpConversion
+    : public mlir::ConvertOpToLLVMPattern<xilinx::aievec::ShuffleOp> {
+public:
+  using ConvertOpToLLVMPattern<
+      xilinx::aievec::ShuffleOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(xilinx::aievec::ShuffleOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto resultType = op.getResult().getType().cast<VectorType>();
+    std::stringstream ss;
+    ss << "llvm.aie2.shuffle." << getVectorTypeString(resultType);
+    auto modeVal = createI32Constant(rewriter, op->getLoc(), op.getMode());
+    replaceOpWithIntrinsicCall(rewriter, *getTypeConverter(), op, ss.str(),
+                               {adaptor.getSource(), modeVal});
+    return success();
+  }
+};
+
+class BroadcastOpConversion
+    : public mlir::ConvertOpToLLVMPattern<xilinx::aievec::BroadcastOp> {
+public:
+  using ConvertOpToLLVMPattern<
+      xilinx::aievec::BroadcastOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(xilinx::aievec::BroadcastOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto resultType = op.getResult().getType().cast<VectorType>();
+    std::stringstream ss;
+    ss << "llvm.aie2.broadcast." << getVectorTypeString(resultType);
+    auto idxVal = createI32Constant(rewriter, op->getLoc(), op.getIdx());
+    replaceOpWithIntrinsicCall(rewriter, *getTypeConverter(), op, ss.str(),
+                               {adaptor.getSource(), idxVal});
+    return success();
+  }
+};
+
+class BroadcastScalarOpConversion
+    : public mlir::ConvertOpToLLVMPattern<xilinx::aievec::BroadcastScalarOp> {
+public:
+  using ConvertOpToLLVMPattern<
+      xilinx::aievec::BroadcastScalarOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(xilinx::aievec::BroadcastScalarOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto resultType = op.getResult().getType().cast<VectorType>();
+    std::stringstream ss;
+    ss << "llvm.aie2.broadcast.scalar." << getVectorTypeString(resultType);
+    replaceOpWithIntrinsicCall(rewriter, *getTypeConverter(), op, ss.str(),
+                               {adaptor.getSource()});
+    return success();
+  }
+};
+
+class ExtElemOpConversion
+    : public mlir::ConvertOpToLLVMPattern<xilinx::aievec::ExtElemOp> {
+public:
+  using ConvertOpToLLVMPattern<
+      xilinx::aievec::ExtElemOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(xilinx::aievec::ExtElemOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto sourceType = op.getSource().getType().cast<VectorType>();
+    std::stringstream ss;
+    ss << "llvm.aie2.ext.elem." << getVectorTypeString(sourceType);
+    replaceOpWithIntrinsicCall(rewriter, *getTypeConverter(), op, ss.str(),
+                               {adaptor.getSource(), adaptor.getIndex()});
+    return success();
+  }
+};
+
+class MatMulOpConversion
+    : public mlir::ConvertOpToLLVMPattern<xilinx::aievec::MatMulOp> {
+public:
+  using ConvertOpToLLVMPattern<
+      xilinx::aievec::MatMulOp>::ConvertOpToLLVMPattern;
+
+  static std::string getIntrinsicName(xilinx::aievec::MatMulOp op) {
+    auto lhsType = op.getLhs().getType().cast<VectorType>();
+    auto rhsType = op.getRhs().getType().cast<VectorType>();
+    int64_t M = lhsType.getDimSize(0);
+    int64_t K = lhsType.getDimSize(1);
+    int64_t N = rhsType.getDimSize(1);
+    auto flatLhsType =
+        VectorType::get({lhsType.getNumElements()}, lhsType.getElementType());
+    std::stringstream ss;
+    ss << "llvm.aie2.mac." << M << "x" << K << "." << K << "x" << N << "."
+       << getVectorTypeString(flatLhsType);
+    return ss.str();
+  }
+
+  LogicalResult
+  matchAndRewrite(xilinx::aievec::MatMulOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto module = op->getParentOfType<ModuleOp>();
+    MLIRContext *context = rewriter.getContext();
+
+    // The intrinsics work on flat vectors, so the matrices are flattened
+    // before the call and the result is reshaped after it.
+    auto flatten = [&](Value v) -> Value {
+      auto vecType = v.getType().cast<VectorType>();
+      auto flatType =
+          VectorType::get({vecType.getNumElements()}, vecType.getElementType());
+      return rewriter.create<vector::ShapeCastOp>(op->getLoc(), flatType, v);
+    };
+    Value lhs = flatten(op.getLhs());
+    Value rhs = flatten(op.getRhs());
+    Value acc = flatten(op.getAcc());
+
+    // If the intrinsic declaration doesn't exist, create it
+    std::string intrinsicName = getIntrinsicName(op);
+    auto func = module.lookupSymbol<LLVM::LLVMFuncOp>(
+        StringAttr::get(context, intrinsicName));
+
+    if (!func) {
+      OpBuilder::InsertionGuard guard(rewriter);
+      rewriter.setInsertionPointToStart(module.getBody());
+      func = rewriter.create<LLVM::LLVMFuncOp>(
+          rewriter.getUnknownLoc(), intrinsicName,
+          LLVM::LLVMFunctionType::get(
+              acc.getType(), {lhs.getType(), rhs.getType(), acc.getType()}));
+    }
+
+    auto callOp = rewriter.create<LLVM::CallOp>(op->getLoc(), func,
+                                                ValueRange{lhs, rhs, acc});
+    rewriter.replaceOpWithNewOp<vector::ShapeCastOp>(op, op.getType(),
+                                                     callOp->getResult(0));
+    return success();
+  }
+};
+
 void populateAIEVecToLLVMConversionPatterns(mlir::LLVMTypeConverter &converter,
                                             mlir::RewritePatternSet &patterns) {
   patterns.add<xilinx::aievec::AddOpConversion>(converter);
@@ -717,6 +1110,26 @@ void populateAIEVecToLLVMConversionPatterns(mlir::LLVMTypeConverter &converter,
   patterns.add<xilinx::aievec::SelectOpConversion>(converter);
   patterns.add<xilinx::aievec::PackOpConversion>(converter);
   patterns.add<xilinx::aievec::UnpackOpConversion>(converter);
+  patterns.add<xilinx::aievec::MatMulOpConversion>(converter);
+  patterns.add<xilinx::aievec::BinaryElemOpConversion<aievec::AddElemOp>>(
+      converter, "add");
+  patterns.add<xilinx::aievec::BinaryElemOpConversion<aievec::SubElemOp>>(
+      converter, "sub");
+  patterns.add<xilinx::aievec::BinaryElemOpConversion<aievec::MinOp>>(
+      converter, "min");
+  patterns.add<xilinx::aievec::BinaryElemOpConversion<aievec::MaxOp>>(
+      converter, "max");
+  patterns.add<xilinx::aievec::MulElemOpConversion>(converter);
+  patterns.add<xilinx::aievec::FMAElemOpConversion>(converter);
+  patterns.add<xilinx::aievec::MulConvOpConversion>(converter);
+  patterns.add<xilinx::aievec::FMAConvOpConversion>(converter);
+  patterns.add<xilinx::aievec::CmpOpConversion>(converter);
+  patterns.add<xilinx::aievec::SelOpConversion>(converter);
+  patterns.add<xilinx::aievec::ShiftOpConversion>(converter);
+  patterns.add<xilinx::aievec::ShuffleOpConversion>(converter);
+  patterns.add<xilinx::aievec::BroadcastOpConversion>(converter);
+  patterns.add<xilinx::aievec::BroadcastScalarOpConversion>(converter);
+  patterns.add<xilinx::aievec::ExtElemOpConversion>(converter);
 }
 
 struct ConvertAIEVecToLLVMPass
@@ -16,6 +16,10 @@
 #include "mlir/Pass/Pass.h"
 
 namespace xilinx {
+namespace AIE {
+class AIEDialect;
+} // namespace AIE
+
 namespace aievec {
 class AIEVecDialect;
 } // namespace aievec
@@ -23,10 +27,26 @@ class AIEVecDialect;
 
 namespace mlir {
 
+namespace arith {
+class ArithDialect;
+} // namespace arith
+
+namespace func {
+class FuncDialect;
+} // namespace func
+
 namespace LLVM {
 class LLVMDialect;
 } // namespace LLVM
 
+namespace scf {
+class SCFDialect;
+} // namespace scf
+
+namespace vector {
+class VectorDialect;
+} // namespace vector
+
 #define GEN_PASS_CLASSES
 #include "aie/Conversion/Passes.h.inc"
 } // namespace mlir
@@ -11,6 +11,7 @@
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/IR/DialectImplementation.h"
+#include "mlir/IR/Matchers.h"
 #include "mlir/IR/OpDefinition.h"
 #include "mlir/Interfaces/FoldInterfaces.h"
 #include "mlir/Transforms/InliningUtils.h"
@@ -810,6 +811,31 @@ LogicalResult xilinx::AIE::CoreOp::verify() {
     return emitOpError("CoreOp cannot be created on shim tile, i.e. row == 0");
   if (getTileOp().isMemTile())
     return emitOpError("CoreOp cannot be created on mem tile");
+
+  if (auto attr = (*this)->getAttr("compile_options")) {
+    static const StringRef knownOptions[] = {"opt_level", "inline_threshold",
+                                             "unroll_threshold",
+                                             "vector_width", "interleave"};
+    auto options = attr.dyn_cast<DictionaryAttr>();
+    if (!options)
+      return emitOpError("compile_options must be a dictionary");
+    for (NamedAttribute option : options) {
+      StringRef name = option.getName().getValue();
+      if (!llvm::is_contained(knownOptions, name))
+        return emitOpError("unknown compile option '") << name << "'";
+      auto value = option.getValue().dyn_cast<IntegerAttr>();
+      if (!value)
+        return emitOpError("compile option '")
+               << name << "' must be an integer";
+      int64_t minValue =
+          (name == "vector_width" || name == "interleave") ? 1 : 0;
+      int64_t maxValue = name == "opt_level" ? 3 : INT32_MAX;
+      if (value.getInt() < minValue || value.getInt() > maxValue)
+        return emitOpError("compile option '")
+               << name << "' must be between " << minValue << " and "
+               << maxValue;
+    }
+  }
   return success();
 }
 
@@ -820,6 +846,39 @@ xilinx::AIE::TileOp xilinx::AIE::CoreOp::getTileOp() {
   return cast<xilinx::AIE::TileOp>(getTile().getDefiningOp());
 }
 
+// GetStreamBurstOp and PutStreamBurstOp
+static LogicalResult verifyStreamBurst(Operation *op, Value buffer,
+                                       Value offset, uint32_t length) {
+  if (!op->getParentOfType<xilinx::AIE::CoreOp>())
+    return op->emitOpError("must be called from inside a CoreOp");
+  auto type = buffer.getType().cast<MemRefType>();
+  Type elementType = type.getElementType();
+  if (type.getRank() != 1 ||
+      !(elementType.isInteger(32) || elementType.isF32()))
+    return op->emitOpError("expected a 1-D memref of i32 or f32");
+  // The wide stream accesses are aligned by moving the elements before the
+  // first 128-bit boundary one at a time, which needs a known offset.
+  APInt offsetValue;
+  if (!matchPattern(offset, m_ConstantInt(&offsetValue)))
+    return op->emitOpError("expected a constant offset");
+  int64_t begin = offsetValue.getSExtValue();
+  if (begin < 0)
+    return op->emitOpError("expected a non-negative offset");
+  if (type.hasStaticShape() && begin + length > type.getNumElements())
+    return op->emitOpError("transfers elements [")
+           << begin << ", " << begin + length << ") of a memref of "
+           << type.getNumElements();
+  return success();
+}
+
+LogicalResult xilinx::AIE::GetStreamBurstOp::verify() {
+  return verifyStreamBurst(*this, getBuffer(), getOffset(), getLength());
+}
+
+LogicalResult xilinx::AIE::PutStreamBurstOp::verify() {
+  return verifyStreamBurst(*this, getBuffer(), getOffset(), getLength());
+}
+
 // BufferOp
 int64_t xilinx::AIE::BufferOp::getAllocationSize() {
   MemRefType type = getType().cast<MemRefType>();
@@ -128,6 +128,13 @@ bool AIE1TargetModel::isLegalMemAffinity(int coreCol, int coreRow, int memCol,
 
   return IsMemSouth || IsMemNorth || IsMemWest || IsMemEast;
 }
+
+bool AIE1TargetModel::isLegalCascade(int srcCol, int srcRow, int dstCol,
+                                     int dstRow) const {
+  // Cascades run left-to-right on odd rows and right-to-left on even rows.
+  int direction = (srcRow % 2) ? 1 : -1;
+  return (srcRow == dstRow) && (dstCol == srcCol + direction);
+}
 uint32_t
 AIE1TargetModel::getNumDestSwitchboxConnections(int col, int row,
                                                 WireBundle bundle) const {
@@ -374,6 +381,16 @@ bool AIE2TargetModel::isLegalMemAffinity(int coreCol, int coreRow, int memCol,
     return (IsMemSouth && !isMemTile(memCol, memRow)) || IsMemNorth ||
            IsMemWest || IsMemEast;
 }
+
+bool AIE2TargetModel::isLegalCascade(int srcCol, int srcRow, int dstCol,
+                                     int dstRow) const {
+  // The cascade output of a core goes either to the core east of it or to the
+  // core south of it.
+  if (!isCoreTile(srcCol, srcRow) || !isCoreTile(dstCol, dstRow))
+    return false;
+  return ((srcRow == dstRow) && (dstCol == srcCol + 1)) ||
+         ((srcCol == dstCol) && (dstRow == srcRow - 1));
+}
 uint32_t
 AIE2TargetModel::getNumDestSwitchboxConnections(int col, int row,
                                                 WireBundle bundle) const {
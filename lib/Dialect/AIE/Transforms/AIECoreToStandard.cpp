@@ -16,9 +16,11 @@
 #include "mlir/Dialect/ControlFlow/IR/ControlFlow.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Dialect/Math/IR/Math.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Dialect/Vector/IR/VectorOps.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/IRMapping.h"
+#include "mlir/IR/Matchers.h"
 #include "mlir/IR/Location.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Pass/Pass.h"
@@ -140,6 +142,166 @@ struct AIEGetStreamToStdLowering : public OpConversionPattern<GetStreamOp> {
   }
 };
 
+// Number of 32-bit elements in a wide stream word.
+static const int64_t wideStreamLanes = 4;
+// Number of wide stream words moved by each iteration of a stream burst loop.
+static const int64_t streamBurstUnroll = 4;
+
+static Value addIndex(OpBuilder &builder, Location loc, Value base,
+                      int64_t offset) {
+  if (offset == 0)
+    return base;
+  Value offsetValue = builder.create<arith::ConstantIndexOp>(loc, offset);
+  return builder.create<arith::AddIOp>(loc, base, offsetValue);
+}
+
+// Move the elements [offset, offset + length) of a stream burst, calling wide
+// for the first element of each wide word, and scalar for each of the
+// remaining elements. The elements before the first wide word boundary are
+// moved one at a time, so that the wide words are aligned in the memref. Long
+// bursts move their wide words in a loop unrolled streamBurstUnroll times, so
+// that a stream access can be issued every cycle.
+static void
+createStreamBurst(OpBuilder &builder, Location loc, int64_t offset,
+                  int64_t length, function_ref<void(Value)> wide,
+                  function_ref<void(Value)> scalar) {
+  auto createIndex = [&](int64_t index) -> Value {
+    return builder.create<arith::ConstantIndexOp>(loc, index);
+  };
+  int64_t end = offset + length;
+  int64_t begin =
+      std::min<int64_t>(llvm::alignTo(offset, wideStreamLanes), end);
+  for (int64_t i = offset; i < begin; ++i)
+    scalar(createIndex(i));
+
+  int64_t numWords = (end - begin) / wideStreamLanes;
+  int64_t loopWords = 0;
+  if (numWords >= 2 * streamBurstUnroll) {
+    OpBuilder::InsertionGuard guard(builder);
+    loopWords = numWords - numWords % streamBurstUnroll;
+    Value lowerBound = createIndex(begin);
+    Value upperBound = createIndex(begin + loopWords * wideStreamLanes);
+    Value step = createIndex(streamBurstUnroll * wideStreamLanes);
+    auto forLoop =
+        builder.create<scf::ForOp>(loc, lowerBound, upperBound, step);
+    builder.setInsertionPointToStart(forLoop.getBody());
+    Value base = forLoop.getInductionVar();
+    for (int64_t i = 0; i < streamBurstUnroll; ++i)
+      wide(addIndex(builder, loc, base, i * wideStreamLanes));
+  }
+  for (int64_t i = loopWords; i < numWords; ++i)
+    wide(createIndex(begin + i * wideStreamLanes));
+  for (int64_t i = begin + numWords * wideStreamLanes; i < end; ++i)
+    scalar(createIndex(i));
+}
+
+// The verifier of the stream bursts ensures that their offset is a constant.
+static int64_t getStreamBurstOffset(Value offset) {
+  APInt offsetValue;
+  bool isConstant = matchPattern(offset, m_ConstantInt(&offsetValue));
+  assert(isConstant && "expected a constant stream burst offset");
+  (void)isConstant;
+  return offsetValue.getSExtValue();
+}
+
+struct AIEPutStreamBurstToStdLowering
+    : public OpConversionPattern<PutStreamBurstOp> {
+  using OpConversionPattern<PutStreamBurstOp>::OpConversionPattern;
+  ModuleOp &module;
+
+  AIEPutStreamBurstToStdLowering(MLIRContext *context, ModuleOp &m,
+                                 PatternBenefit benefit = 1)
+      : OpConversionPattern<PutStreamBurstOp>(context, benefit), module(m) {}
+
+  LogicalResult
+  matchAndRewrite(PutStreamBurstOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Type elementType =
+        op.getBuffer().getType().cast<MemRefType>().getElementType();
+    auto putWMSFunc = module.lookupSymbol<func::FuncOp>("llvm.aie.put.wms");
+    auto putMSFunc = module.lookupSymbol<func::FuncOp>(
+        elementType.isF32() ? "llvm.aie.put.fms" : "llvm.aie.put.ms");
+    if (!putWMSFunc || !putMSFunc)
+      return module.emitOpError("Could not find the intrinsic function!");
+
+    Location loc = op.getLoc();
+    Value channel = adaptor.getChannel();
+    Value buffer = adaptor.getBuffer();
+    auto vectorType = VectorType::get({wideStreamLanes}, elementType);
+    auto wordType = VectorType::get({1}, rewriter.getIntegerType(128));
+    createStreamBurst(
+        rewriter, loc, getStreamBurstOffset(op.getOffset()), op.getLength(),
+        [&](Value index) {
+          Value padding = rewriter.create<arith::ConstantOp>(
+              loc, rewriter.getZeroAttr(elementType));
+          Value data = rewriter.create<vector::TransferReadOp>(
+              loc, vectorType, buffer, ValueRange{index}, padding);
+          Value words =
+              rewriter.create<vector::BitCastOp>(loc, wordType, data);
+          Value word = rewriter.create<vector::ExtractOp>(
+              loc, words, ArrayRef<int64_t>{0});
+          rewriter.create<func::CallOp>(loc, putWMSFunc,
+                                        ValueRange{channel, word});
+        },
+        [&](Value index) {
+          Value element =
+              rewriter.create<memref::LoadOp>(loc, buffer, ValueRange{index});
+          rewriter.create<func::CallOp>(loc, putMSFunc,
+                                        ValueRange{channel, element});
+        });
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
+struct AIEGetStreamBurstToStdLowering
+    : public OpConversionPattern<GetStreamBurstOp> {
+  using OpConversionPattern<GetStreamBurstOp>::OpConversionPattern;
+  ModuleOp &module;
+
+  AIEGetStreamBurstToStdLowering(MLIRContext *context, ModuleOp &m,
+                                 PatternBenefit benefit = 1)
+      : OpConversionPattern<GetStreamBurstOp>(context, benefit), module(m) {}
+
+  LogicalResult
+  matchAndRewrite(GetStreamBurstOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Type elementType =
+        op.getBuffer().getType().cast<MemRefType>().getElementType();
+    auto getWSSFunc = module.lookupSymbol<func::FuncOp>("llvm.aie.get.wss");
+    auto getSSFunc = module.lookupSymbol<func::FuncOp>(
+        elementType.isF32() ? "llvm.aie.get.fss" : "llvm.aie.get.ss");
+    if (!getWSSFunc || !getSSFunc)
+      return module.emitOpError("Could not find the intrinsic function!");
+
+    Location loc = op.getLoc();
+    Value channel = adaptor.getChannel();
+    Value buffer = adaptor.getBuffer();
+    auto vectorType = VectorType::get({wideStreamLanes}, elementType);
+    auto wordType = VectorType::get({1}, rewriter.getIntegerType(128));
+    createStreamBurst(
+        rewriter, loc, getStreamBurstOffset(op.getOffset()), op.getLength(),
+        [&](Value index) {
+          auto getWSSCall =
+              rewriter.create<func::CallOp>(loc, getWSSFunc, channel);
+          Value words = rewriter.create<vector::BroadcastOp>(
+              loc, wordType, getWSSCall.getResult(0));
+          Value data =
+              rewriter.create<vector::BitCastOp>(loc, vectorType, words);
+          rewriter.create<vector::TransferWriteOp>(loc, data, buffer,
+                                                   ValueRange{index});
+        },
+        [&](Value index) {
+          auto getSSCall =
+              rewriter.create<func::CallOp>(loc, getSSFunc, channel);
+          rewriter.create<memref::StoreOp>(loc, getSSCall.getResult(0), buffer,
+                                           ValueRange{index});
+        });
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
 struct AIEPutCascadeToStdLowering : public OpConversionPattern<PutCascadeOp> {
   using OpConversionPattern<PutCascadeOp>::OpConversionPattern;
   ModuleOp &module;
@@ -475,6 +637,7 @@ struct AIECoreToStandardPass
 
     RewritePatternSet patterns(&getContext());
     patterns.add<AIEPutStreamToStdLowering, AIEGetStreamToStdLowering,
+                 AIEPutStreamBurstToStdLowering, AIEGetStreamBurstToStdLowering,
                  AIEPutCascadeToStdLowering, AIEGetCascadeToStdLowering,
                  AIEDebugOpToStdLowering, AIEUseLockToStdLowering>(
         m.getContext(), m);
@@ -0,0 +1,335 @@
+//===- AIEObjectFifoCascade.cpp ---------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass moves objectFifos between cascade neighbours onto the cascade
+// stream. It targets reductions split across a chain of cores, where each core
+// adds its partial result to the one of its predecessor and passes it on: the
+// partial accumulators then travel over the cascade, instead of through a
+// shared buffer guarded by locks, or through two DMAs and a stream connection.
+//
+// The accumulators don't stay in registers: each side keeps the objectFifo
+// element in a local AIE.buffer. When the producer releases the element, it
+// vector.transfer_reads the buffer one cascade word at a time and puts each
+// word on the cascade. When the consumer acquires the element, it gets the
+// words from the cascade and vector.transfer_writes them to its buffer. The
+// cascade doesn't buffer a whole element, so the producer blocks until the
+// consumer has acquired the element.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/IR/Attributes.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "aie-objectFifo-cascade"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// Width in bits of the cascade stream of first generation AI Engines.
+static const unsigned cascadeWidth = 384;
+
+// Build a loop over the cascade words of an element, or a single word if the
+// element fits in one. Returns the index of the first lane of the word.
+static Value createWordLoop(OpBuilder &builder, Location loc, int64_t numWords,
+                            int64_t lanes) {
+  if (numWords == 1)
+    return builder.create<arith::ConstantIndexOp>(loc, 0);
+  Value lowerBound = builder.create<arith::ConstantIndexOp>(loc, 0);
+  Value upperBound =
+      builder.create<arith::ConstantIndexOp>(loc, numWords * lanes);
+  Value step = builder.create<arith::ConstantIndexOp>(loc, lanes);
+  auto forLoop = builder.create<scf::ForOp>(loc, lowerBound, upperBound, step);
+  builder.setInsertionPointToStart(forLoop.getBody());
+  return forLoop.getInductionVar();
+}
+
+namespace {
+
+class CascadeConversion {
+public:
+  CascadeConversion(ObjectFifoCreateOp createOp) : createOp(createOp) {}
+
+  // Check that the objectFifo can be moved to the cascade, and collect its
+  // acquires and releases. If emitErrors is set, report why it can't.
+  LogicalResult analyze(bool emitErrors);
+
+  CoreOp getProducerCore() { return producerCore; }
+  CoreOp getConsumerCore() { return consumerCore; }
+
+  void convert();
+
+private:
+  // Check the acquires and releases of one side of the objectFifo.
+  LogicalResult analyzeCore(CoreOp core, ObjectFifoPort port,
+                            function_ref<InFlightDiagnostic()> emitError);
+
+  BufferOp createBuffer(TileOp tile, StringRef suffix);
+
+  ObjectFifoCreateOp createOp;
+  MemRefType elementType;
+  CoreOp producerCore;
+  CoreOp consumerCore;
+  SmallVector<ObjectFifoAcquireOp> acquires;
+  SmallVector<ObjectFifoReleaseOp> releases;
+};
+
+} // namespace
+
+static CoreOp getCore(TileOp tile) {
+  for (Operation *user : tile->getUsers())
+    if (auto core = dyn_cast<CoreOp>(user))
+      return core;
+  return {};
+}
+
+LogicalResult CascadeConversion::analyze(bool emitErrors) {
+  auto emitError = [&]() -> InFlightDiagnostic {
+    if (emitErrors)
+      return createOp.emitOpError("can't use the cascade: ");
+    return InFlightDiagnostic();
+  };
+
+  const auto &targetModel = getTargetModel(createOp);
+  if (targetModel.getTargetArch() != AIEArch::AIE1)
+    return emitError() << "only AIE1 cascades are supported";
+  if (createOp.getConsumerTiles().size() != 1)
+    return emitError() << "expected a single consumer";
+
+  TileOp producerTile = createOp.getProducerTileOp();
+  auto consumerTile =
+      cast<TileOp>(createOp.getConsumerTiles().front().getDefiningOp());
+  TileID producerID = producerTile.getTileID();
+  TileID consumerID = consumerTile.getTileID();
+  if (!targetModel.isCoreTile(producerID.first, producerID.second) ||
+      !targetModel.isCoreTile(consumerID.first, consumerID.second))
+    return emitError() << "expected core tiles";
+  if (!targetModel.isLegalCascade(producerID.first, producerID.second,
+                                  consumerID.first, consumerID.second))
+    return emitError() << "consumer doesn't follow the producer in the "
+                          "cascade chain";
+
+  auto fifoType = createOp.getFifo().getType().cast<AIEObjectFifoType>();
+  elementType = fifoType.getElementType().dyn_cast<MemRefType>();
+  if (!elementType || !elementType.hasStaticShape() ||
+      elementType.getRank() != 1 ||
+      !elementType.getElementType().isIntOrFloat())
+    return emitError() << "expected a 1-D memref of scalars";
+  unsigned bitWidth = elementType.getElementTypeBitWidth();
+  if (cascadeWidth % bitWidth ||
+      elementType.getNumElements() * bitWidth % cascadeWidth)
+    return emitError() << "elements aren't a whole number of "
+                       << cascadeWidth << "-bit cascade words";
+
+  producerCore = getCore(producerTile);
+  consumerCore = getCore(consumerTile);
+  if (!producerCore || !consumerCore)
+    return emitError() << "expected cores on both tiles";
+
+  for (Operation *user : createOp->getUsers()) {
+    if (auto acquire = dyn_cast<ObjectFifoAcquireOp>(user))
+      acquires.push_back(acquire);
+    else if (auto release = dyn_cast<ObjectFifoReleaseOp>(user))
+      releases.push_back(release);
+    else
+      return emitError() << "used by " << user->getName();
+  }
+
+  // Acquires and releases outside of the two cores would be left dangling.
+  auto inCores = [&](Operation *op) {
+    auto core = op->getParentOfType<CoreOp>();
+    return core == producerCore || core == consumerCore;
+  };
+  if (!llvm::all_of(acquires, inCores) || !llvm::all_of(releases, inCores))
+    return emitError() << "used outside of the producer and consumer cores";
+
+  if (failed(analyzeCore(producerCore, ObjectFifoPort::Produce, emitError)) ||
+      failed(analyzeCore(consumerCore, ObjectFifoPort::Consume, emitError)))
+    return failure();
+  return success();
+}
+
+LogicalResult
+CascadeConversion::analyzeCore(CoreOp core, ObjectFifoPort port,
+                               function_ref<InFlightDiagnostic()> emitError) {
+  // Every element is acquired and released one at a time, in the same block,
+  // and is only accessed in between.
+  std::optional<ObjectFifoAcquireOp> pending;
+  WalkResult result = core.walk([&](Operation *op) {
+    if (auto acquire = dyn_cast<ObjectFifoAcquireOp>(op)) {
+      if (acquire.getFifo() != createOp.getFifo())
+        return WalkResult::advance();
+      if (acquire.getPort() != port || acquire.acqNumber() != 1 || pending) {
+        emitError() << "expected the " << stringifyObjectFifoPort(port)
+                    << " side to acquire one element at a time";
+        return WalkResult::interrupt();
+      }
+      for (Operation *user : acquire->getUsers()) {
+        auto access = dyn_cast<ObjectFifoSubviewAccessOp>(user);
+        if (!access || access.getIndex() != 0) {
+          emitError() << "expected accesses to the acquired element";
+          return WalkResult::interrupt();
+        }
+      }
+      pending = acquire;
+    } else if (auto release = dyn_cast<ObjectFifoReleaseOp>(op)) {
+      if (release.getFifo() != createOp.getFifo())
+        return WalkResult::advance();
+      if (release.getPort() != port || release.relNumber() != 1 ||
+          !pending || (*pending)->getBlock() != release->getBlock()) {
+        emitError() << "expected the " << stringifyObjectFifoPort(port)
+                    << " side to release each element in the block that "
+                       "acquires it";
+        return WalkResult::interrupt();
+      }
+      pending.reset();
+    }
+    return WalkResult::advance();
+  });
+  if (result.wasInterrupted())
+    return failure();
+  if (pending)
+    return emitError() << "expected the " << stringifyObjectFifoPort(port)
+                       << " side to release every element";
+  return success();
+}
+
+BufferOp CascadeConversion::createBuffer(TileOp tile, StringRef suffix) {
+  OpBuilder builder(createOp);
+  auto buffer =
+      builder.create<BufferOp>(builder.getUnknownLoc(), elementType, tile);
+  if (createOp.hasName())
+    buffer->setAttr(
+        SymbolTable::getSymbolAttrName(),
+        builder.getStringAttr(createOp.name()->getValue() + suffix));
+  return buffer;
+}
+
+void CascadeConversion::convert() {
+  Type scalarType = elementType.getElementType();
+  int64_t lanes = cascadeWidth / elementType.getElementTypeBitWidth();
+  int64_t numWords = elementType.getNumElements() / lanes;
+  auto vectorType = VectorType::get({lanes}, scalarType);
+  auto wordType = VectorType::get({1}, IntegerType::get(createOp.getContext(),
+                                                        cascadeWidth));
+
+  BufferOp producerBuffer = createBuffer(producerCore.getTileOp(), "_cascade");
+  BufferOp consumerBuffer =
+      createBuffer(consumerCore.getTileOp(), "_cascade_cons");
+
+  for (ObjectFifoAcquireOp acquire : acquires) {
+    bool isProducer = acquire.getPort() == ObjectFifoPort::Produce;
+    BufferOp buffer = isProducer ? producerBuffer : consumerBuffer;
+    for (Operation *user : llvm::make_early_inc_range(acquire->getUsers())) {
+      user->getResult(0).replaceAllUsesWith(buffer.getBuffer());
+      user->erase();
+    }
+
+    // The consumer pulls the element from the cascade when it acquires it.
+    if (!isProducer) {
+      OpBuilder builder(acquire);
+      Location loc = acquire.getLoc();
+      Value index = createWordLoop(builder, loc, numWords, lanes);
+      Value word = builder.create<GetCascadeOp>(
+          loc, IntegerType::get(builder.getContext(), cascadeWidth));
+      Value wordVector = builder.create<vector::BroadcastOp>(loc, wordType,
+                                                             word);
+      Value data =
+          builder.create<vector::BitCastOp>(loc, vectorType, wordVector);
+      builder.create<vector::TransferWriteOp>(loc, data, buffer.getBuffer(),
+                                              ValueRange{index});
+    }
+    acquire.erase();
+  }
+
+  for (ObjectFifoReleaseOp release : releases) {
+    // The producer pushes the element on the cascade when it releases it.
+    if (release.getPort() == ObjectFifoPort::Produce) {
+      OpBuilder builder(release);
+      Location loc = release.getLoc();
+      Value index = createWordLoop(builder, loc, numWords, lanes);
+      Value padding = builder.create<arith::ConstantOp>(
+          loc, builder.getZeroAttr(scalarType));
+      Value data = builder.create<vector::TransferReadOp>(
+          loc, vectorType, producerBuffer.getBuffer(), ValueRange{index},
+          padding);
+      Value wordVector =
+          builder.create<vector::BitCastOp>(loc, wordType, data);
+      Value word = builder.create<vector::ExtractOp>(loc, wordVector,
+                                                     ArrayRef<int64_t>{0});
+      builder.create<PutCascadeOp>(loc, word);
+    }
+    release.erase();
+  }
+
+  createOp.erase();
+}
+
+struct AIEObjectFifoCascadePass
+    : public AIEObjectFifoCascadeBase<AIEObjectFifoCascadePass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    DenseSet<StringRef> requested(fifoNames.begin(), fifoNames.end());
+
+    // Each core has a single cascade input and output, which may already be
+    // used directly.
+    DenseSet<Operation *> cascadeInputs;
+    DenseSet<Operation *> cascadeOutputs;
+    device.walk([&](Operation *op) {
+      if (isa<GetCascadeOp>(op))
+        cascadeInputs.insert(op->getParentOfType<CoreOp>());
+      else if (isa<PutCascadeOp>(op))
+        cascadeOutputs.insert(op->getParentOfType<CoreOp>());
+    });
+
+    SmallVector<CascadeConversion> conversions;
+    for (auto createOp : device.getOps<ObjectFifoCreateOp>()) {
+      bool isRequested =
+          createOp.hasName() && requested.count(createOp.name()->getValue());
+      if (!requested.empty() && !isRequested)
+        continue;
+
+      CascadeConversion conversion(createOp);
+      if (failed(conversion.analyze(/*emitErrors=*/isRequested))) {
+        if (isRequested)
+          return signalPassFailure();
+        LLVM_DEBUG(llvm::dbgs() << "Skipping " << createOp << "\n");
+        continue;
+      }
+
+      Operation *producer = conversion.getProducerCore();
+      Operation *consumer = conversion.getConsumerCore();
+      if (cascadeOutputs.count(producer) || cascadeInputs.count(consumer)) {
+        if (isRequested) {
+          createOp.emitOpError("can't use the cascade: the cascade port of "
+                               "a core is already used");
+          return signalPassFailure();
+        }
+        continue;
+      }
+      cascadeOutputs.insert(producer);
+      cascadeInputs.insert(consumer);
+      conversions.push_back(conversion);
+    }
+
+    for (auto &conversion : conversions)
+      conversion.convert();
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>>
+xilinx::AIE::createAIEObjectFifoCascadePass() {
+  return std::make_unique<AIEObjectFifoCascadePass>();
+}
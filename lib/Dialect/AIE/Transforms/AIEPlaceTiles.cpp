@@ -0,0 +1,420 @@
+//===- AIEPlaceTiles.cpp ----------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass assigns physical coordinates to the tiles of a device based on the
+// communication between them. The coordinates given in the input are treated
+// as an initial placement. Core tiles and memory tiles are moved to other
+// coordinates of the same type, while shim tiles stay where they are, since
+// they are bound to the external interfaces of the design.
+//
+// A placement is scored by the routed wirelength of flows and objectFifos,
+// plus the cost of the DMA channels needed by objectFifos between tiles that
+// can't share memory. Cores that access buffers or locks of another tile must
+// stay memory-adjacent to it, and cores connected by the cascade must stay
+// cascade neighbours. The placement is improved with greedy moves
+// followed by simulated annealing, and ties are broken in favor of the input
+// coordinates.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "mlir/IR/Attributes.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/Support/Debug.h"
+
+#include <cmath>
+#include <map>
+#include <optional>
+#include <random>
+#include <set>
+
+#define DEBUG_TYPE "aie-place-tiles"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// Cost of each switchbox hop of a stream connection.
+static const int64_t hopCost = 16;
+// Cost of the DMA channels of a connection that can't use shared memory.
+static const int64_t dmaCost = 64;
+// Cost of each hop a tile moves away from its input coordinates.
+static const int64_t displacementCost = 1;
+
+namespace {
+
+// A connection between two tiles, given as indices into the tiles being
+// placed.
+struct Connection {
+  unsigned src;
+  unsigned dst;
+  // True if the connection doesn't need DMAs when the tiles share memory.
+  bool canShareMemory;
+};
+
+class TilePlacement {
+public:
+  TilePlacement(const AIETargetModel &targetModel) : targetModel(targetModel) {}
+
+  unsigned addTile(TileOp tile) {
+    auto [it, inserted] =
+        tileIndex.insert({tile.getOperation(), tiles.size()});
+    if (inserted) {
+      tiles.push_back(tile);
+      initial.push_back(tile.getTileID());
+      tileConnections.emplace_back();
+    }
+    return it->second;
+  }
+
+  void addConnection(TileOp src, TileOp dst, bool canShareMemory) {
+    Connection connection{addTile(src), addTile(dst), canShareMemory};
+    tileConnections[connection.src].push_back(connections.size());
+    if (connection.dst != connection.src)
+      tileConnections[connection.dst].push_back(connections.size());
+    connections.push_back(connection);
+  }
+
+  // The core on tile core reads or writes the memory of tile mem.
+  void addMemoryAccess(TileOp core, TileOp mem) {
+    memoryAccesses.insert({addTile(core), addTile(mem)});
+  }
+
+  // The cascade output of the core on tile src feeds the core on tile dst.
+  void addCascade(TileOp src, TileOp dst) {
+    cascades.insert({addTile(src), addTile(dst)});
+  }
+
+  LogicalResult place(unsigned iterations, unsigned seed);
+
+  // Write the placement back to the tile ops.
+  void commit() {
+    for (unsigned i = 0; i < tiles.size(); ++i) {
+      OpBuilder builder(tiles[i]);
+      tiles[i]->setAttr("col", builder.getI32IntegerAttr(current[i].first));
+      tiles[i]->setAttr("row", builder.getI32IntegerAttr(current[i].second));
+    }
+  }
+
+private:
+  static int64_t distance(TileID a, TileID b) {
+    return std::abs(a.first - b.first) + std::abs(a.second - b.second);
+  }
+
+  bool isShim(TileID tile) const {
+    return targetModel.isShimNOCTile(tile.first, tile.second) ||
+           targetModel.isShimPLTile(tile.first, tile.second);
+  }
+
+  bool isSharedMemory(TileID a, TileID b) const {
+    if (isShim(a) || isShim(b))
+      return false;
+    return targetModel.isLegalMemAffinity(a.first, a.second, b.first,
+                                          b.second) ||
+           targetModel.isLegalMemAffinity(b.first, b.second, a.first,
+                                          a.second);
+  }
+
+  // Tiles can only move to other coordinates of the same type.
+  bool isMovable(unsigned tile) const {
+    TileID id = initial[tile];
+    return targetModel.isCoreTile(id.first, id.second) ||
+           targetModel.isMemTile(id.first, id.second);
+  }
+
+  bool isLegal() const {
+    return llvm::all_of(memoryAccesses,
+                        [&](auto access) {
+                          TileID core = current[access.first];
+                          TileID mem = current[access.second];
+                          return targetModel.isLegalMemAffinity(
+                              core.first, core.second, mem.first, mem.second);
+                        }) &&
+           llvm::all_of(cascades, [&](auto cascade) {
+             TileID src = current[cascade.first];
+             TileID dst = current[cascade.second];
+             return targetModel.isLegalCascade(src.first, src.second,
+                                               dst.first, dst.second);
+           });
+  }
+
+  int64_t connectionCost(const Connection &connection) const {
+    TileID src = current[connection.src];
+    TileID dst = current[connection.dst];
+    if (connection.canShareMemory && isSharedMemory(src, dst))
+      return 0;
+    return dmaCost + hopCost * distance(src, dst);
+  }
+
+  int64_t cost() const {
+    int64_t total = 0;
+    for (auto &connection : connections)
+      total += connectionCost(connection);
+    for (unsigned i = 0; i < tiles.size(); ++i)
+      total += displacementCost * distance(current[i], initial[i]);
+    return total;
+  }
+
+  // The part of the cost that depends on the coordinates of the given tiles:
+  // their displacement and their connections, each counted once.
+  int64_t partialCost(ArrayRef<unsigned> moved) const {
+    int64_t total = 0;
+    SmallVector<unsigned, 16> counted;
+    for (unsigned tile : moved) {
+      total += displacementCost * distance(current[tile], initial[tile]);
+      for (unsigned index : tileConnections[tile]) {
+        if (llvm::is_contained(counted, index))
+          continue;
+        counted.push_back(index);
+        total += connectionCost(connections[index]);
+      }
+    }
+    return total;
+  }
+
+  // Move tile to the given coordinates, as move() does, and return the change
+  // of cost. Only the tiles whose coordinates change, i.e., tile and the one
+  // it is swapped with, and their connections are evaluated.
+  int64_t moveAndGetDelta(unsigned tile, TileID to) {
+    SmallVector<unsigned, 2> moved{tile};
+    auto it = occupied.find(to);
+    if (it != occupied.end())
+      moved.push_back(it->second);
+    int64_t before = partialCost(moved);
+    move(tile, to);
+    return partialCost(moved) - before;
+  }
+
+  // Move tile to the given coordinates, swapping it with the tile that
+  // occupies them, if any.
+  void move(unsigned tile, TileID to) {
+    auto it = occupied.find(to);
+    TileID from = current[tile];
+    if (it != occupied.end()) {
+      unsigned other = it->second;
+      current[other] = from;
+      occupied[from] = other;
+    } else {
+      occupied.erase(from);
+    }
+    current[tile] = to;
+    occupied[to] = tile;
+  }
+
+  // Coordinates of the same type as tile.
+  const std::vector<TileID> &getCandidates(unsigned tile) const {
+    TileID id = initial[tile];
+    return targetModel.isMemTile(id.first, id.second) ? memTiles : coreTiles;
+  }
+
+  // Apply the best improving move until none is left. Returns the final cost.
+  int64_t improveGreedily(int64_t currentCost);
+
+  const AIETargetModel &targetModel;
+  std::vector<TileOp> tiles;
+  DenseMap<Operation *, unsigned> tileIndex;
+  std::vector<Connection> connections;
+  // The indices of the connections of each tile.
+  std::vector<SmallVector<unsigned, 4>> tileConnections;
+  std::set<std::pair<unsigned, unsigned>> memoryAccesses;
+  std::set<std::pair<unsigned, unsigned>> cascades;
+  std::vector<TileID> initial;
+  std::vector<TileID> current;
+  std::map<TileID, unsigned> occupied;
+  std::vector<TileID> coreTiles;
+  std::vector<TileID> memTiles;
+  std::vector<unsigned> movable;
+};
+
+} // namespace
+
+int64_t TilePlacement::improveGreedily(int64_t currentCost) {
+  while (true) {
+    int64_t bestCost = currentCost;
+    std::optional<std::pair<unsigned, TileID>> bestMove;
+    for (unsigned tile : movable) {
+      TileID from = current[tile];
+      for (TileID to : getCandidates(tile)) {
+        if (to == from)
+          continue;
+        auto it = occupied.find(to);
+        if (it != occupied.end() && !isMovable(it->second))
+          continue;
+        int64_t newCost = currentCost + moveAndGetDelta(tile, to);
+        if (isLegal() && newCost < bestCost) {
+          bestCost = newCost;
+          bestMove = {tile, to};
+        }
+        move(tile, from);
+      }
+    }
+    if (!bestMove)
+      return currentCost;
+    move(bestMove->first, bestMove->second);
+    currentCost = bestCost;
+  }
+}
+
+LogicalResult TilePlacement::place(unsigned iterations, unsigned seed) {
+  for (int col = 0; col < targetModel.columns(); ++col)
+    for (int row = 0; row < targetModel.rows(); ++row) {
+      if (targetModel.isCoreTile(col, row))
+        coreTiles.push_back({col, row});
+      else if (targetModel.isMemTile(col, row))
+        memTiles.push_back({col, row});
+    }
+
+  current = initial;
+  for (unsigned i = 0; i < tiles.size(); ++i) {
+    if (!occupied.insert({current[i], i}).second)
+      return tiles[i].emitOpError("is placed on the same coordinates as "
+                                  "another tile");
+    if (isMovable(i))
+      movable.push_back(i);
+  }
+  if (!isLegal())
+    return tiles.front().emitOpError(
+        "initial placement has a core accessing non-adjacent memory");
+  if (movable.empty())
+    return success();
+
+  int64_t currentCost = improveGreedily(cost());
+  LLVM_DEBUG(llvm::dbgs() << "Greedy placement cost: " << currentCost << "\n");
+
+  // Simulated annealing from the greedy placement, keeping the best placement
+  // seen. The temperature decreases geometrically from the cost of a DMA
+  // connection to a fraction of a hop.
+  std::mt19937 rng(seed);
+  std::vector<TileID> best = current;
+  int64_t bestCost = currentCost;
+  double temperature = dmaCost;
+  double finalTemperature = 0.1;
+  double cooling =
+      iterations ? std::pow(finalTemperature / temperature, 1.0 / iterations)
+                 : 1.0;
+  for (unsigned i = 0; i < iterations; ++i, temperature *= cooling) {
+    unsigned tile = movable[rng() % movable.size()];
+    auto &candidates = getCandidates(tile);
+    TileID from = current[tile];
+    TileID to = candidates[rng() % candidates.size()];
+    auto it = occupied.find(to);
+    if (to == from || (it != occupied.end() && !isMovable(it->second)))
+      continue;
+    int64_t delta = moveAndGetDelta(tile, to);
+    int64_t newCost = currentCost + delta;
+    double threshold = std::exp(-delta / temperature);
+    if (!isLegal() || (delta > 0 && double(rng()) / rng.max() >= threshold)) {
+      move(tile, from);
+      continue;
+    }
+    currentCost = newCost;
+    if (currentCost < bestCost) {
+      bestCost = currentCost;
+      best = current;
+    }
+  }
+
+  current = best;
+  occupied.clear();
+  for (unsigned i = 0; i < tiles.size(); ++i)
+    occupied[current[i]] = i;
+  currentCost = improveGreedily(bestCost);
+  LLVM_DEBUG(llvm::dbgs() << "Final placement cost: " << currentCost << "\n");
+  return success();
+}
+
+struct AIEPlaceTilesPass : public AIEPlaceTilesBase<AIEPlaceTilesPass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+
+    // Moving tiles would invalidate the routes of switchboxes and the
+    // connections of shim muxes.
+    for (Operation &op : device.getOps())
+      if (isa<SwitchboxOp, ShimMuxOp>(op)) {
+        op.emitOpError("must be created after tile placement");
+        return signalPassFailure();
+      }
+
+    TilePlacement placement(device.getTargetModel());
+    for (auto tile : device.getOps<TileOp>())
+      placement.addTile(tile);
+
+    for (auto flow : device.getOps<FlowOp>())
+      placement.addConnection(cast<TileOp>(flow.getSource().getDefiningOp()),
+                              cast<TileOp>(flow.getDest().getDefiningOp()),
+                              /*canShareMemory=*/false);
+
+    for (auto packetFlow : device.getOps<PacketFlowOp>()) {
+      SmallVector<TileOp, 4> sources;
+      SmallVector<TileOp, 4> dests;
+      for (Operation &op : packetFlow.getPorts().getOps()) {
+        if (auto source = dyn_cast<PacketSourceOp>(op))
+          sources.push_back(cast<TileOp>(source.getTile().getDefiningOp()));
+        else if (auto dest = dyn_cast<PacketDestOp>(op))
+          dests.push_back(cast<TileOp>(dest.getTile().getDefiningOp()));
+      }
+      for (auto source : sources)
+        for (auto dest : dests)
+          placement.addConnection(source, dest, /*canShareMemory=*/false);
+    }
+
+    // An objectFifo with a single consumer is implemented in shared memory
+    // when its tiles are adjacent.
+    for (auto createOp : device.getOps<ObjectFifoCreateOp>()) {
+      bool canShareMemory = createOp.getConsumerTiles().size() == 1;
+      for (auto consumer : createOp.getConsumerTiles())
+        placement.addConnection(createOp.getProducerTileOp(),
+                                cast<TileOp>(consumer.getDefiningOp()),
+                                canShareMemory);
+    }
+
+    for (auto core : device.getOps<CoreOp>()) {
+      TileOp coreTile = core.getTileOp();
+      core.walk([&](Operation *op) {
+        for (Value operand : op->getOperands()) {
+          TileOp memTile;
+          if (auto buffer = operand.getDefiningOp<BufferOp>())
+            memTile = buffer.getTileOp();
+          else if (auto lock = operand.getDefiningOp<LockOp>())
+            memTile = lock.getTileOp();
+          if (memTile && memTile != coreTile)
+            placement.addMemoryAccess(coreTile, memTile);
+        }
+      });
+    }
+
+    // The cascade ops don't name the core at the other end, so the cores are
+    // paired as they are in the input placement.
+    const auto &targetModel = device.getTargetModel();
+    SmallVector<TileOp> cascadeSources;
+    SmallVector<TileOp> cascadeDests;
+    for (auto core : device.getOps<CoreOp>()) {
+      if (core.walk([](PutCascadeOp) { return WalkResult::interrupt(); })
+              .wasInterrupted())
+        cascadeSources.push_back(core.getTileOp());
+      if (core.walk([](GetCascadeOp) { return WalkResult::interrupt(); })
+              .wasInterrupted())
+        cascadeDests.push_back(core.getTileOp());
+    }
+    for (TileOp src : cascadeSources)
+      for (TileOp dst : cascadeDests)
+        if (targetModel.isLegalCascade(src.colIndex(), src.rowIndex(),
+                                       dst.colIndex(), dst.rowIndex()))
+          placement.addCascade(src, dst);
+
+    if (failed(placement.place(iterations, seed)))
+      return signalPassFailure();
+    placement.commit();
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>>
+xilinx::AIE::createAIEPlaceTilesPass() {
+  return std::make_unique<AIEPlaceTilesPass>();
+}
@@ -0,0 +1,499 @@
+//===- AIETilingSearch.cpp --------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass explores the tiling space of loop nests given as linalg ops or as
+// perfectly nested affine loops with constant bounds. Each loop of the nest is
+// split into a spatial factor, the number of cores its iterations are
+// distributed over, and a tile size, the number of iterations a core computes
+// at once. The remaining iterations run sequentially on each core.
+//
+// A candidate is feasible if its double-buffered tiles fit in the local memory
+// of a core next to the stack, if every operand gets a DMA channel, and if the
+// core tile has enough locks and buffer descriptors for the buffers. At most
+// two parallel loops are spatial: the outer one is mapped to the columns of
+// the array and the inner one to the rows of cores. Reduction loops always run
+// on a single core.
+//
+// Feasible candidates are ranked by the cycles of one core, computed as the
+// number of tiles times the larger of the compute and the transfer time of a
+// tile, since the transfer of the next tile overlaps with the computation of
+// the current one. The best candidate is attached to the op as an aie.tiling
+// attribute.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/IR/Attributes.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/Support/Debug.h"
+
+#include <limits>
+#include <optional>
+
+#define DEBUG_TYPE "aie-tiling-search"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// Cycles spent outside of the vector unit for each tile: loop control, lock
+// acquires and releases, and the prologue and epilogue of the inner loop.
+static const int64_t tileOverheadCycles = 16;
+// Bytes a DMA channel moves per cycle over a 32-bit stream.
+static const int64_t dmaBytesPerCycle = 4;
+// Buffers allocated for each operand, so that transfers overlap computation.
+static const int64_t buffersPerOperand = 2;
+
+namespace {
+
+// An operand of a loop nest. The access maps are expressed in terms of the
+// iterations of the loops of the nest.
+struct NestOperand {
+  SmallVector<AffineMap, 2> maps;
+  Type elementType;
+  bool isOutput;
+};
+
+struct LoopNest {
+  SmallVector<int64_t, 4> bounds;
+  SmallVector<NestOperand, 4> operands;
+};
+
+struct TilingCandidate {
+  SmallVector<int64_t, 4> tileSizes;
+  SmallVector<int64_t, 4> cores;
+  int64_t cycles;
+  int64_t numCores;
+  int64_t memoryBytes;
+
+  bool operator<(const TilingCandidate &other) const {
+    return std::tie(cycles, numCores, memoryBytes, tileSizes, cores) <
+           std::tie(other.cycles, other.numCores, other.memoryBytes,
+                    other.tileSizes, other.cores);
+  }
+};
+
+// The resources of a core tile that constrain the tiling.
+struct CoreResources {
+  int64_t columns;
+  int64_t rows;
+  int64_t memoryBytes;
+  int64_t inputChannels;
+  int64_t outputChannels;
+  int64_t locks;
+  int64_t bds;
+  AIEArch arch;
+};
+
+} // namespace
+
+//===----------------------------------------------------------------------===//
+// Loop nest extraction
+//===----------------------------------------------------------------------===//
+
+static std::optional<LoopNest> getLoopNest(linalg::LinalgOp op) {
+  LoopNest nest;
+  for (int64_t bound : op.getStaticLoopRanges()) {
+    if (ShapedType::isDynamic(bound) || bound <= 0)
+      return std::nullopt;
+    nest.bounds.push_back(bound);
+  }
+  for (OpOperand &operand : op->getOpOperands()) {
+    auto type = operand.get().getType().dyn_cast<ShapedType>();
+    if (!type)
+      continue;
+    nest.operands.push_back({{op.getMatchingIndexingMap(&operand)},
+                             type.getElementType(),
+                             op.isDpsInit(&operand)});
+  }
+  return nest;
+}
+
+// Return the loops of the perfect nest rooted at the given loop, if all of
+// them have constant bounds.
+static SmallVector<AffineForOp, 4> getPerfectNest(AffineForOp outermost) {
+  SmallVector<AffineForOp, 4> loops;
+  AffineForOp loop = outermost;
+  while (loop) {
+    if (!loop.hasConstantBounds() ||
+        loop.getConstantUpperBound() <= loop.getConstantLowerBound())
+      return {};
+    loops.push_back(loop);
+    Block *body = loop.getBody();
+    // The body of a loop that isn't innermost is a loop and a terminator
+    if (body->getOperations().size() != 2)
+      break;
+    loop = dyn_cast<AffineForOp>(body->front());
+  }
+  return loops;
+}
+
+static std::optional<LoopNest> getLoopNest(AffineForOp outermost) {
+  SmallVector<AffineForOp, 4> loops = getPerfectNest(outermost);
+  if (loops.empty())
+    return std::nullopt;
+
+  LoopNest nest;
+  for (auto loop : loops) {
+    int64_t step = loop.getStep();
+    nest.bounds.push_back((loop.getConstantUpperBound() -
+                           loop.getConstantLowerBound() + step - 1) /
+                          step);
+  }
+
+  // Express a map operand in terms of the iterations of the nest. Values
+  // that don't depend on the nest are only an offset, so they are ignored.
+  MLIRContext *context = outermost.getContext();
+  auto getOperandExpr = [&](Value operand) -> AffineExpr {
+    for (auto [index, loop] : llvm::enumerate(loops))
+      if (operand == loop.getInductionVar())
+        return getAffineDimExpr(index, context) * loop.getStep() +
+               loop.getConstantLowerBound();
+    if (auto constant = operand.getDefiningOp<arith::ConstantIndexOp>())
+      return getAffineConstantExpr(constant.value(), context);
+    return getAffineConstantExpr(0, context);
+  };
+
+  DenseMap<Value, unsigned> operandIndex;
+  auto addAccess = [&](Value memref, AffineMap map, ValueRange mapOperands,
+                       bool isWrite) {
+    SmallVector<AffineExpr, 4> dims, symbols;
+    for (Value operand : mapOperands.take_front(map.getNumDims()))
+      dims.push_back(getOperandExpr(operand));
+    for (Value operand : mapOperands.drop_front(map.getNumDims()))
+      symbols.push_back(getOperandExpr(operand));
+    AffineMap nestMap =
+        map.replaceDimsAndSymbols(dims, symbols, loops.size(), 0);
+
+    auto [it, inserted] =
+        operandIndex.insert({memref, (unsigned)nest.operands.size()});
+    if (inserted)
+      nest.operands.push_back(
+          {{}, memref.getType().cast<MemRefType>().getElementType(), false});
+    NestOperand &operand = nest.operands[it->second];
+    operand.maps.push_back(nestMap);
+    operand.isOutput |= isWrite;
+  };
+
+  // Accesses in loops below the perfect nest would depend on iterations the
+  // model doesn't know about
+  bool isPerfect = true;
+  loops.back().getBody()->walk([&](AffineForOp) { isPerfect = false; });
+  if (!isPerfect)
+    return std::nullopt;
+
+  loops.back().getBody()->walk([&](Operation *op) {
+    if (auto load = dyn_cast<AffineLoadOp>(op))
+      addAccess(load.getMemRef(), load.getAffineMap(), load.getMapOperands(),
+                /*isWrite=*/false);
+    else if (auto store = dyn_cast<AffineStoreOp>(op))
+      addAccess(store.getMemRef(), store.getAffineMap(),
+                store.getMapOperands(), /*isWrite=*/true);
+  });
+  if (nest.operands.empty())
+    return std::nullopt;
+  return nest;
+}
+
+//===----------------------------------------------------------------------===//
+// Cost model
+//===----------------------------------------------------------------------===//
+
+// Decompose expr, scaled by scale, into per-loop coefficients and a constant.
+// Return false if the expression isn't linear.
+static bool getLinearForm(AffineExpr expr, int64_t scale,
+                          SmallVectorImpl<int64_t> &coefficients,
+                          int64_t &constant) {
+  if (auto dim = expr.dyn_cast<AffineDimExpr>()) {
+    coefficients[dim.getPosition()] += scale;
+    return true;
+  }
+  if (auto value = expr.dyn_cast<AffineConstantExpr>()) {
+    constant += scale * value.getValue();
+    return true;
+  }
+  auto binary = expr.dyn_cast<AffineBinaryOpExpr>();
+  if (!binary)
+    return false;
+  if (expr.getKind() == AffineExprKind::Add)
+    return getLinearForm(binary.getLHS(), scale, coefficients, constant) &&
+           getLinearForm(binary.getRHS(), scale, coefficients, constant);
+  if (expr.getKind() == AffineExprKind::Mul)
+    if (auto factor = binary.getRHS().dyn_cast<AffineConstantExpr>())
+      return getLinearForm(binary.getLHS(), scale * factor.getValue(),
+                           coefficients, constant);
+  return false;
+}
+
+// Return the number of elements of the operand accessed by a tile.
+static int64_t getFootprint(const NestOperand &operand,
+                            ArrayRef<int64_t> tileSizes) {
+  unsigned numLoops = tileSizes.size();
+  int64_t footprint = 1;
+  for (unsigned result = 0; result < operand.maps.front().getNumResults();
+       ++result) {
+    // The extent of a dimension is the largest span of one access, plus the
+    // distance between the accesses.
+    int64_t span = 0;
+    int64_t minOffset = std::numeric_limits<int64_t>::max();
+    int64_t maxOffset = std::numeric_limits<int64_t>::min();
+    for (AffineMap map : operand.maps) {
+      AffineExpr expr = map.getResult(result);
+      SmallVector<int64_t, 4> coefficients(numLoops, 0);
+      int64_t constant = 0;
+      if (!getLinearForm(expr, 1, coefficients, constant)) {
+        // Assume that the accesses cover the whole tile of every loop the
+        // expression depends on.
+        std::fill(coefficients.begin(), coefficients.end(), 0);
+        constant = 0;
+        int64_t extent = 1;
+        for (unsigned loop = 0; loop < numLoops; ++loop)
+          if (expr.isFunctionOfDim(loop))
+            extent *= tileSizes[loop];
+        span = std::max(span, extent - 1);
+      } else {
+        int64_t accessSpan = 0;
+        for (unsigned loop = 0; loop < numLoops; ++loop)
+          accessSpan += std::abs(coefficients[loop]) * (tileSizes[loop] - 1);
+        span = std::max(span, accessSpan);
+      }
+      minOffset = std::min(minOffset, constant);
+      maxOffset = std::max(maxOffset, constant);
+    }
+    footprint *= span + (maxOffset - minOffset) + 1;
+  }
+  return footprint;
+}
+
+static int64_t getElementBytes(Type type) {
+  return std::max<int64_t>(1, type.getIntOrFloatBitWidth() / 8);
+}
+
+// Return the number of multiply-accumulates the vector unit of a core
+// performs each cycle on elements of the given type.
+static int64_t getMacsPerCycle(AIEArch arch, Type type) {
+  unsigned bits = type.getIntOrFloatBitWidth();
+  if (arch == AIEArch::AIE2) {
+    if (type.isBF16())
+      return 128;
+    if (type.isa<FloatType>())
+      return 16;
+    return bits <= 8 ? 256 : bits <= 16 ? 64 : 16;
+  }
+  if (type.isa<FloatType>())
+    return 8;
+  return bits <= 8 ? 128 : bits <= 16 ? 32 : 8;
+}
+
+// Compute the cost of the candidate, or return false if it doesn't fit in a
+// core.
+static bool evaluate(const LoopNest &nest, const CoreResources &resources,
+                     ArrayRef<bool> isReduction, TilingCandidate &candidate) {
+  int64_t numInputs = 0, numOutputs = 0;
+  int64_t memoryBytes = 0;
+  int64_t inputCycles = 0, outputCycles = 0;
+  Type computeType;
+  for (const NestOperand &operand : nest.operands) {
+    int64_t bytes = getFootprint(operand, candidate.tileSizes) *
+                    getElementBytes(operand.elementType);
+    memoryBytes += buffersPerOperand * bytes;
+    int64_t cycles = (bytes + dmaBytesPerCycle - 1) / dmaBytesPerCycle;
+    if (operand.isOutput) {
+      ++numOutputs;
+      outputCycles = std::max(outputCycles, cycles);
+    } else {
+      ++numInputs;
+      inputCycles = std::max(inputCycles, cycles);
+      if (!computeType || operand.elementType.getIntOrFloatBitWidth() >
+                              computeType.getIntOrFloatBitWidth())
+        computeType = operand.elementType;
+    }
+  }
+  if (!computeType)
+    computeType = nest.operands.front().elementType;
+
+  if (memoryBytes > resources.memoryBytes ||
+      numInputs > resources.inputChannels ||
+      numOutputs > resources.outputChannels ||
+      buffersPerOperand * (int64_t)nest.operands.size() > resources.locks ||
+      buffersPerOperand * (int64_t)nest.operands.size() > resources.bds)
+    return false;
+
+  int64_t numTiles = 1, reductionTiles = 1, iterations = 1;
+  candidate.numCores = 1;
+  for (unsigned loop = 0; loop < nest.bounds.size(); ++loop) {
+    int64_t tiles = nest.bounds[loop] /
+                    (candidate.cores[loop] * candidate.tileSizes[loop]);
+    numTiles *= tiles;
+    if (isReduction[loop])
+      reductionTiles *= tiles;
+    iterations *= candidate.tileSizes[loop];
+    candidate.numCores *= candidate.cores[loop];
+  }
+
+  // An output tile is only sent out once its reduction is complete.
+  int64_t macs = getMacsPerCycle(resources.arch, computeType);
+  int64_t computeCycles = (iterations + macs - 1) / macs + tileOverheadCycles;
+  int64_t transferCycles =
+      std::max(inputCycles, (outputCycles + reductionTiles - 1) /
+                                reductionTiles);
+  candidate.cycles = numTiles * std::max(computeCycles, transferCycles) +
+                     std::min(computeCycles, transferCycles);
+  candidate.memoryBytes = memoryBytes;
+  return true;
+}
+
+static SmallVector<int64_t, 8> getDivisors(int64_t n) {
+  SmallVector<int64_t, 8> divisors;
+  for (int64_t d = 1; d <= n; ++d)
+    if (n % d == 0)
+      divisors.push_back(d);
+  return divisors;
+}
+
+// Enumerate the spatial factors and tile sizes of the loops from loop on,
+// and collect the best feasible candidates, up to limit of them.
+static void enumerateTilings(const LoopNest &nest,
+                             const CoreResources &resources,
+                             ArrayRef<bool> isReduction, unsigned loop,
+                             unsigned numSpatial, unsigned limit,
+                             TilingCandidate &candidate,
+                             SmallVectorImpl<TilingCandidate> &feasible) {
+  if (loop == nest.bounds.size()) {
+    if (!evaluate(nest, resources, isReduction, candidate))
+      return;
+    feasible.push_back(candidate);
+    // Drop the worst candidates now and then, the search space grows with the
+    // product of the number of divisors of each bound
+    if (feasible.size() >= 4 * limit) {
+      llvm::sort(feasible);
+      feasible.resize(limit);
+    }
+    return;
+  }
+  int64_t spatialLimit = isReduction[loop] ? 1
+                         : numSpatial == 0 ? resources.columns
+                         : numSpatial == 1 ? resources.rows
+                                           : 1;
+  for (int64_t cores : getDivisors(nest.bounds[loop])) {
+    if (cores > spatialLimit)
+      break;
+    candidate.cores[loop] = cores;
+    for (int64_t tileSize : getDivisors(nest.bounds[loop] / cores)) {
+      candidate.tileSizes[loop] = tileSize;
+      enumerateTilings(nest, resources, isReduction, loop + 1,
+                       numSpatial + (cores > 1), limit, candidate, feasible);
+    }
+  }
+}
+
+static CoreResources getCoreResources(Operation *op) {
+  const auto &targetModel = getTargetModel(op);
+  CoreResources resources;
+  resources.arch = targetModel.getTargetArch();
+  resources.columns = targetModel.columns();
+  resources.rows = targetModel.rows() - 1 - targetModel.getNumMemTileRows();
+
+  // All the core tiles have the same resources
+  int col = 0, row = 1 + targetModel.getNumMemTileRows();
+  resources.inputChannels =
+      targetModel.getNumDestSwitchboxConnections(col, row, WireBundle::DMA);
+  resources.outputChannels =
+      targetModel.getNumSourceSwitchboxConnections(col, row, WireBundle::DMA);
+  resources.locks = targetModel.getNumLocks(col, row);
+  resources.bds = targetModel.getNumBDs(col, row);
+
+  int64_t stackSize = 0x400;
+  if (auto core = op->getParentOfType<CoreOp>())
+    stackSize = core.getStackSize();
+  resources.memoryBytes = targetModel.getLocalMemorySize() - stackSize;
+  return resources;
+}
+
+// Rank the tilings of the nest. Return the best feasible candidates, up to
+// limit of them, best first.
+static SmallVector<TilingCandidate>
+searchTilings(const LoopNest &nest, Operation *op, unsigned limit) {
+  CoreResources resources = getCoreResources(op);
+
+  // Loops that don't index any output accumulate into the same elements
+  SmallVector<bool, 4> isReduction;
+  for (unsigned loop = 0; loop < nest.bounds.size(); ++loop)
+    isReduction.push_back(llvm::none_of(nest.operands, [&](auto &operand) {
+      return operand.isOutput &&
+             llvm::any_of(operand.maps, [&](AffineMap map) {
+               return map.isFunctionOfDim(loop);
+             });
+    }));
+
+  TilingCandidate candidate;
+  candidate.tileSizes.assign(nest.bounds.size(), 1);
+  candidate.cores.assign(nest.bounds.size(), 1);
+  SmallVector<TilingCandidate> feasible;
+  enumerateTilings(nest, resources, isReduction, 0, 0, limit, candidate,
+                   feasible);
+  llvm::sort(feasible);
+  if (feasible.size() > limit)
+    feasible.resize(limit);
+  return feasible;
+}
+
+struct AIETilingSearchPass
+    : public AIETilingSearchBase<AIETilingSearchPass> {
+  void runOnOperation() override {
+    getOperation().walk([&](Operation *op) {
+      std::optional<LoopNest> nest;
+      if (auto linalgOp = dyn_cast<linalg::LinalgOp>(op))
+        nest = getLoopNest(linalgOp);
+      else if (auto forOp = dyn_cast<AffineForOp>(op))
+        if (!forOp->getParentOfType<AffineForOp>())
+          nest = getLoopNest(forOp);
+      if (!nest)
+        return;
+
+      SmallVector<TilingCandidate> candidates =
+          searchTilings(*nest, op, std::max<unsigned>(report, 1));
+      if (candidates.empty()) {
+        op->emitWarning("no tiling fits in the resources of a core");
+        return;
+      }
+
+      for (unsigned i = 0; i < report && i < candidates.size(); ++i) {
+        auto &candidate = candidates[i];
+        std::string str;
+        llvm::raw_string_ostream os(str);
+        os << "tiling #" << i << ": tile sizes [";
+        llvm::interleaveComma(candidate.tileSizes, os);
+        os << "], cores [";
+        llvm::interleaveComma(candidate.cores, os);
+        os << "], " << candidate.cycles << " cycles, "
+           << candidate.memoryBytes << " bytes of local memory";
+        op->emitRemark(os.str());
+      }
+
+      const TilingCandidate &best = candidates.front();
+      Builder builder(op->getContext());
+      NamedAttribute attrs[] = {
+          builder.getNamedAttr("cores", builder.getI64ArrayAttr(best.cores)),
+          builder.getNamedAttr("cycles",
+                               builder.getI64IntegerAttr(best.cycles)),
+          builder.getNamedAttr("tile_sizes",
+                               builder.getI64ArrayAttr(best.tileSizes))};
+      op->setAttr("aie.tiling", builder.getDictionaryAttr(attrs));
+    });
+  }
+};
+
+std::unique_ptr<OperationPass<ModuleOp>>
+xilinx::AIE::createAIETilingSearchPass() {
+  return std::make_unique<AIETilingSearchPass>();
+}
@@ -1699,9 +1699,13 @@ template <typename T> LogicalResult verifyMulFMAConvOp(T op) {
     return op.emitError("The element type of lhs and rhs "
                         "operand vectors must match");
 
-  if (!ltype.isa<IntegerType>() || !rtype.isa<IntegerType>() ||
-      !atype.isa<IntegerType>()) {
-    return op.emitError("requires integer type");
+  // bfloat16 convolutions accumulate in float
+  if (ltype.isBF16()) {
+    if (!atype.isF32())
+      return op.emitError("requires f32 accumulator for bf16 operands");
+  } else if (!ltype.isa<IntegerType>() || !rtype.isa<IntegerType>() ||
+             !atype.isa<IntegerType>()) {
+    return op.emitError("requires integer or bf16 type");
   }
 
   unsigned ltypeWidth = ltype.getIntOrFloatBitWidth();
@@ -1798,5 +1802,47 @@ ParseResult FMAConvOp::parse(OpAsmParser &parser, OperationState &result) {
   return parseMulFMAConvOp(parser, result, true);
 }
 
+//===----------------------------------------------------------------------===//
+// MatMulOp
+//===----------------------------------------------------------------------===//
+
+// Verify MatMul op.
+LogicalResult MatMulOp::verify() {
+  auto lhsType = getLhs().getType().cast<VectorType>();
+  auto rhsType = getRhs().getType().cast<VectorType>();
+  auto accType = getAcc().getType().cast<VectorType>();
+
+  Type ltype = lhsType.getElementType();
+  if (ltype != rhsType.getElementType())
+    return emitError("The element type of lhs and rhs "
+                     "operand vectors must match");
+
+  ArrayRef<int64_t> lhsShape = lhsType.getShape();
+  ArrayRef<int64_t> rhsShape = rhsType.getShape();
+  ArrayRef<int64_t> accShape = accType.getShape();
+  if (lhsShape[1] != rhsShape[0] || lhsShape[0] != accShape[0] ||
+      rhsShape[1] != accShape[1])
+    return emitError("requires an (M x K) lhs, a (K x N) rhs and an (M x N) "
+                     "accumulator");
+
+  int64_t M = lhsShape[0], K = lhsShape[1], N = rhsShape[1];
+  Type atype = accType.getElementType();
+  if (ltype.isInteger(8) || ltype.isBF16()) {
+    if (M != 4 || K != 8 || N != 4)
+      return emitError("requires a 4x8x4 shape for i8 and bf16 operands");
+    if (ltype.isInteger(8) && !atype.isInteger(32))
+      return emitError("requires i32 accumulator for i8 operands");
+    if (ltype.isBF16() && !atype.isF32())
+      return emitError("requires f32 accumulator for bf16 operands");
+  } else {
+    if (M != 4 || K != 4 || N != 4)
+      return emitError("requires a 4x4x4 shape for i16 operands");
+    if (!atype.isInteger(64))
+      return emitError("requires i64 accumulator for i16 operands");
+  }
+
+  return success();
+}
+
 #define GET_OP_CLASSES
 #include "aie/Dialect/AIEVec/IR/AIEVecOps.cpp.inc"
@@ -12,6 +12,9 @@
 // AIE vector abstraction.
 //===----------------------------------------------------------------------===//
 
+#include <map>
+#include <set>
+
 #include "aie/Dialect/AIEVec/AIEVecUtils.h"
 #include "aie/Dialect/AIEVec/IR/AIEVecOps.h"
 #include "aie/Dialect/AIEVec/Transforms/IntervalReuse.h"
@@ -19,11 +22,13 @@
 #include "mlir/Conversion/AffineToStandard/AffineToStandard.h"
 #include "mlir/Dialect/Affine/Analysis/LoopAnalysis.h"
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Affine/LoopUtils.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Dialect/Vector/Transforms/VectorTransforms.h"
 #include "mlir/IR/TypeUtilities.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Transforms/Passes.h"
 #include "llvm/ADT/SmallSet.h"
@@ -1143,11 +1148,13 @@ static int32_t computeVecorizedLoopStepSize(Operation *op, VectState *state) {
       }
     }
   }
-  assert(isPowerOfTwo(step) &&
-         "non-power-of-two vectorization factor not supported");
   // The step increment in vectorized code is scaled by factor of vector lanes;
-  // account for that.
+  // account for that. What remains is the distance between the elements read
+  // by consecutive lanes, which is more than 1 for strided loops, and need not
+  // be a power of 2.
   unsigned lanes = getVectorLaneSize(vectorType);
+  assert(step % lanes == 0 &&
+         "loop step must be a multiple of the vectorization factor");
   return step / lanes;
 }
 
@@ -1610,7 +1617,7 @@ static void computeZbuffAttr_i16xi16(
       offsetStr.push_back(getHexValue(i * accIncr));
     offsetHiStr = "0x";
     for (auto i = vecSize - 1, e = vecSize / 2; i >= e; --i)
-      offsetStr.push_back(getHexValue(i * accIncr));
+      offsetHiStr.push_back(getHexValue(i * accIncr));
   }
 
   // Compute step between columns
@@ -2941,6 +2948,60 @@ static LogicalResult hasUnalignedLoads(func::FuncOp func, VectState *state) {
   return success();
 }
 
+// Returns true if the lanes of an AIE op can read the elements that `readOp`
+// reads `stride` apart. The stride is expressed by the 4-bit lane offsets of
+// the op, so the farthest lane must still be within reach. The 16-bit schemes
+// address pairs of lanes, and only the xbuff of mul/fma, whose zbuff is then a
+// splat, has room for a stride. The 8-bit schemes have none.
+static bool isSupportedStride(Operation *op, TransferReadOp readOp,
+                              bool otherIsSplat, int32_t stride) {
+  VectorType vectorType = readOp.getVectorType();
+  int32_t lanes = getVectorLaneSize(vectorType);
+  unsigned elementSizeInBits = getElementSizeInBits(vectorType);
+  if (elementSizeInBits == 32)
+    return (lanes - 1) * stride < 16;
+  if (elementSizeInBits == 16 && isa<MulIOp, MulFOp, vector::FMAOp>(op))
+    return otherIsSplat && stride % 2 == 0 && (lanes - 2) * stride / 2 < 16;
+  return false;
+}
+
+static LogicalResult hasUnsupportedStrides(func::FuncOp func,
+                                           VectState *state) {
+  WalkResult result = func.walk([&](Operation *op) {
+    if (!isa<MulIOp, MulFOp, vector::FMAOp, SubIOp, SubFOp, AddIOp, AddFOp>(
+            op) ||
+        !isa<VectorType>(op->getResult(0).getType()))
+      return WalkResult::advance();
+
+    for (unsigned idx = 0; idx < 2; ++idx) {
+      auto readOp =
+          dyn_cast_or_null<TransferReadOp>(getOperandDefOp(state, op, idx));
+      if (!readOp || readOp.getPermutationMap().isConstant())
+        continue;
+      int32_t stride = computeVecorizedLoopStepSize(readOp, state);
+      if (stride <= 1)
+        continue;
+      auto otherOp =
+          dyn_cast_or_null<TransferReadOp>(getOperandDefOp(state, op, 1 - idx));
+      bool otherIsSplat = otherOp && otherOp.getPermutationMap().isConstant();
+      if (!isSupportedStride(op, readOp, otherIsSplat, stride)) {
+        readOp->emitError() << "Loop step of inner index of "
+                            << readOp->getName() << " reads elements " << stride
+                            << " apart, which " << op->getName()
+                            << " can't permute into its lanes.";
+        return WalkResult::interrupt();
+      }
+    }
+    return WalkResult::advance();
+  });
+
+  if (result.wasInterrupted()) {
+    return failure();
+  }
+
+  return success();
+}
+
 // Compute the reuse interval for all the transfer_read operations. The
 // transfer_read operations capture the vector load. Since AIE only allows for
 // aligned vector loads, we need to compose multiple transfer reads together to
@@ -2980,6 +3041,242 @@ static void reassociateOpsInFunc(func::FuncOp func, VectState *state) {
   reassociateAddOpInFunc(func, state);
 }
 
+//===----------------------------------------------------------------------===//
+// Register-pressure-aware unroll-and-jam
+//===----------------------------------------------------------------------===//
+
+// Returns the sizes, in bits, of the vector and accumulator register files:
+// eight 256-bit vector and four 768-bit accumulator registers on AIE, and
+// twelve 512-bit vector and nine 1024-bit accumulator registers on AIE-ML.
+static std::pair<unsigned, unsigned> getRegisterFileSizes() {
+  if (AIEML)
+    return {12 * 512, 9 * 1024};
+  return {8 * 256, 4 * 768};
+}
+
+// Returns the width of the accumulator lanes that products of elements of
+// type `type` are accumulated in.
+static unsigned getAccumulatorLaneWidth(Type type) {
+  if (type.isa<FloatType>())
+    return 32;
+  unsigned width = type.getIntOrFloatBitWidth();
+  if (AIEML)
+    return width == 32 ? 64 : 32;
+  return width == 32 ? 80 : 48;
+}
+
+// Returns true if `value` is computed from `iv`.
+static bool dependsOn(Value value, Value iv) {
+  if (value == iv)
+    return true;
+  Operation *defOp = value.getDefiningOp();
+  return defOp && llvm::any_of(defOp->getOperands(), [&](Value operand) {
+           return dependsOn(operand, iv);
+         });
+}
+
+// Describes `index` relative to the induction variable `iv`: an index
+// `iv + c` is {iv, c}, and an index that isn't computed from `iv` is
+// {index, 0}. Returns std::nullopt for any other index.
+static std::optional<std::pair<Value, int64_t>> decomposeIndex(Value index,
+                                                               Value iv) {
+  if (index == iv)
+    return std::make_pair(iv, int64_t(0));
+  if (auto applyOp = index.getDefiningOp<AffineApplyOp>()) {
+    AffineMap map = applyOp.getAffineMap();
+    if (map.getNumResults() == 1 && map.getNumDims() == 1 &&
+        map.getNumSymbols() == 0 && applyOp.getMapOperands()[0] == iv) {
+      auto [base, offset] = getBaseAndOffset(map.getResult(0));
+      if (base && base == getAffineDimExpr(0, map.getContext()))
+        return std::make_pair(iv, int64_t(offset));
+    }
+  }
+  if (!dependsOn(index, iv))
+    return std::make_pair(index, int64_t(0));
+  return std::nullopt;
+}
+
+// Returns true if `innerOp` multiplies vectors, i.e., unrolling and jamming
+// the loop around it exposes independent MAC chains.
+static bool hasVectorMACs(AffineForOp innerOp) {
+  WalkResult result = innerOp.walk([](Operation *op) {
+    if (isa<MulIOp, MulFOp, vector::FMAOp>(op) &&
+        isa<VectorType>(op->getResult(0).getType()))
+      return WalkResult::interrupt();
+    return WalkResult::advance();
+  });
+  return result.wasInterrupted();
+}
+
+// Returns true if distinct iterations of `forOp` write to disjoint slices of
+// memory, so that they can be reordered, and in particular unrolled and
+// jammed. That is the case if every memref written in the loop is only
+// accessed by transfer ops that index one of its non-vectorized dimensions
+// with the induction variable itself. Distinct memrefs are assumed not to
+// alias, as distinct AIE buffers don't.
+static bool hasIndependentIterations(AffineForOp forOp) {
+  Value iv = forOp.getInductionVar();
+  DenseMap<Value, SmallVector<Operation *>> accesses;
+  DenseSet<Value> writtenMemRefs;
+  WalkResult result = forOp.getBody()->walk([&](Operation *op) {
+    if (auto readOp = dyn_cast<TransferReadOp>(op)) {
+      accesses[readOp.getSource()].push_back(op);
+      return WalkResult::advance();
+    }
+    if (auto writeOp = dyn_cast<TransferWriteOp>(op)) {
+      accesses[writeOp.getSource()].push_back(op);
+      writtenMemRefs.insert(writeOp.getSource());
+      return WalkResult::advance();
+    }
+    if (auto loadOp = dyn_cast<AffineLoadOp>(op)) {
+      accesses[loadOp.getMemRef()].push_back(op);
+      return WalkResult::advance();
+    }
+    if (isa<AffineForOp, AffineYieldOp>(op) || isMemoryEffectFree(op))
+      return WalkResult::advance();
+    return WalkResult::interrupt();
+  });
+  if (result.wasInterrupted())
+    return false;
+
+  for (Value memref : writtenMemRefs) {
+    auto memRefType = dyn_cast<MemRefType>(memref.getType());
+    if (!memRefType)
+      return false;
+    bool disjoint = false;
+    for (unsigned dim = 0; dim < memRefType.getRank() && !disjoint; dim++) {
+      auto indexesSliceByIV = [&](auto transferOp) {
+        return transferOp.getIndices()[dim] == iv &&
+               !transferOp.getPermutationMap().isFunctionOfDim(dim);
+      };
+      disjoint = llvm::all_of(accesses[memref], [&](Operation *op) {
+        if (auto readOp = dyn_cast<TransferReadOp>(op))
+          return indexesSliceByIV(readOp);
+        if (auto writeOp = dyn_cast<TransferWriteOp>(op))
+          return indexesSliceByIV(writeOp);
+        return false;
+      });
+    }
+    if (!disjoint)
+      return false;
+  }
+  return true;
+}
+
+// Estimates the bits of the vector and accumulator register files that the
+// body of `innerOp` needs once `outerOp`, the loop around it, is unrolled and
+// jammed by `factor`. Reads of the same rows of a memref share a vector
+// register, or a window of two when they are at different offsets, as they do
+// once IntervalReuse has coalesced them. Splat reads of the same rows share a
+// single register. Every distinct slice written takes an accumulator.
+static std::pair<unsigned, unsigned>
+estimateRegisterPressure(AffineForOp outerOp, AffineForOp innerOp,
+                         unsigned factor) {
+  Value outerIV = outerOp.getInductionVar();
+  Value innerIV = innerOp.getInductionVar();
+  int64_t step = outerOp.getStep();
+
+  // The rows of a memref accessed in one of the unrolled iterations.
+  using Key = SmallVector<std::pair<const void *, int64_t>, 4>;
+  auto getKey = [&](Value memref, ValueRange indices, unsigned iteration) {
+    Key key{{memref.getAsOpaquePointer(), 0}};
+    for (Value index : indices) {
+      auto decomposed = decomposeIndex(index, outerIV);
+      if (!decomposed) {
+        key.push_back({index.getAsOpaquePointer(), iteration});
+        continue;
+      }
+      int64_t offset = decomposed->second;
+      if (decomposed->first == outerIV)
+        offset += iteration * step;
+      key.push_back({decomposed->first.getAsOpaquePointer(), offset});
+    }
+    return key;
+  };
+
+  std::map<Key, std::pair<unsigned, std::set<Key>>> vectorRows;
+  std::map<Key, unsigned> accumulators;
+  for (unsigned iteration = 0; iteration < factor; iteration++) {
+    innerOp.walk([&](Operation *op) {
+      if (auto readOp = dyn_cast<TransferReadOp>(op)) {
+        VectorType vType = readOp.getVectorType();
+        ValueRange indices = readOp.getIndices();
+        auto &[bits, offsets] =
+            vectorRows[getKey(readOp.getSource(), indices.drop_back(),
+                              iteration)];
+        bits = std::max(bits, unsigned(getVectorSizeInBits(vType)));
+        // Splats of different elements are picked from the same register.
+        if (readOp.getPermutationMap().isConstant())
+          return;
+        auto offset = decomposeIndex(indices.back(), innerIV);
+        offsets.insert(offset ? Key{{offset->first.getAsOpaquePointer(),
+                                     offset->second}}
+                              : Key{{indices.back().getAsOpaquePointer(), 0}});
+      } else if (auto writeOp = dyn_cast<TransferWriteOp>(op)) {
+        VectorType vType = writeOp.getVectorType();
+        accumulators[getKey(writeOp.getSource(), writeOp.getIndices(),
+                            iteration)] =
+            getVectorLaneSize(vType) *
+            getAccumulatorLaneWidth(vType.getElementType());
+      }
+    });
+  }
+
+  unsigned vectorBits = 0, accBits = 0;
+  for (auto &row : vectorRows)
+    vectorBits += row.second.second.size() > 1 ? 2 * row.second.first
+                                               : row.second.first;
+  for (auto &acc : accumulators)
+    accBits += acc.second;
+  return {vectorBits, accBits};
+}
+
+// Returns the factor to unroll and jam `outerOp` by: the largest one, up to
+// `maxFactor`, that divides its trip count and keeps the body of `innerOp`
+// within the register files. Returns 1 if no such factor exists.
+static unsigned getUnrollJamFactor(AffineForOp outerOp, AffineForOp innerOp,
+                                   unsigned maxFactor) {
+  std::optional<uint64_t> tripCount = getConstantTripCount(outerOp);
+  if (!tripCount)
+    return 1;
+  auto [vectorFileBits, accFileBits] = getRegisterFileSizes();
+  for (uint64_t factor = std::min<uint64_t>(maxFactor, *tripCount); factor > 1;
+       factor--) {
+    if (*tripCount % factor != 0)
+      continue;
+    auto [vectorBits, accBits] =
+        estimateRegisterPressure(outerOp, innerOp, factor);
+    if (vectorBits <= vectorFileBits && accBits <= accFileBits)
+      return factor;
+  }
+  return 1;
+}
+
+// Unroll and jam the loops around the innermost loops of `func` that multiply
+// vectors, to issue independent MAC chains back to back. The factor of each
+// loop is the largest that doesn't spill vector or accumulator registers.
+// Returns true if any loop was unrolled.
+static bool unrollAndJamLoopsInFunc(func::FuncOp func, unsigned maxFactor) {
+  SmallVector<std::pair<AffineForOp, unsigned>, 4> loops;
+  func.walk([&](AffineForOp innerOp) {
+    if (!innerOp.getBody()->getOps<AffineForOp>().empty())
+      return;
+    auto outerOp = dyn_cast<AffineForOp>(innerOp->getParentOp());
+    if (!outerOp ||
+        !llvm::hasSingleElement(outerOp.getBody()->getOps<AffineForOp>()) ||
+        !hasVectorMACs(innerOp) || !hasIndependentIterations(outerOp))
+      return;
+    unsigned factor = getUnrollJamFactor(outerOp, innerOp, maxFactor);
+    if (factor > 1)
+      loops.push_back({outerOp, factor});
+  });
+
+  bool changed = false;
+  for (auto [forOp, factor] : loops)
+    changed |= succeeded(loopUnrollJamByFactor(forOp, factor));
+  return changed;
+}
+
 struct AIEVectorize : public AIEVectorizeBase<AIEVectorize> {
   AIEVectorize() = default;
   void runOnOperation() override;
@@ -3003,6 +3300,16 @@ void AIEVectorize::runOnOperation() {
   // Canonicalize the incoming IR, mostly to simplify affine/compose apply ops
   preCanonicalizeIR(module);
 
+  // Unroll and jam the loops around the vectorized loops as far as the
+  // register files allow, and clean up the IR again if anything changed.
+  if (unrollJam) {
+    bool changed = false;
+    for (func::FuncOp func : module.getOps<func::FuncOp>())
+      changed |= unrollAndJamLoopsInFunc(func, maxUnrollJamFactor);
+    if (changed)
+      preCanonicalizeIR(module);
+  }
+
   // Iterate over all the functions in this module, and vectorize them
   for (func::FuncOp func : module.getOps<func::FuncOp>()) {
     // Create a new global state
@@ -3027,6 +3334,13 @@ void AIEVectorize::runOnOperation() {
       return;
     }
 
+    // Check that the AIE ops can read the elements of strided loops.
+    if (failed(hasUnsupportedStrides(func, state))) {
+      func.emitError() << "Cannot apply aie-vectorize to " << func->getName()
+                       << " because of unsupported loop steps.\n";
+      return;
+    }
+
     // Compute the reuse for all the transfer_read operations, and form the
     // initial vector sizes.
     computeReuseInFunc(func, state);
@@ -12,6 +12,8 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <array>
+#include <numeric>
 #include <optional>
 #include <tuple>
 
@@ -23,23 +25,31 @@
 #include "mlir/Conversion/AffineToStandard/AffineToStandard.h"
 #include "mlir/Dialect/Affine/Analysis/LoopAnalysis.h"
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Affine/LoopUtils.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Math/IR/Math.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StructuredOpsUtils.h"
 #include "mlir/Dialect/Vector/Transforms/VectorTransforms.h"
+#include "mlir/IR/Matchers.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/IR/TypeUtilities.h"
 #include "mlir/Pass/PassManager.h"
+#include "mlir/Support/MathExtras.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 #include "mlir/Transforms/Passes.h"
 #include "llvm/ADT/SmallSet.h"
+#include "llvm/ADT/TypeSwitch.h"
 
 #include "FoldMulAddChainToConvOp.h"
 
 namespace xilinx::aievec {
 #define GEN_PASS_DEF_LOWERVECTORTOAIEVEC
 #define GEN_PASS_DEF_CANONICALIZEFORAIEVEC
+#define GEN_PASS_DEF_LEGALIZEVECTORFORAIEVEC
+#define GEN_PASS_DEF_LOWERVECTORMATHTOAIEVEC
 #define GEN_PASS_DEF_REDUNDANTLOADSTOREOPTIMIZATION
 #define GEN_PASS_DEF_AIEVECTRANSFORMATION
 #define GEN_PASS_DEF_AIEVECCONVOPTRANSFORMATION
@@ -88,6 +98,57 @@ extractMACOperandsFromAddOperands(Value addLhs, Value addRhs) {
   return std::make_tuple(mulOp.getLhs(), mulOp.getRhs(), acc);
 }
 
+// If `v` is the result of an `arith.extsi` or `arith.extf`, return the value
+// being extended. Otherwise, return `v`.
+static Value getSourceOfExtension(Value v) {
+  auto defOp = v.getDefiningOp();
+  if (isa_and_nonnull<arith::ExtSIOp, arith::ExtFOp>(defOp))
+    return defOp->getOperand(0);
+  return v;
+}
+
+// Returns the (M, K, N) shape of the AIE-ML matrix-multiply intrinsics for
+// operands of type `elemType`, or std::nullopt if there isn't one.
+static std::optional<std::array<int64_t, 3>>
+getMatMulOpShape(Type elemType) {
+  if (elemType.isInteger(8) || elemType.isBF16())
+    return std::array<int64_t, 3>{4, 8, 4};
+  if (elemType.isInteger(16))
+    return std::array<int64_t, 3>{4, 4, 4};
+  return std::nullopt;
+}
+
+// Returns the element type of the accumulator of the AIE-ML matrix-multiply
+// intrinsics for operands of type `elemType`.
+static Type getMatMulOpAccElemType(Type elemType) {
+  if (elemType.isBF16())
+    return FloatType::getF32(elemType.getContext());
+  if (elemType.isInteger(8))
+    return IntegerType::get(elemType.getContext(), 32);
+  return IntegerType::get(elemType.getContext(), 64);
+}
+
+// If `contractOp` is a row-major matrix-multiply, with (possibly extended)
+// operands and an accumulator of the types of an AIE-ML matrix-multiply
+// intrinsic, return the (M, K, N) shape of the intrinsic. The shape of
+// `contractOp` itself may be a multiple of it.
+static std::optional<std::array<int64_t, 3>>
+getMatMulTileShape(vector::ContractionOp contractOp) {
+  if (contractOp.getKind() != vector::CombiningKind::ADD ||
+      !isRowMajorMatmul(contractOp.getIndexingMaps()))
+    return std::nullopt;
+  auto accType = dyn_cast<VectorType>(contractOp.getAccType());
+  if (!accType)
+    return std::nullopt;
+  Type elemType = getElementTypeOrSelf(
+      getSourceOfExtension(contractOp.getLhs()).getType());
+  if (elemType != getElementTypeOrSelf(
+                      getSourceOfExtension(contractOp.getRhs()).getType()) ||
+      accType.getElementType() != getMatMulOpAccElemType(elemType))
+    return std::nullopt;
+  return getMatMulOpShape(elemType);
+}
+
 //===----------------------------------------------------------------------===//
 // Analyses
 //===----------------------------------------------------------------------===//
@@ -122,6 +183,196 @@ struct UPDOpEffectiveAccessSizeAnalysis {
   unsigned effectiveSize;
 };
 
+// Inclusive range of the values that an index can take.
+using IndexRange = std::pair<int64_t, int64_t>;
+
+static std::optional<IndexRange>
+getIndexRange(Value value, const DenseMap<Value, IndexRange> &knownRanges);
+
+// Computes the range of `expr`, given the ranges of its dims and symbols.
+static std::optional<IndexRange>
+getAffineExprRange(AffineExpr expr,
+                   ArrayRef<std::optional<IndexRange>> operandRanges,
+                   unsigned numDims) {
+  if (auto cstExpr = expr.dyn_cast<AffineConstantExpr>())
+    return IndexRange(cstExpr.getValue(), cstExpr.getValue());
+  if (auto dimExpr = expr.dyn_cast<AffineDimExpr>())
+    return operandRanges[dimExpr.getPosition()];
+  if (auto symExpr = expr.dyn_cast<AffineSymbolExpr>())
+    return operandRanges[numDims + symExpr.getPosition()];
+
+  auto binExpr = expr.cast<AffineBinaryOpExpr>();
+  auto lhs = getAffineExprRange(binExpr.getLHS(), operandRanges, numDims);
+  auto rhs = getAffineExprRange(binExpr.getRHS(), operandRanges, numDims);
+  if (!lhs || !rhs)
+    return std::nullopt;
+  int64_t lo = lhs->first, hi = lhs->second;
+  switch (expr.getKind()) {
+  case AffineExprKind::Add:
+    return IndexRange(lo + rhs->first, hi + rhs->second);
+  case AffineExprKind::Mul: {
+    // One of the sides of a product is always constant in affine expressions.
+    if (lo == hi)
+      std::swap(lhs, rhs);
+    if (rhs->first != rhs->second)
+      return std::nullopt;
+    int64_t c = rhs->first;
+    return c >= 0 ? IndexRange(lhs->first * c, lhs->second * c)
+                  : IndexRange(lhs->second * c, lhs->first * c);
+  }
+  case AffineExprKind::FloorDiv:
+  case AffineExprKind::CeilDiv:
+  case AffineExprKind::Mod: {
+    int64_t c = rhs->first;
+    if (c != rhs->second || c <= 0)
+      return std::nullopt;
+    if (expr.getKind() == AffineExprKind::FloorDiv)
+      return IndexRange(floorDiv(lo, c), floorDiv(hi, c));
+    if (expr.getKind() == AffineExprKind::CeilDiv)
+      return IndexRange(ceilDiv(lo, c), ceilDiv(hi, c));
+    if (lo >= 0 && floorDiv(lo, c) == floorDiv(hi, c))
+      return IndexRange(lo % c, hi % c);
+    return IndexRange(0, c - 1);
+  }
+  default:
+    return std::nullopt;
+  }
+}
+
+// Computes the range of every result of `map` applied to `operands`, and
+// combines them with `combine` (e.g., to get the range of an `affine.min`).
+template <typename CombineFn>
+static std::optional<IndexRange>
+getAffineMapRange(AffineMap map, ValueRange operands,
+                  const DenseMap<Value, IndexRange> &knownRanges,
+                  CombineFn combine) {
+  SmallVector<std::optional<IndexRange>> operandRanges;
+  for (Value operand : operands)
+    operandRanges.push_back(getIndexRange(operand, knownRanges));
+  std::optional<IndexRange> range;
+  for (AffineExpr expr : map.getResults()) {
+    auto exprRange =
+        getAffineExprRange(expr, operandRanges, map.getNumDims());
+    if (!exprRange)
+      return std::nullopt;
+    range = range ? combine(*range, *exprRange) : *exprRange;
+  }
+  return range;
+}
+
+// Computes the range of the values that the index `value` can take, or
+// std::nullopt if it can't be bounded. The range of the induction variables of
+// affine loops with constant bounds follows from their bounds, unless
+// `knownRanges` provides a tighter one.
+static std::optional<IndexRange>
+getIndexRange(Value value, const DenseMap<Value, IndexRange> &knownRanges) {
+  auto known = knownRanges.find(value);
+  if (known != knownRanges.end())
+    return known->second;
+
+  APInt cst;
+  if (matchPattern(value, m_ConstantInt(&cst)))
+    return IndexRange(cst.getSExtValue(), cst.getSExtValue());
+
+  if (AffineForOp forOp = getForInductionVarOwner(value)) {
+    if (!forOp.hasConstantBounds())
+      return std::nullopt;
+    int64_t lb = forOp.getConstantLowerBound();
+    int64_t ub = forOp.getConstantUpperBound();
+    if (ub <= lb)
+      return std::nullopt;
+    int64_t step = forOp.getStep();
+    return IndexRange(lb, lb + (ub - lb - 1) / step * step);
+  }
+
+  Operation *defOp = value.getDefiningOp();
+  if (!defOp)
+    return std::nullopt;
+  if (auto applyOp = dyn_cast<AffineApplyOp>(defOp))
+    return getAffineMapRange(applyOp.getAffineMap(), applyOp.getMapOperands(),
+                             knownRanges,
+                             [](IndexRange a, IndexRange) { return a; });
+  if (auto minOp = dyn_cast<AffineMinOp>(defOp))
+    return getAffineMapRange(
+        minOp.getMap(), minOp.getMapOperands(), knownRanges,
+        [](IndexRange a, IndexRange b) {
+          return IndexRange(std::min(a.first, b.first),
+                            std::min(a.second, b.second));
+        });
+  if (auto maxOp = dyn_cast<AffineMaxOp>(defOp))
+    return getAffineMapRange(
+        maxOp.getMap(), maxOp.getMapOperands(), knownRanges,
+        [](IndexRange a, IndexRange b) {
+          return IndexRange(std::max(a.first, b.first),
+                            std::max(a.second, b.second));
+        });
+  if (isa<arith::AddIOp, arith::SubIOp>(defOp)) {
+    auto lhs = getIndexRange(defOp->getOperand(0), knownRanges);
+    auto rhs = getIndexRange(defOp->getOperand(1), knownRanges);
+    if (!lhs || !rhs)
+      return std::nullopt;
+    if (isa<arith::AddIOp>(defOp))
+      return IndexRange(lhs->first + rhs->first, lhs->second + rhs->second);
+    return IndexRange(lhs->first - rhs->second, lhs->second - rhs->first);
+  }
+  return std::nullopt;
+}
+
+// Returns true if dimension `dim` of the vector accessed by a transfer op is
+// proven to be within the bounds of the memref, given the ranges of the
+// indices. Broadcast dimensions are always in bounds.
+template <typename TransferOp>
+static bool
+isTransferDimInBounds(TransferOp op, unsigned dim,
+                      const DenseMap<Value, IndexRange> &knownRanges = {}) {
+  AffineExpr expr = op.getPermutationMap().getResult(dim);
+  if (expr.template isa<AffineConstantExpr>())
+    return true;
+  unsigned memDim = expr.template cast<AffineDimExpr>().getPosition();
+  auto memRefType = op.getSource().getType().template cast<MemRefType>();
+  if (memRefType.isDynamicDim(memDim))
+    return false;
+  auto range = getIndexRange(op.getIndices()[memDim], knownRanges);
+  if (!range)
+    return false;
+  int64_t vecDimSize = op.getVectorType().getDimSize(dim);
+  return range->first >= 0 &&
+         range->second + vecDimSize <= memRefType.getDimSize(memDim);
+}
+
+// Returns true if every dimension of the vector accessed by a transfer op,
+// other than the broadcast ones, is marked in bounds.
+template <typename TransferOp> static bool allDimsInBounds(TransferOp op) {
+  for (unsigned dim = 0, e = op.getTransferRank(); dim < e; ++dim) {
+    AffineExpr expr = op.getPermutationMap().getResult(dim);
+    if (!op.isDimInBounds(dim) && !expr.template isa<AffineConstantExpr>())
+      return false;
+  }
+  return true;
+}
+
+// Returns the in_bounds value of each dimension of a transfer op.
+template <typename TransferOp>
+static SmallVector<bool, 4>
+computeTransferInBounds(TransferOp op,
+                        const DenseMap<Value, IndexRange> &knownRanges = {}) {
+  SmallVector<bool, 4> inBounds;
+  for (unsigned dim = 0, e = op.getTransferRank(); dim < e; ++dim)
+    inBounds.push_back(isTransferDimInBounds(op, dim, knownRanges));
+  return inBounds;
+}
+
+// Marks the dimensions of a transfer op that are proven to be in bounds. Used
+// on the transfer ops created by rewrites, which would otherwise lose what was
+// inferred for the ops they replace.
+template <typename TransferOp>
+static void setTransferInBounds(TransferOp op, OpBuilder &builder) {
+  SmallVector<bool, 4> inBounds = computeTransferInBounds(op);
+  if (llvm::none_of(inBounds, [](bool inBounds) { return inBounds; }))
+    return;
+  op->setAttr(op.getInBoundsAttrName(), builder.getBoolArrayAttr(inBounds));
+}
+
 //===----------------------------------------------------------------------===//
 // Lowering patterns
 //===----------------------------------------------------------------------===//
@@ -283,6 +534,34 @@ struct ConvertMulAddToAIEVecFMAElemOpPattern
   unsigned shiftParam;
 };
 
+// This pattern replaces a `vector.contract` computing a matrix-multiply tile
+// with `aievec.matmul`. The extensions of the operands, if any, are folded
+// into the op. This pattern works for aie-ml.
+struct LowerVectorContractionOpToAIEVecMatMulPattern
+    : public OpConversionPattern<vector::ContractionOp> {
+  using OpConversionPattern<vector::ContractionOp>::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(vector::ContractionOp contractOp, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto tileShape = getMatMulTileShape(contractOp);
+    if (!tileShape)
+      return failure();
+
+    Value lhs = getSourceOfExtension(adaptor.getLhs());
+    Value rhs = getSourceOfExtension(adaptor.getRhs());
+    auto lhsShape = cast<VectorType>(lhs.getType()).getShape();
+    auto rhsShape = cast<VectorType>(rhs.getType()).getShape();
+    auto [M, K, N] = *tileShape;
+    if (lhsShape[0] != M || lhsShape[1] != K || rhsShape[1] != N)
+      return failure();
+
+    rewriter.replaceOpWithNewOp<aievec::MatMulOp>(
+        contractOp, contractOp.getResultType(), lhs, rhs, adaptor.getAcc());
+    return success();
+  }
+};
+
 // This pattern replaces `arith.mulf` on vectors with
 // `aievec.mul_elem`. This pattern works for aie-ml.
 struct ConvertMulFToAIEVecMulElemOpPattern
@@ -528,6 +807,7 @@ struct SplitUnalignedTransferReadPattern
     auto newReadOp = rewriter.create<vector::TransferReadOp>(
         readOp.getLoc(), longVecTy, adaptor.getSource(), alignedIdx,
         adaptor.getPadding());
+    setTransferInBounds(newReadOp, rewriter);
 
     // Create a `vector.extract_strided_slice` to extract the unaligned vector.
     rewriter.replaceOpWithNewOp<vector::ExtractStridedSliceOp>(
@@ -584,6 +864,7 @@ struct ConvertSplatTransferReadToBroadcastPattern
     auto newReadOp = rewriter.create<vector::TransferReadOp>(
         readOp.getLoc(), readOp.getVector().getType(), adaptor.getSource(),
         indices, adaptor.getPadding());
+    setTransferInBounds(newReadOp, rewriter);
     auto extractOp = rewriter.create<vector::ExtractOp>(
         readOp.getLoc(), newReadOp.getResult(), ArrayRef<int64_t>{offset});
     rewriter.replaceOpWithNewOp<vector::BroadcastOp>(
@@ -801,6 +1082,13 @@ struct LowerVectorTransferReadToAIEUPD
     if (readOp.getMask())
       return readOp.emitError() << "AIE doesn't support masked loads.";
 
+    // Only loads that are known to stay within the buffer can be full-width
+    // UPDs. The others, e.g., in the epilogue of a ragged loop or indexed by
+    // values of unknown range, are left to the standard lowering, which masks
+    // them.
+    if (!allDimsInBounds(readOp))
+      return failure();
+
     // Non-contiguous loads
     AffineMap map = readOp.getPermutationMap();
     if (!map.isMinorIdentity())
@@ -1489,6 +1777,86 @@ struct LowerVectorReductionOp
   }
 };
 
+// Returns true if `scanOp` is an inclusive or exclusive prefix sum of a
+// register-sized integer vector, which can be computed on aie-ml with a
+// sequence of shifts and lane-wise additions.
+static bool isAIEVecScanOp(vector::ScanOp scanOp) {
+  VectorType vType = scanOp.getSourceType();
+  if (scanOp.getKind() != vector::CombiningKind::ADD || vType.getRank() != 1)
+    return false;
+  Type scalarType = vType.getElementType();
+  if (!isa<IntegerType>(scalarType))
+    return false;
+  unsigned elWidth = scalarType.getIntOrFloatBitWidth();
+  return (elWidth == 8 || elWidth == 16 || elWidth == 32) &&
+         getVectorLaneSize(vType) * elWidth == 512;
+}
+
+// This pattern replaces `vector.scan` with a log-step prefix sum: at step k,
+// every lane adds the value of the lane 2^k lanes before it, which is brought
+// in by shifting the vector against a vector of zeros. This pattern works for
+// aie-ml.
+struct LowerVectorScanOpToAIEVecOps
+    : public OpConversionPattern<vector::ScanOp> {
+  using OpConversionPattern<vector::ScanOp>::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(vector::ScanOp scanOp, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (!isAIEVecScanOp(scanOp))
+      return failure();
+
+    Location loc = scanOp.getLoc();
+    VectorType vType = scanOp.getSourceType();
+    Type scalarType = vType.getElementType();
+    unsigned elWidth = scalarType.getIntOrFloatBitWidth();
+    int laneSize = getVectorLaneSize(vType);
+
+    auto zeroOp = rewriter.create<arith::ConstantOp>(
+        loc, rewriter.getIntegerAttr(scalarType, 0));
+    auto zeroVecOp =
+        rewriter.create<aievec::BroadcastScalarOp>(loc, vType, zeroOp);
+
+    // Shifts `value` towards the higher lanes by `lanes` lanes, filling the
+    // lower lanes with zeros.
+    auto shiftLanes = [&](Value value, int lanes) -> Value {
+      auto constOp = rewriter.create<arith::ConstantOp>(
+          loc, rewriter.getI32IntegerAttr((laneSize - lanes) * elWidth / 8));
+      return rewriter.create<aievec::ShiftOp>(loc, vType, zeroVecOp, value,
+                                              constOp.getResult());
+    };
+
+    Value destValue = adaptor.getSource();
+    for (int lanes = 1; lanes < laneSize; lanes *= 2)
+      destValue = rewriter.create<aievec::AddElemOp>(
+          loc, vType, destValue, shiftLanes(destValue, lanes));
+
+    // As in the upstream lowering of `vector.scan`, the initial value only
+    // takes part in exclusive scans, where it is the first lane and is added
+    // to every other one.
+    if (!scanOp.getInclusive()) {
+      Value exclValue = shiftLanes(destValue, 1);
+      auto initOp = rewriter.create<vector::ExtractElementOp>(
+          loc, adaptor.getInitialValue());
+      auto initVecOp =
+          rewriter.create<aievec::BroadcastScalarOp>(loc, vType, initOp);
+      destValue =
+          rewriter.create<aievec::AddElemOp>(loc, vType, exclValue, initVecOp);
+    }
+
+    // The accumulated value is the one in the last lane.
+    auto lastLaneOp = rewriter.create<arith::ConstantOp>(
+        loc, rewriter.getI32IntegerAttr(laneSize - 1));
+    auto extElemOp = rewriter.create<aievec::ExtElemOp>(
+        loc, scalarType, destValue, lastLaneOp.getResult());
+    auto accOp = rewriter.create<vector::BroadcastOp>(
+        loc, scanOp.getAccumulatedValue().getType(), extElemOp);
+
+    rewriter.replaceOp(scanOp, {destValue, accOp.getResult()});
+    return success();
+  }
+};
+
 // If a UPD op is loading a vector twice the size of the architecture
 // vector size, split it into a high and low load into the accumulator.
 // TODO: This is a process we may want to include as part of the
@@ -1521,6 +1889,10 @@ struct SplitUPDOpOnAccPattern : public OpConversionPattern<aievec::UPDOp> {
   int32_t maxVectorSize;
 };
 
+// Set the dimensions of a `vector.transfer_read` or `vector.transfer_write`
+// that are proven to be accessed within the bounds of the memref as
+// "in bounds". The dimensions that can't be proven are left out of bounds, so
+// that their accesses are masked when lowered.
 template <typename OpTy>
 struct SetInboundsToReadStoreOpPattern : public RewritePattern {
   SetInboundsToReadStoreOpPattern(MLIRContext *context)
@@ -1530,14 +1902,14 @@ struct SetInboundsToReadStoreOpPattern : public RewritePattern {
                                 PatternRewriter &rewriter) const override {
     OpTy writeOrReadOp = cast<OpTy>(op);
 
-    // TODO: We are currently setting all `vector.transfer_read` and
-    // TODO: `vector.transfer_write` as "in bounds". We need to add
-    // TODO: an analysis to verify that this is true before doing so.
     if (writeOrReadOp.getInBounds() || writeOrReadOp.getTransferRank() == 0) {
       return failure();
     }
 
-    SmallVector<bool, 4> bools(writeOrReadOp.getTransferRank(), true);
+    SmallVector<bool, 4> bools = computeTransferInBounds(writeOrReadOp);
+    if (llvm::none_of(bools, [](bool inBounds) { return inBounds; }))
+      return failure();
+
     auto inBoundsAttr = rewriter.getBoolArrayAttr(bools);
     rewriter.updateRootInPlace(writeOrReadOp, [&]() {
       writeOrReadOp->setAttr(writeOrReadOp.getInBoundsAttrName(), inBoundsAttr);
@@ -1622,8 +1994,9 @@ static void populateAIEVecV2ConversionPatterns(RewritePatternSet &patterns,
       LowerVectorSelectOpToAIEVecSelOp, LowerVectorReductionOp,
       FoldVectorExtractAndBroadcastToAIEBroadcast,
       ConvertMulAddToAIEVecFMAElemOpPattern,
-      ConvertMulIToAIEVecMulElemOpPattern, ConvertMulFToAIEVecMulElemOpPattern>(
-      patterns.getContext());
+      ConvertMulIToAIEVecMulElemOpPattern, ConvertMulFToAIEVecMulElemOpPattern,
+      LowerVectorContractionOpToAIEVecMatMulPattern,
+      LowerVectorScanOpToAIEVecOps>(patterns.getContext());
 }
 
 static void
@@ -1645,7 +2018,8 @@ populateAIEVecV2TransformationPatterns(RewritePatternSet &patterns) {
 static void configureAIEVecCommonLegalizations(ConversionTarget &target,
                                                AnalysisManager &am) {
   target.addLegalDialect<xilinx::aievec::AIEVecDialect, arith::ArithDialect>();
-  target.addIllegalOp<vector::TransferReadOp>();
+  target.addDynamicallyLegalOp<vector::TransferReadOp>(
+      [](vector::TransferReadOp op) { return !allDimsInBounds(op); });
   target.addDynamicallyLegalOp<arith::AddIOp>(
       [](arith::AddIOp op) { return !isa<VectorType>(op.getType()); });
   target.addDynamicallyLegalOp<arith::AddFOp>(
@@ -1739,6 +2113,13 @@ static void configureAIEVecV2Legalizations(ConversionTarget &target,
     if (!resultType) {
       return true;
     }
+    // A bfloat16 mul add is left for the convolution folding.
+    auto isMulOp = [](Value v) {
+      return isa_and_nonnull<arith::MulFOp>(v.getDefiningOp());
+    };
+    if (resultType.getElementType().isBF16() &&
+        (isMulOp(op.getLhs()) || isMulOp(op.getRhs())))
+      return true;
     unsigned laneSize = getVectorLaneSize(resultType);
     return laneSize != 16;
   });
@@ -1914,6 +2295,20 @@ static void configureAIEVecV2Legalizations(ConversionTarget &target,
 
         return false;
       });
+
+  target.addDynamicallyLegalOp<vector::ScanOp>(
+      [](vector::ScanOp op) { return !isAIEVecScanOp(op); });
+
+  target.addDynamicallyLegalOp<vector::ContractionOp>(
+      [](vector::ContractionOp op) {
+        auto tileShape = getMatMulTileShape(op);
+        if (!tileShape)
+          return true;
+        auto [M, K, N] = *tileShape;
+        ArrayRef<int64_t> lhsShape = op.getLhsType().getShape();
+        ArrayRef<int64_t> rhsShape = op.getRhsType().getShape();
+        return lhsShape[0] != M || lhsShape[1] != K || rhsShape[1] != N;
+      });
 }
 
 static bool singleColumnFMAOpCanFold(aievec::FMAOp fmaOp) {
@@ -1953,13 +2348,9 @@ configureAIEVecV2TransformationLegalizations(ConversionTarget &target) {
 // Lowering passes
 //===----------------------------------------------------------------------===//
 
-// TODO: For more complex conversion from Vector to AIEVec, we may want to
-// make
-// TODO: this into a pipeline where:
-// TODO:     1. If the operands of a vector op are too long, split it down to
-// TODO:        right-sized vectors.
-// TODO:     2. Unroll vector ops when the vector type is unsupported.
-// TODO:     3. Perform the dialect conversion legalizations.
+// Vector ops that are too long, or that have an unsupported element type,
+// have already been unrolled by `LegalizeVectorForAIEVec` by the time this
+// pass runs in the "convert-vector-to-aievec" pipeline.
 struct LowerVectorToAIEVec
     : public aievec::impl::LowerVectorToAIEVecBase<LowerVectorToAIEVec> {
   using Base::Base;
@@ -2083,6 +2474,650 @@ void CanonicalizeForAIEVecPass::runOnOperation() {
   }
 }
 
+// Widest vector, in bits, that the conversion to AIEVec handles: a full
+// register on AIE-ML, and a pair of registers loaded with two UPD ops on AIE.
+static constexpr unsigned maxVectorSizeInBits = 1024;
+
+// Returns true if the target has vector registers and operations for elements
+// of type `type`, including the element types of accumulators.
+static bool isSupportedElementType(Type type, AIEArch aieVersion) {
+  if (auto intType = dyn_cast<IntegerType>(type)) {
+    unsigned width = intType.getWidth();
+    if (aieVersion == AIEArch::AIE)
+      return width == 8 || width == 16 || width == 32 || width == 48 ||
+             width == 80;
+    return width == 8 || width == 16 || width == 32 || width == 64;
+  }
+  if (type.isF32())
+    return true;
+  return aieVersion == AIEArch::AIE_ML && type.isBF16();
+}
+
+// If `op` is a matrix-multiply that can be lowered to the AIE-ML
+// matrix-multiply intrinsics, return the iteration shape of the intrinsic,
+// i.e., [M, N, K]. If `op` produces an operand of one, or stores its result,
+// return the shape of that operand in a single intrinsic. Otherwise, return
+// std::nullopt.
+static std::optional<SmallVector<int64_t>>
+getMatMulOperandTileShape(Operation *op) {
+  if (auto contractOp = dyn_cast<vector::ContractionOp>(op)) {
+    auto tileShape = getMatMulTileShape(contractOp);
+    if (!tileShape)
+      return std::nullopt;
+    auto [M, K, N] = *tileShape;
+    return SmallVector<int64_t>{M, N, K};
+  }
+
+  if (auto writeOp = dyn_cast<vector::TransferWriteOp>(op)) {
+    auto contractOp =
+        writeOp.getVector().getDefiningOp<vector::ContractionOp>();
+    if (!contractOp)
+      return std::nullopt;
+    auto tileShape = getMatMulTileShape(contractOp);
+    if (!tileShape)
+      return std::nullopt;
+    auto [M, K, N] = *tileShape;
+    return SmallVector<int64_t>{M, N};
+  }
+
+  if (op->getNumResults() != 1 ||
+      !(isa<vector::TransferReadOp>(op) ||
+        OpTrait::hasElementwiseMappableTraits(op)))
+    return std::nullopt;
+  auto resultType = dyn_cast<VectorType>(op->getResult(0).getType());
+  if (!resultType || resultType.getRank() != 2)
+    return std::nullopt;
+
+  for (OpOperand &use : op->getResult(0).getUses()) {
+    OpOperand *operand = &use;
+    Operation *user = operand->getOwner();
+    // Look through the extension of the operands.
+    if (isa<arith::ExtSIOp, arith::ExtFOp>(user) && user->hasOneUse()) {
+      operand = &*user->getUses().begin();
+      user = operand->getOwner();
+    }
+    auto contractOp = dyn_cast<vector::ContractionOp>(user);
+    if (!contractOp)
+      continue;
+    auto tileShape = getMatMulTileShape(contractOp);
+    if (!tileShape)
+      continue;
+    auto [M, K, N] = *tileShape;
+    switch (operand->getOperandNumber()) {
+    case 0:
+      return SmallVector<int64_t>{M, K};
+    case 1:
+      return SmallVector<int64_t>{K, N};
+    case 2:
+      return SmallVector<int64_t>{M, N};
+    }
+  }
+  return std::nullopt;
+}
+
+// Returns the shape `op` must be unrolled to so that every vector it reads or
+// produces fits in `maxVectorSizeInBits` and has a supported element type, or
+// std::nullopt if it doesn't need to be unrolled. Vectors with an unsupported
+// element type are unrolled down to a single element, and vectors that are
+// too long are split into the largest slices that divide them evenly. Masks
+// (i.e. vectors of i1) follow the shape of the data they apply to.
+static std::optional<SmallVector<int64_t>>
+getNativeVectorShape(Operation *op, AIEArch aieVersion) {
+  // Matrix-multiplies are split into tiles of the shape of the AIE-ML
+  // matrix-multiply intrinsics, and the operands and results of those tiles
+  // follow the same shape.
+  if (aieVersion == AIEArch::AIE_ML) {
+    if (auto tileShape = getMatMulOperandTileShape(op))
+      return tileShape;
+  }
+
+  if (!isa<vector::TransferReadOp, vector::TransferWriteOp,
+           vector::ReductionOp>(op) &&
+      !OpTrait::hasElementwiseMappableTraits(op))
+    return std::nullopt;
+
+  VectorType vecType;
+  unsigned elementWidth = 0;
+  bool supported = true;
+  bool hasF32 = false;
+  auto visitType = [&](Type type) {
+    auto typeAsVec = dyn_cast<VectorType>(type);
+    if (!typeAsVec || typeAsVec.getElementType().isInteger(1))
+      return;
+    Type elementType = typeAsVec.getElementType();
+    vecType = typeAsVec;
+    if (!elementType.isIntOrFloat()) {
+      supported = false;
+      return;
+    }
+    elementWidth = std::max(elementWidth, elementType.getIntOrFloatBitWidth());
+    supported &= isSupportedElementType(elementType, aieVersion);
+    hasF32 |= elementType.isF32();
+  };
+  for (Type type : op->getOperandTypes())
+    visitType(type);
+  for (Type type : op->getResultTypes())
+    visitType(type);
+  if (!vecType || vecType.getRank() == 0)
+    return std::nullopt;
+
+  // The float datapath of AIE-ML, accumulators included, is 16 lanes wide.
+  int64_t lanes = 1;
+  if (supported)
+    lanes = aieVersion == AIEArch::AIE_ML && hasF32
+                ? 16
+                : maxVectorSizeInBits / elementWidth;
+  // Dimensions are kept whole from the innermost one outwards, for as long as
+  // they fit in a register. The first one that doesn't fit is split, and the
+  // ones outside of it are unrolled.
+  ArrayRef<int64_t> shape = vecType.getShape();
+  SmallVector<int64_t> nativeShape(shape.size(), 1);
+  for (int64_t dim = shape.size() - 1; dim >= 0; --dim) {
+    int64_t size = shape[dim];
+    if (size > lanes) {
+      nativeShape[dim] = std::gcd(size, lanes);
+      break;
+    }
+    nativeShape[dim] = size;
+    if (lanes % size != 0)
+      break;
+    lanes /= size;
+  }
+  if (ArrayRef<int64_t>(nativeShape) == shape)
+    return std::nullopt;
+  return nativeShape;
+}
+
+// Returns the kind of reduction `op` computes, if `op` is a `vector.reduction`
+// or an arith op that combines two partial reductions.
+static std::optional<vector::CombiningKind>
+getReductionCombiningKind(Operation *op) {
+  if (auto reductionOp = dyn_cast<vector::ReductionOp>(op))
+    return reductionOp.getKind();
+  return TypeSwitch<Operation *, std::optional<vector::CombiningKind>>(op)
+      .Case<arith::AddIOp, arith::AddFOp>(
+          [](auto) { return vector::CombiningKind::ADD; })
+      .Case<arith::MulIOp, arith::MulFOp>(
+          [](auto) { return vector::CombiningKind::MUL; })
+      .Case<arith::MinSIOp>([](auto) { return vector::CombiningKind::MINSI; })
+      .Case<arith::MinUIOp>([](auto) { return vector::CombiningKind::MINUI; })
+      .Case<arith::MinFOp>([](auto) { return vector::CombiningKind::MINF; })
+      .Case<arith::MaxSIOp>([](auto) { return vector::CombiningKind::MAXSI; })
+      .Case<arith::MaxUIOp>([](auto) { return vector::CombiningKind::MAXUI; })
+      .Case<arith::MaxFOp>([](auto) { return vector::CombiningKind::MAXF; })
+      .Default([](Operation *) { return std::nullopt; });
+}
+
+// Collects in `vectors` the vectors whose `kind` reductions are combined to
+// produce `value`, which must be computed in `body` from them and from
+// `iterArg` alone. Returns false if `value` is computed in any other way, or
+// if any of the partial results has other uses.
+static bool collectReducedVectors(Value value, BlockArgument iterArg,
+                                  vector::CombiningKind kind, Block *body,
+                                  SmallVectorImpl<Value> &vectors,
+                                  unsigned &numIterArgUses) {
+  if (value == iterArg) {
+    numIterArgUses++;
+    return true;
+  }
+  Operation *defOp = value.getDefiningOp();
+  if (!defOp || defOp->getBlock() != body || !value.hasOneUse() ||
+      getReductionCombiningKind(defOp) != kind)
+    return false;
+  if (auto reductionOp = dyn_cast<vector::ReductionOp>(defOp)) {
+    vectors.push_back(reductionOp.getVector());
+    if (Value acc = reductionOp.getAcc())
+      return collectReducedVectors(acc, iterArg, kind, body, vectors,
+                                   numIterArgUses);
+    return true;
+  }
+  return collectReducedVectors(defOp->getOperand(0), iterArg, kind, body,
+                               vectors, numIterArgUses) &&
+         collectReducedVectors(defOp->getOperand(1), iterArg, kind, body,
+                               vectors, numIterArgUses);
+}
+
+static AffineForOp createLoopWithIterArgs(PatternRewriter &rewriter,
+                                          AffineForOp forOp,
+                                          ValueRange iterArgs) {
+  return rewriter.create<AffineForOp>(
+      forOp.getLoc(), forOp.getLowerBoundOperands(), forOp.getLowerBoundMap(),
+      forOp.getUpperBoundOperands(), forOp.getUpperBoundMap(),
+      forOp.getStep(), iterArgs);
+}
+
+static scf::ForOp createLoopWithIterArgs(PatternRewriter &rewriter,
+                                         scf::ForOp forOp,
+                                         ValueRange iterArgs) {
+  return rewriter.create<scf::ForOp>(forOp.getLoc(), forOp.getLowerBound(),
+                                     forOp.getUpperBound(), forOp.getStep(),
+                                     iterArgs);
+}
+
+// This pattern rewrites a scalar reduction carried across the iterations of
+// a loop, e.g.:
+//    %r = affine.for %i = 0 to 256 step 16 iter_args(%acc = %init) -> f32 {
+//      ...
+//      %s = vector.reduction <add>, %v, %acc : vector<16xf32> into f32
+//      affine.yield %s : f32
+//    }
+// so that the partial results are accumulated lane-wise in a vector carried
+// across the iterations instead, and only reduced once, after the loop:
+//    %r:2 = affine.for %i = 0 to 256 step 16
+//        iter_args(%acc = %init, %vacc = %zero) -> (f32, vector<16xf32>) {
+//      ...
+//      %s = arith.addf %vacc, %v : vector<16xf32>
+//      affine.yield %acc, %s : f32, vector<16xf32>
+//    }
+//    %0 = vector.reduction <add>, %r#1 : vector<16xf32> into f32
+//    %1 = arith.addf %0, %init : f32
+// The partial results may come from several reductions, e.g., after a
+// reduction on a wide vector has been unrolled, as long as all of them reduce
+// vectors of the same type.
+template <typename LoopOpTy>
+struct AccumulateLoopCarriedReductionPattern
+    : public OpRewritePattern<LoopOpTy> {
+  using OpRewritePattern<LoopOpTy>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(LoopOpTy forOp,
+                                PatternRewriter &rewriter) const override {
+    Block *body = forOp.getBody();
+    Operation *yieldOp = body->getTerminator();
+    for (unsigned i = 0; i < forOp.getNumIterOperands(); ++i) {
+      BlockArgument iterArg = forOp.getRegionIterArgs()[i];
+      Value yielded = yieldOp->getOperand(i);
+      Operation *defOp = yielded.getDefiningOp();
+      if (!defOp || !iterArg.hasOneUse())
+        continue;
+      auto kind = getReductionCombiningKind(defOp);
+      if (!kind)
+        continue;
+
+      SmallVector<Value> vectors;
+      unsigned numIterArgUses = 0;
+      if (!collectReducedVectors(yielded, iterArg, *kind, body, vectors,
+                                 numIterArgUses) ||
+          numIterArgUses != 1 || vectors.empty())
+        continue;
+      auto vecType = cast<VectorType>(vectors.front().getType());
+      if (vecType.getRank() != 1 ||
+          llvm::any_of(vectors,
+                       [&](Value v) { return v.getType() != vecType; }))
+        continue;
+
+      rewriteLoop(rewriter, forOp, i, *kind, vectors, vecType);
+      return success();
+    }
+    return failure();
+  }
+
+  // Accumulates `vectors` in a new vector iter_arg of `forOp`, and replaces
+  // its `i`-th result with the reduction of the final value of that vector.
+  static void rewriteLoop(PatternRewriter &rewriter, LoopOpTy forOp,
+                          unsigned i, vector::CombiningKind kind,
+                          ArrayRef<Value> vectors, VectorType vecType) {
+    Location loc = forOp.getLoc();
+    Value init = forOp.getIterOperands()[i];
+
+    // Min and max are idempotent, so the initial value can be accumulated
+    // in every lane. The other kinds start from their identity instead, and
+    // the initial value is folded in after the loop. E.g., a xor of the
+    // initial value in every lane would cancel out for an even lane count.
+    bool isMinMax = false;
+    int64_t identity = 0;
+    switch (kind) {
+    case vector::CombiningKind::MINUI:
+    case vector::CombiningKind::MINSI:
+    case vector::CombiningKind::MINF:
+    case vector::CombiningKind::MAXUI:
+    case vector::CombiningKind::MAXSI:
+    case vector::CombiningKind::MAXF:
+      isMinMax = true;
+      break;
+    case vector::CombiningKind::MUL:
+      identity = 1;
+      break;
+    case vector::CombiningKind::AND:
+      identity = -1;
+      break;
+    default:
+      break;
+    }
+    Value vecInit;
+    if (isMinMax) {
+      vecInit = rewriter.create<vector::BroadcastOp>(loc, vecType, init);
+    } else {
+      Type elemType = vecType.getElementType();
+      Attribute identityAttr =
+          isa<FloatType>(elemType)
+              ? static_cast<Attribute>(
+                    rewriter.getFloatAttr(elemType, (double)identity))
+              : static_cast<Attribute>(
+                    rewriter.getIntegerAttr(elemType, identity));
+      vecInit = rewriter.create<arith::ConstantOp>(
+          loc, DenseElementsAttr::get(vecType, identityAttr));
+    }
+
+    SmallVector<Value> newInits(forOp.getIterOperands());
+    newInits.push_back(vecInit);
+    auto newForOp = createLoopWithIterArgs(rewriter, forOp, newInits);
+    Block *newBody = newForOp.getBody();
+    rewriter.mergeBlocks(forOp.getBody(), newBody,
+                         newBody->getArguments().drop_back());
+
+    // Accumulate the vectors lane-wise, and pass the scalar through.
+    Operation *yieldOp = newBody->getTerminator();
+    rewriter.setInsertionPoint(yieldOp);
+    Value acc = newBody->getArguments().back();
+    for (Value v : vectors)
+      acc = vector::makeArithReduction(rewriter, loc, kind, acc, v);
+    rewriter.updateRootInPlace(yieldOp, [&] {
+      yieldOp->setOperand(i, newForOp.getRegionIterArgs()[i]);
+      yieldOp->insertOperands(yieldOp->getNumOperands(), acc);
+    });
+
+    // Reduce the accumulated vector once.
+    rewriter.setInsertionPointAfter(newForOp);
+    Value result = rewriter.create<vector::ReductionOp>(
+        loc, kind, newForOp.getResults().back());
+    if (!isMinMax)
+      result = vector::makeArithReduction(rewriter, loc, kind, result, init);
+
+    SmallVector<Value> results(newForOp.getResults().drop_back());
+    results[i] = result;
+    rewriter.replaceOp(forOp, results);
+  }
+};
+
+// This pass unrolls vector ops into ops on vectors the conversion to AIEVec
+// can handle, so that the rest of the pipeline only has to deal with
+// register-sized vectors:
+//    1) Vectors that won't fit in registers are split into register-sized
+//       slices.
+//    2) Vectors with an element type the target doesn't support are unrolled
+//       into single-element vectors.
+struct LegalizeVectorForAIEVecPass
+    : public aievec::impl::LegalizeVectorForAIEVecBase<
+          LegalizeVectorForAIEVecPass> {
+  using Base::Base;
+
+  void runOnOperation() override;
+};
+
+void LegalizeVectorForAIEVecPass::runOnOperation() {
+  func::FuncOp funcOp = getOperation();
+  MLIRContext *context = &getContext();
+  RewritePatternSet patterns(context);
+
+  AIEArch aieVersion = AIEArch::AIE;
+  if (!aieTarget.empty()) {
+    std::string target = aieTarget;
+    if (target == "aieml") {
+      aieVersion = AIEArch::AIE_ML;
+    } else if (target != "aie") {
+      funcOp.emitError() << "unknown AIE target '" << aieTarget << "'";
+      signalPassFailure();
+      return;
+    }
+  }
+
+  vector::populateVectorUnrollPatterns(
+      patterns, vector::UnrollVectorOptions().setNativeShapeFn(
+                    [=](Operation *op) -> std::optional<SmallVector<int64_t>> {
+                      return getNativeVectorShape(op, aieVersion);
+                    }));
+  // Forward the slices inserted by an unrolled op straight to the unrolled
+  // ops that extract them.
+  vector::ExtractStridedSliceOp::getCanonicalizationPatterns(patterns,
+                                                             context);
+
+  (void)applyPatternsAndFoldGreedily(funcOp, std::move(patterns));
+
+  // Once the reductions have been split into register-sized slices, keep the
+  // partial results of the ones carried across loop iterations in vector
+  // registers.
+  RewritePatternSet reductionPatterns(context);
+  reductionPatterns.add<AccumulateLoopCarriedReductionPattern<AffineForOp>,
+                        AccumulateLoopCarriedReductionPattern<scf::ForOp>>(
+      context);
+  (void)applyPatternsAndFoldGreedily(funcOp, std::move(reductionPatterns));
+}
+
+// Returns the number of lanes of the float vectors taken by the functions of
+// the vector math runtime library, i.e., `aie_runtime_lib/*/vec_math.h`.
+static unsigned getVecMathLaneSize(AIEArch aieVersion) {
+  return aieVersion == AIEArch::AIE ? 8 : 16;
+}
+
+// Returns true if `type` is a float vector that the vector math runtime
+// library can handle, either whole or split into two or four slices.
+static bool isVecMathType(Type type, AIEArch aieVersion) {
+  auto vType = dyn_cast<VectorType>(type);
+  if (!vType || vType.getRank() != 1 || !vType.getElementType().isF32())
+    return false;
+  unsigned lanes = getVecMathLaneSize(aieVersion);
+  unsigned numLanes = getVectorLaneSize(vType);
+  return numLanes % lanes == 0 &&
+         (numLanes == lanes || numLanes == 2 * lanes ||
+          numLanes == 4 * lanes);
+}
+
+// Returns the result of applying the `name` function of the vector math
+// runtime library to `source`, and declares the function in `moduleOp` if
+// needed. Vectors wider than the ones the library takes are split with
+// `aievec.ext`, and the results for each slice are concatenated.
+static Value createVecMathCall(PatternRewriter &rewriter, Location loc,
+                               ModuleOp moduleOp, StringRef name, Value source,
+                               AIEArch aieVersion) {
+  auto vType = cast<VectorType>(source.getType());
+  unsigned lanes = getVecMathLaneSize(aieVersion);
+  auto sliceType = VectorType::get({lanes}, vType.getElementType());
+  std::string funcName =
+      ("vec_" + name + "_v" + Twine(lanes) + "float").str();
+
+  auto funcOp = moduleOp.lookupSymbol<func::FuncOp>(funcName);
+  if (!funcOp) {
+    OpBuilder::InsertionGuard guard(rewriter);
+    rewriter.setInsertionPointToStart(moduleOp.getBody());
+    funcOp = rewriter.create<func::FuncOp>(
+        loc, funcName, rewriter.getFunctionType(sliceType, sliceType));
+    funcOp.setPrivate();
+    // The library is written in C++, but its functions have C linkage.
+    funcOp->setAttr("aie.c_linkage", rewriter.getUnitAttr());
+  }
+
+  unsigned numSlices = getVectorLaneSize(vType) / lanes;
+  if (numSlices == 1)
+    return rewriter.create<func::CallOp>(loc, funcOp, source).getResult(0);
+
+  SmallVector<Value> results;
+  for (unsigned i = 0; i < numSlices; i++) {
+    auto extOp = rewriter.create<aievec::ExtOp>(loc, sliceType, source, i);
+    auto callOp = rewriter.create<func::CallOp>(loc, funcOp, extOp.getResult());
+    results.push_back(callOp.getResult(0));
+  }
+  return rewriter.create<aievec::ConcatOp>(loc, vType, results);
+}
+
+// If `divOp` computes a sigmoid, i.e., 1 / (1 + e^(-x)), return x.
+static Value getSigmoidInput(arith::DivFOp divOp) {
+  if (!matchPattern(divOp.getLhs(), m_OneFloat()))
+    return nullptr;
+  auto addOp = divOp.getRhs().getDefiningOp<arith::AddFOp>();
+  if (!addOp)
+    return nullptr;
+  Value expValue;
+  if (matchPattern(addOp.getLhs(), m_OneFloat()))
+    expValue = addOp.getRhs();
+  else if (matchPattern(addOp.getRhs(), m_OneFloat()))
+    expValue = addOp.getLhs();
+  else
+    return nullptr;
+  auto expOp = expValue.getDefiningOp<math::ExpOp>();
+  if (!expOp)
+    return nullptr;
+  auto negOp = expOp.getOperand().getDefiningOp<arith::NegFOp>();
+  if (!negOp)
+    return nullptr;
+  return negOp.getOperand();
+}
+
+// This pattern replaces an elementwise math op on a float vector with calls
+// to the `name` function of the vector math runtime library.
+template <typename SrcOpTy>
+struct LowerVectorMathOpToRuntimeCallPattern
+    : public OpRewritePattern<SrcOpTy> {
+  using OpRewritePattern<SrcOpTy>::OpRewritePattern;
+
+  LowerVectorMathOpToRuntimeCallPattern(MLIRContext *context, StringRef name,
+                                        AIEArch aieVersion)
+      : OpRewritePattern<SrcOpTy>(context), name(name),
+        aieVersion(aieVersion) {}
+
+  LogicalResult matchAndRewrite(SrcOpTy srcOp,
+                                PatternRewriter &rewriter) const override {
+    if (!isVecMathType(srcOp.getType(), aieVersion))
+      return failure();
+
+    auto moduleOp = srcOp->template getParentOfType<ModuleOp>();
+    rewriter.replaceOp(srcOp, createVecMathCall(rewriter, srcOp.getLoc(),
+                                                moduleOp, name,
+                                                srcOp.getOperand(),
+                                                aieVersion));
+    return success();
+  }
+
+  StringRef name;
+  AIEArch aieVersion;
+};
+
+// This pattern replaces a sigmoid on a float vector, written as
+// 1 / (1 + e^(-x)), with calls to the sigmoid function of the vector math
+// runtime library.
+struct LowerVectorSigmoidToRuntimeCallPattern
+    : public OpRewritePattern<arith::DivFOp> {
+  using OpRewritePattern<arith::DivFOp>::OpRewritePattern;
+
+  LowerVectorSigmoidToRuntimeCallPattern(MLIRContext *context,
+                                         AIEArch aieVersion)
+      : OpRewritePattern<arith::DivFOp>(context), aieVersion(aieVersion) {}
+
+  LogicalResult matchAndRewrite(arith::DivFOp divOp,
+                                PatternRewriter &rewriter) const override {
+    if (!isVecMathType(divOp.getType(), aieVersion))
+      return failure();
+    Value input = getSigmoidInput(divOp);
+    if (!input)
+      return failure();
+
+    auto moduleOp = divOp->getParentOfType<ModuleOp>();
+    rewriter.replaceOp(divOp, createVecMathCall(rewriter, divOp.getLoc(),
+                                                moduleOp, "sigmoid", input,
+                                                aieVersion));
+    return success();
+  }
+
+  AIEArch aieVersion;
+};
+
+// This pass replaces elementwise math functions on float vectors, which AIE
+// cores have no instructions for, with calls to the vectorized routines of
+// the runtime library, instead of leaving them to be scalarized into one
+// libm call per lane.
+struct LowerVectorMathToAIEVecPass
+    : public aievec::impl::LowerVectorMathToAIEVecBase<
+          LowerVectorMathToAIEVecPass> {
+  using Base::Base;
+
+  void runOnOperation() override;
+};
+
+void LowerVectorMathToAIEVecPass::runOnOperation() {
+  ModuleOp moduleOp = getOperation();
+  MLIRContext *context = &getContext();
+
+  AIEArch aieVersion = AIEArch::AIE;
+  if (!aieTarget.empty()) {
+    std::string target = aieTarget;
+    if (target == "aieml") {
+      aieVersion = AIEArch::AIE_ML;
+    } else if (target != "aie") {
+      moduleOp.emitError() << "unknown AIE target '" << aieTarget << "'";
+      signalPassFailure();
+      return;
+    }
+  }
+
+  // Sigmoids are matched first, so that their exponentials don't get lowered
+  // on their own.
+  RewritePatternSet sigmoidPatterns(context);
+  sigmoidPatterns.add<LowerVectorSigmoidToRuntimeCallPattern>(context,
+                                                              aieVersion);
+  (void)applyPatternsAndFoldGreedily(moduleOp, std::move(sigmoidPatterns));
+
+  RewritePatternSet patterns(context);
+  patterns.add<LowerVectorMathOpToRuntimeCallPattern<math::ExpOp>>(
+      context, "exp", aieVersion);
+  patterns.add<LowerVectorMathOpToRuntimeCallPattern<math::TanhOp>>(
+      context, "tanh", aieVersion);
+  patterns.add<LowerVectorMathOpToRuntimeCallPattern<math::RsqrtOp>>(
+      context, "rsqrt", aieVersion);
+  (void)applyPatternsAndFoldGreedily(moduleOp, std::move(patterns));
+}
+
+// Returns true if some transfer op nested in `forOp` can only be proven to be
+// in bounds if the last iteration of the loop is left out, i.e., when the step
+// doesn't evenly divide the iteration space and the last iteration runs past
+// the end of a memref.
+static bool needsEpilogue(AffineForOp forOp) {
+  if (!forOp.hasConstantBounds())
+    return false;
+  int64_t lb = forOp.getConstantLowerBound();
+  int64_t ub = forOp.getConstantUpperBound();
+  int64_t step = forOp.getStep();
+  if (ub - lb <= step || (ub - lb) % step == 0)
+    return false;
+
+  DenseMap<Value, IndexRange> mainRanges;
+  int64_t mainUb = lb + (ub - lb) / step * step;
+  mainRanges[forOp.getInductionVar()] = IndexRange(lb, mainUb - step);
+  auto improves = [&](auto op) {
+    SmallVector<bool, 4> inBounds = computeTransferInBounds(op);
+    SmallVector<bool, 4> mainInBounds = computeTransferInBounds(op, mainRanges);
+    return inBounds != mainInBounds;
+  };
+  WalkResult result = forOp.getBody()->walk([&](Operation *op) {
+    if (auto readOp = dyn_cast<vector::TransferReadOp>(op))
+      if (!readOp.getInBounds() && improves(readOp))
+        return WalkResult::interrupt();
+    if (auto writeOp = dyn_cast<vector::TransferWriteOp>(op))
+      if (!writeOp.getInBounds() && improves(writeOp))
+        return WalkResult::interrupt();
+    return WalkResult::advance();
+  });
+  return result.wasInterrupted();
+}
+
+// Peel the last iteration of `forOp` into an epilogue, so that the accesses of
+// the main loop can be proven to be in bounds. Only the accesses in the
+// epilogue are left out of bounds (i.e., masked).
+static void peelEpilogue(AffineForOp forOp) {
+  int64_t lb = forOp.getConstantLowerBound();
+  int64_t ub = forOp.getConstantUpperBound();
+  int64_t mainUb = lb + (ub - lb) / forOp.getStep() * forOp.getStep();
+
+  OpBuilder builder(forOp->getContext());
+  builder.setInsertionPointAfter(forOp);
+  auto epilogue = cast<AffineForOp>(builder.clone(*forOp.getOperation()));
+  forOp->replaceAllUsesWith(epilogue.getOperation());
+  // With constant bounds, the only operands of the loops are the initial
+  // values of their iteration arguments.
+  epilogue->setOperands(forOp->getResults());
+  forOp.setConstantUpperBound(mainUb);
+  epilogue.setConstantLowerBound(mainUb);
+  (void)promoteIfSingleIteration(epilogue);
+}
+
 struct RedundantLoadStoreOptimizationPass
     : public PassWrapper<RedundantLoadStoreOptimizationPass,
                          OperationPass<func::FuncOp>> {
@@ -2094,6 +3129,16 @@ void RedundantLoadStoreOptimizationPass::runOnOperation() {
   MLIRContext *context = &getContext();
   RewritePatternSet patterns(context);
 
+  // Loops that overrun a memref on their last iteration get that iteration
+  // peeled, so that the rest of the loop can be marked as in bounds.
+  SmallVector<AffineForOp> loopsToPeel;
+  funcOp.walk([&](AffineForOp forOp) {
+    if (needsEpilogue(forOp))
+      loopsToPeel.push_back(forOp);
+  });
+  for (AffineForOp forOp : loopsToPeel)
+    peelEpilogue(forOp);
+
   patterns.add<SetInboundsToReadOp, SetInboundsToWriteOp>(
       patterns.getContext());
 
@@ -2184,10 +3229,12 @@ void xilinx::aievec::buildConvertVectorToAIEVec(
   pm.addPass(createRedundantLoadStoreOptimizationPass());
 
   // Add `Vector` code canonicalization passes
-  // TODO: Add passes to unroll vector with unsupported types
-  // TODO: Add passes to split vectors that won't fit in registers
+  pm.addPass(createLegalizeVectorForAIEVec(
+      options.getLegalizeVectorForAIEVecOptions()));
   pm.addPass(
       createCanonicalizeForAIEVec(options.getCanonicalizeForAIEVecOptions()));
+  pm.addPass(createLowerVectorMathToAIEVec(
+      options.getLowerVectorMathToAIEVecOptions()));
   // Add lowering from `Vector` to `AIEVec`
   pm.addPass(
       createLowerVectorToAIEVec(options.getLowerVectorToAIEVecOptions()));
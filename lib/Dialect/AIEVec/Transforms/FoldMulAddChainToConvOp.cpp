@@ -26,15 +26,58 @@ using namespace vector;
 using namespace xilinx;
 using namespace xilinx::aievec;
 
-typedef std::tuple<int8_t, aievec::UPDOp, arith::MulIOp> MulDefTupleTy;
+// The mul and add ops of a chain are either arith.muli/arith.addi for integer
+// convolutions or arith.mulf/arith.addf for bfloat16 convolutions, so the
+// chain is kept as generic operations.
+typedef std::tuple<int8_t, aievec::UPDOp, Operation *> MulDefTupleTy;
 using MulDefTupleVecTy = SmallVector<MulDefTupleTy, 8>;
 using MulDefMapTy = DenseMap<Value, MulDefTupleVecTy>;
 
-// If only one of the operands of given add is an add, return that operand's def
-// op; otherwise return null.
-arith::AddIOp getDefAddOp(arith::AddIOp addOp) {
-  auto defLhs = dyn_cast<arith::AddIOp>(addOp->getOperand(0).getDefiningOp());
-  auto defRhs = dyn_cast<arith::AddIOp>(addOp->getOperand(1).getDefiningOp());
+static bool isMulOp(Operation *op) {
+  return isa_and_nonnull<arith::MulIOp, arith::MulFOp>(op);
+}
+
+// Return the M (number of outputs) and N (number of kernel taps) of the
+// AIE-ML mul_conv/mac_conv intrinsic for the given element type:
+// mac_conv_32x8 for v32int8, mac_conv_16x4 for v16int16 and mac_conv_16x8 for
+// v16bfloat16. Return {0, 0} if there is no such intrinsic.
+static std::pair<int32_t, int32_t> getConvOpShape(Type elemType) {
+  if (elemType.isInteger(8))
+    return {32, 8};
+  if (elemType.isInteger(16))
+    return {16, 4};
+  if (elemType.isBF16())
+    return {16, 8};
+  return {0, 0};
+}
+
+// Return the accumulator element type of a convolution on the given element
+// type.
+static Type getConvOpAccElemType(Type elemType) {
+  if (elemType.isa<FloatType>())
+    return FloatType::getF32(elemType.getContext());
+  unsigned width = elemType.getIntOrFloatBitWidth() <= 8 ? 32 : 64;
+  return IntegerType::get(elemType.getContext(), width);
+}
+
+// Return the broadcast operand of the given mul op, if any.
+static aievec::BroadcastOp getBroadcastOperand(Operation *mulOp) {
+  if (auto bcastOp = dyn_cast_or_null<aievec::BroadcastOp>(
+          mulOp->getOperand(0).getDefiningOp()))
+    return bcastOp;
+  return dyn_cast_or_null<aievec::BroadcastOp>(
+      mulOp->getOperand(1).getDefiningOp());
+}
+
+// If only one of the operands of given add is an add of the same kind, return
+// that operand's def op; otherwise return null.
+Operation *getDefAddOp(Operation *addOp) {
+  auto isSameAdd = [&](Value v) {
+    Operation *defOp = v.getDefiningOp();
+    return defOp && defOp->getName() == addOp->getName() ? defOp : nullptr;
+  };
+  Operation *defLhs = isSameAdd(addOp->getOperand(0));
+  Operation *defRhs = isSameAdd(addOp->getOperand(1));
   if ((!defLhs && !defRhs) || (defLhs && defRhs)) {
     return nullptr;
   }
@@ -44,28 +87,30 @@ arith::AddIOp getDefAddOp(arith::AddIOp addOp) {
 // Return true if one of the operands of given mul op is a broadcast of a upd op
 // and another operand of the mul op is a upd op. In this case, argument book
 // keeps arguments. Otherwise, return false and leave book keeping unchanged.
-bool checkChainPattern(arith::MulIOp mulOp, MulDefMapTy &macChainMap,
+bool checkChainPattern(Operation *mulOp, MulDefMapTy &macChainMap,
                        SmallVectorImpl<Value> &bcastOpSourceVec) {
   aievec::BroadcastOp bcastOp = nullptr;
   aievec::UPDOp updOp = nullptr;
 
-  if (isa<aievec::BroadcastOp>(mulOp.getOperand(0).getDefiningOp())) {
-    bcastOp = cast<aievec::BroadcastOp>(mulOp->getOperand(0).getDefiningOp());
-    if (!isa<aievec::UPDOp>(mulOp->getOperand(1).getDefiningOp())) {
+  Operation *lhsDefOp = mulOp->getOperand(0).getDefiningOp();
+  Operation *rhsDefOp = mulOp->getOperand(1).getDefiningOp();
+  if (isa_and_nonnull<aievec::BroadcastOp>(lhsDefOp)) {
+    bcastOp = cast<aievec::BroadcastOp>(lhsDefOp);
+    if (!isa_and_nonnull<aievec::UPDOp>(rhsDefOp)) {
       return false;
     }
-    updOp = cast<aievec::UPDOp>(mulOp->getOperand(1).getDefiningOp());
-  } else if (isa<aievec::BroadcastOp>(mulOp.getOperand(1).getDefiningOp())) {
-    bcastOp = cast<aievec::BroadcastOp>(mulOp->getOperand(1).getDefiningOp());
-    if (!isa<aievec::UPDOp>(mulOp->getOperand(0).getDefiningOp())) {
+    updOp = cast<aievec::UPDOp>(rhsDefOp);
+  } else if (isa_and_nonnull<aievec::BroadcastOp>(rhsDefOp)) {
+    bcastOp = cast<aievec::BroadcastOp>(rhsDefOp);
+    if (!isa_and_nonnull<aievec::UPDOp>(lhsDefOp)) {
       return false;
     }
-    updOp = cast<aievec::UPDOp>(mulOp->getOperand(0).getDefiningOp());
+    updOp = cast<aievec::UPDOp>(lhsDefOp);
   } else {
     return false;
   }
 
-  if (!isa<aievec::UPDOp>(bcastOp.getSource().getDefiningOp())) {
+  if (!isa_and_nonnull<aievec::UPDOp>(bcastOp.getSource().getDefiningOp())) {
     return false;
   }
 
@@ -83,18 +128,20 @@ bool checkChainPattern(arith::MulIOp mulOp, MulDefMapTy &macChainMap,
 
 // The defs of mul ops consist of an upd op and a broadcast op.
 // The chain map looks like below:
-// | BroadcastOp source | vector<tuple<broadcastOp idx, UPDOp, MulIOp>> |
+// | BroadcastOp source | vector<tuple<broadcastOp idx, UPDOp, MulOp>> |
 // The mul add op chain can be grouped by broadcast op's source.
 // For each group, broadcastOp idx can be sorted to find the start of the
 // memrefs used by broadcast op and upd op.
-void buildChainMap(arith::AddIOp curAddOp, bool &hasMulConv, Value &acc,
+void buildChainMap(Operation *curAddOp, bool &hasMulConv, Value &acc,
                    MulDefMapTy &macChainMap,
                    SmallVectorImpl<Value> &bcastOpSourceVec) {
   while (true) {
-    auto defLhs =
-        dyn_cast<arith::MulIOp>(curAddOp->getOperand(0).getDefiningOp());
-    auto defRhs =
-        dyn_cast<arith::MulIOp>(curAddOp->getOperand(1).getDefiningOp());
+    Operation *defLhs = curAddOp->getOperand(0).getDefiningOp();
+    Operation *defRhs = curAddOp->getOperand(1).getDefiningOp();
+    if (!isMulOp(defLhs))
+      defLhs = nullptr;
+    if (!isMulOp(defRhs))
+      defRhs = nullptr;
 
     if (!defLhs && !defRhs) {
       break;
@@ -109,7 +156,7 @@ void buildChainMap(arith::AddIOp curAddOp, bool &hasMulConv, Value &acc,
       }
       hasMulConv = true;
     } else {
-      arith::MulIOp curMulOp = defLhs ? defLhs : defRhs;
+      Operation *curMulOp = defLhs ? defLhs : defRhs;
       if (!checkChainPattern(curMulOp, macChainMap, bcastOpSourceVec)) {
         break;
       }
@@ -117,7 +164,7 @@ void buildChainMap(arith::AddIOp curAddOp, bool &hasMulConv, Value &acc,
     }
 
     // Get the def add op the curOp operands
-    arith::AddIOp defAddOp = getDefAddOp(curAddOp);
+    Operation *defAddOp = getDefAddOp(curAddOp);
 
     // The user/consumer user operation must be an add op, belonging to
     // the same basic block as curOp.
@@ -130,10 +177,10 @@ void buildChainMap(arith::AddIOp curAddOp, bool &hasMulConv, Value &acc,
 }
 
 void refreshFusedGroups(
-    MulDefTupleTy defTuple, arith::MulIOp nextMulOp,
-    SmallVector<arith::MulIOp, 8> &fusedOps,
-    SmallVectorImpl<SmallVector<arith::MulIOp, 8>> &groupFusedOps,
-    int8_t &curIdx, aievec::UPDOp &curUpdOp, arith::MulIOp &curMulOp) {
+    MulDefTupleTy defTuple, Operation *nextMulOp,
+    SmallVector<Operation *, 8> &fusedOps,
+    SmallVectorImpl<SmallVector<Operation *, 8>> &groupFusedOps,
+    int8_t &curIdx, aievec::UPDOp &curUpdOp, Operation *&curMulOp) {
   groupFusedOps.push_back(fusedOps);
   fusedOps.clear();
   fusedOps.push_back(nextMulOp);
@@ -141,39 +188,46 @@ void refreshFusedGroups(
 }
 
 // Check whether mul add chain is valid for the transformation and classify the
-// fused ops into different groups with valid constant memref distances.
+// fused ops into different groups with valid constant memref distances. Taps
+// of a 2D kernel that are on different rows of the input are split into
+// different groups, one per row.
 bool collectFusedOps(
     unsigned maxGroupSize, unsigned &dupFactor,
     SmallVectorImpl<Value> &bcastOpSourceVec,
-    SmallVectorImpl<SmallVector<arith::MulIOp, 8>> &groupFusedOps,
+    SmallVectorImpl<SmallVector<Operation *, 8>> &groupFusedOps,
     MulDefMapTy &macChainMap) {
   int xDist = -1, zDist = -1;
   for (auto item : bcastOpSourceVec) {
     auto macChain = macChainMap[item];
-    std::sort(macChain.begin(), macChain.end());
+    std::stable_sort(macChain.begin(), macChain.end(),
+                     [](const MulDefTupleTy &a, const MulDefTupleTy &b) {
+                       return std::get<0>(a) < std::get<0>(b);
+                     });
     int8_t curIdx = 0;
     aievec::UPDOp curUpdOp = nullptr;
-    arith::MulIOp curMulOp = nullptr;
+    Operation *curMulOp = nullptr;
     std::tie(curIdx, curUpdOp, curMulOp) = *macChain.begin();
-    SmallVector<int32_t, 2> dists;
-    SmallVector<arith::MulIOp, 8> fusedOps;
+    SmallVector<Operation *, 8> fusedOps;
     fusedOps.push_back(curMulOp);
 
     for (auto it = std::next(macChain.begin()); it != macChain.end(); ++it) {
       int8_t nextIdx = 0;
       aievec::UPDOp nextUpdOp = nullptr;
-      arith::MulIOp nextMulOp = nullptr;
+      Operation *nextMulOp = nullptr;
       MulDefTupleTy defTuple = *it;
       std::tie(nextIdx, nextUpdOp, nextMulOp) = defTuple;
 
-      int32_t dist = nextIdx - curIdx;
+      // Distance between the broadcast indices of the two taps.
+      int32_t bcastDist = nextIdx - curIdx;
 
-      // Target AIE-ML intrinsic mac_conv_32x8 for v32int8 type and
-      // mac_conv_16x4 for v16int16 type. Thus, the distance of broadcast op
-      // source between two mul add ops cannot be larger than 32/8 or 16/4,
-      // which is 4. If dist is larger than 1, we need to shuffle the load to
+      // Target AIE-ML intrinsic mac_conv_32x8 for v32int8 type, mac_conv_16x4
+      // for v16int16 type and mac_conv_16x8 for v16bfloat16 type. Thus, the
+      // distance of broadcast op source between two mul add ops cannot be
+      // larger than M/N, which is 32/8 = 4, 16/4 = 4 or 16/8 = 2. Distances
+      // larger than 1 are only folded for int8 (see below), so 4 is the bound
+      // checked here. If dist is larger than 1, we need to shuffle the load to
       // get the elements with the interval of dist.
-      if (dist > 4) {
+      if (bcastDist > 4) {
         if (fusedOps.size() < 2) {
           return false;
         }
@@ -182,7 +236,6 @@ bool collectFusedOps(
         continue;
       }
 
-      dists.push_back(dist);
       if (curUpdOp.getSource() != nextUpdOp.getSource()) {
         if (fusedOps.size() < 2) {
           return false;
@@ -236,8 +289,11 @@ bool collectFusedOps(
         continue;
       }
 
-      dist = nextOffset - curOffset;
-      if (dist != 1) {
+      // Distance between the input elements of the two taps. Consecutive
+      // taps of a kernel row read consecutive elements; the first tap of the
+      // next kernel row is a whole input row away and starts a new group.
+      int32_t accessDist = nextOffset - curOffset;
+      if (accessDist != 1) {
         if (fusedOps.size() < 2) {
           return false;
         }
@@ -245,10 +301,9 @@ bool collectFusedOps(
                            curUpdOp, curMulOp);
         continue;
       }
-      dists.push_back(dist);
 
-      if ((xDist != -1 && xDist != dists[0]) ||
-          (zDist != -1 && zDist != dists[1])) {
+      if ((xDist != -1 && xDist != bcastDist) ||
+          (zDist != -1 && zDist != accessDist)) {
         if (fusedOps.size() < 2) {
           return false;
         }
@@ -257,9 +312,9 @@ bool collectFusedOps(
         continue;
       }
 
-      xDist = dists[0];
-      zDist = dists[1];
-      dupFactor = dists[0];
+      xDist = bcastDist;
+      zDist = accessDist;
+      dupFactor = bcastDist;
 
       fusedOps.push_back(nextMulOp);
       std::tie(curIdx, curUpdOp, curMulOp) = defTuple;
@@ -276,26 +331,76 @@ bool collectFusedOps(
   return true;
 }
 
-struct canFoldMulAddChainToConvOpAnalysis {
-  canFoldMulAddChainToConvOpAnalysis(arith::AddIOp addOp) {
-    if (!isa<VectorType>(addOp.getType())) {
-      canFoldMulAddChainToConvOp = false;
-      return;
+// A mul_conv/mac_conv op multiplies N consecutive kernel coefficients, even if
+// its group has fewer taps. The coefficients past the last tap are only known
+// to be padding when another group starts after the window of N coefficients.
+// When another group starts inside the window, e.g., for a 2D kernel whose
+// rows are contiguous in memory, they are the first coefficients of that
+// group. When no group follows, e.g., for the last row of a kernel, they may
+// lie past the end of the kernel. Return, for each group with fewer than N
+// taps, whether these coefficients have to be zeroed.
+static SmallVector<bool, 8> computeCoefficientMasks(
+    ArrayRef<SmallVector<Operation *, 8>> groupFusedOps, unsigned dupFactor,
+    unsigned maxGroupSize) {
+  // The memref, base and constant offset of the first coefficient of each
+  // group, if known.
+  SmallVector<std::tuple<Value, AffineExpr, int64_t>, 8> starts;
+  for (auto &fusedOps : groupFusedOps) {
+    aievec::BroadcastOp bcastOp = getBroadcastOperand(fusedOps.front());
+    auto bcastUPDOp = cast<aievec::UPDOp>(bcastOp.getSource().getDefiningOp());
+    AffineExpr linearAccess = constructLinearizedAffineExprForUPDOp(bcastUPDOp);
+    if (!linearAccess) {
+      starts.push_back(std::make_tuple(Value(), AffineExpr(), 0));
+      continue;
     }
+    AffineExpr base;
+    int32_t offset;
+    std::tie(base, offset) = extractBaseAndOffset(linearAccess);
+    starts.push_back(std::make_tuple(bcastUPDOp.getSource(), base,
+                                     offset + bcastOp.getIdx()));
+  }
 
-    VectorType resultType = cast<VectorType>(addOp.getResult().getType());
+  SmallVector<bool, 8> masks;
+  for (unsigned i = 0; i < groupFusedOps.size(); i++) {
+    auto [memref, base, start] = starts[i];
+    unsigned numTaps = groupFusedOps[i].size();
+    int64_t tapsEnd = start + numTaps * dupFactor;
+    int64_t windowEnd = start + maxGroupSize * dupFactor;
+    if (numTaps >= maxGroupSize) {
+      masks.push_back(false);
+      continue;
+    }
+    bool overlaps = false;
+    bool hasFollowingGroup = false;
+    for (unsigned j = 0; memref && j < starts.size(); j++) {
+      auto [otherMemref, otherBase, otherStart] = starts[j];
+      if (j == i || otherMemref != memref || otherBase != base ||
+          otherStart < tapsEnd)
+        continue;
+      hasFollowingGroup = true;
+      if (otherStart < windowEnd)
+        overlaps = true;
+    }
+    masks.push_back(overlaps || !hasFollowingGroup);
+  }
+  return masks;
+}
 
-    if (!resultType.getElementType().isa<IntegerType>()) {
+struct canFoldMulAddChainToConvOpAnalysis {
+  canFoldMulAddChainToConvOpAnalysis(Operation *addOp) {
+    if (!isa<VectorType>(addOp->getResult(0).getType())) {
       canFoldMulAddChainToConvOp = false;
       return;
     }
 
-    IntegerType resultElType = cast<IntegerType>(resultType.getElementType());
-    unsigned resultElWidth = resultElType.getWidth();
+    VectorType resultType = cast<VectorType>(addOp->getResult(0).getType());
+    Type resultElType = resultType.getElementType();
     unsigned laneSize = getVectorLaneSize(resultType);
 
-    if ((laneSize != 32 || resultElWidth != 8) &&
-        (laneSize != 16 || resultElWidth != 16)) {
+    // The result must fill the M lanes of one of the AIE-ML convolution
+    // intrinsics.
+    auto [M, N] = getConvOpShape(resultElType);
+    if (!M || laneSize != (unsigned)M) {
       canFoldMulAddChainToConvOp = false;
       return;
     }
@@ -307,12 +412,12 @@ struct canFoldMulAddChainToConvOpAnalysis {
 
     // Search for the last add op in the block.
     auto usrOp = *addOp->getUsers().begin();
-    if (!usrOp || isa<arith::AddIOp>(usrOp)) {
+    if (!usrOp || usrOp->getName() == addOp->getName()) {
       canFoldMulAddChainToConvOp = false;
       return;
     }
 
-    arith::AddIOp curAddOp = addOp;
+    Operation *curAddOp = addOp;
     // bcastOpSourceVec is a container to trace the order of broadcast ops'
     // source in the chain.
     SmallVector<Value, 8> bcastOpSourceVec;
@@ -331,38 +436,44 @@ struct canFoldMulAddChainToConvOpAnalysis {
     // Since we trace the order forwards, now reverse the vector.
     std::reverse(bcastOpSourceVec.begin(), bcastOpSourceVec.end());
 
-    auto getConstantIdx = [](Value v) {
+    // Rank the memrefs read by the broadcast ops by their first appearance in
+    // the chain.
+    DenseMap<Value, unsigned> memrefRank;
+    for (Value v : bcastOpSourceVec) {
+      Value memref = cast<aievec::UPDOp>(v.getDefiningOp()).getSource();
+      memrefRank.try_emplace(memref, memrefRank.size());
+    }
+
+    auto getConstantOffset = [](Value v) {
       aievec::UPDOp bcastUPDOp = cast<aievec::UPDOp>(v.getDefiningOp());
-      SmallVector<Value, 4> indices(bcastUPDOp.getIndices().begin(),
-                                    bcastUPDOp.getIndices().end());
-      Value innerMostIdx = indices[indices.size() - 1];
-      int64_t val = -1;
-      if (auto idxDefOp = innerMostIdx.getDefiningOp()) {
-        if (auto constOp = dyn_cast<arith::ConstantOp>(idxDefOp)) {
-          val = cast<IntegerAttr>(constOp.getValue()).getInt();
-        }
-      }
-      return val;
+      AffineExpr linearAccess =
+          constructLinearizedAffineExprForUPDOp(bcastUPDOp);
+      if (!linearAccess)
+        return -1;
+      auto [base, offset] = extractBaseAndOffset(linearAccess);
+      return base ? -1 : offset;
     };
 
     // If broadcast ops' sources are from the same memref, sort the broadcast
-    // ops by an increasing order of memrefs' constant indices.
-    std::sort(bcastOpSourceVec.begin(), bcastOpSourceVec.end(),
-              [&](const Value &a, const Value &b) {
-                aievec::UPDOp bcastUPDOpA =
-                    cast<aievec::UPDOp>(a.getDefiningOp());
-                aievec::UPDOp bcastUPDOpB =
-                    cast<aievec::UPDOp>(b.getDefiningOp());
-                if (bcastUPDOpA.getSource() == bcastUPDOpB.getSource()) {
-                  return getConstantIdx(a) <= getConstantIdx(b);
-                }
-                return true;
-              });
-
-    unsigned maxGroupSize = resultElWidth == 16 ? 4 : 8;
+    // ops by an increasing order of their constant offsets in the memref, e.g.
+    // the rows of a 2D kernel.
+    std::stable_sort(bcastOpSourceVec.begin(), bcastOpSourceVec.end(),
+                     [&](const Value &a, const Value &b) {
+                       unsigned rankA = memrefRank[cast<aievec::UPDOp>(
+                                                       a.getDefiningOp())
+                                                       .getSource()];
+                       unsigned rankB = memrefRank[cast<aievec::UPDOp>(
+                                                       b.getDefiningOp())
+                                                       .getSource()];
+                       if (rankA != rankB)
+                         return rankA < rankB;
+                       return getConstantOffset(a) < getConstantOffset(b);
+                     });
+
+    unsigned maxGroupSize = N;
 
     // Legality check for the mul add chain, and collect the ops that can be
-    // transformed to mul_conv and mul_conv.
+    // transformed to mul_conv and mac_conv.
     if (!collectFusedOps(maxGroupSize, dupFactor, bcastOpSourceVec,
                          groupFusedOps, macChainMap)) {
       canFoldMulAddChainToConvOp = false;
@@ -374,45 +485,59 @@ struct canFoldMulAddChainToConvOpAnalysis {
       canFoldMulAddChainToConvOp = false;
       return;
     }
+
+    // The even/odd shuffle that compacts duplicated data only exists for 8-bit
+    // elements.
+    if (dupFactor != 1 && !resultElType.isInteger(8)) {
+      canFoldMulAddChainToConvOp = false;
+      return;
+    }
+
+    coefficientMasks =
+        computeCoefficientMasks(groupFusedOps, dupFactor, maxGroupSize);
     canFoldMulAddChainToConvOp = true;
   }
 
   MulDefMapTy macChainMap;
-  SmallVector<SmallVector<arith::MulIOp, 8>, 8> groupFusedOps;
-  unsigned dupFactor;
-  bool hasMulConv;
+  SmallVector<SmallVector<Operation *, 8>, 8> groupFusedOps;
+  SmallVector<bool, 8> coefficientMasks;
+  unsigned dupFactor = 1;
+  bool hasMulConv = false;
   Value acc;
   bool canFoldMulAddChainToConvOp;
 };
 
 // This conversion pattern folds a mul add chain into mul_conv and mac_conv
-// ops. We can handle the mul add chain with a random order.
-struct FoldMulAddChainToConvOpPattern
-    : public OpConversionPattern<arith::AddIOp> {
-  using OpConversionPattern<arith::AddIOp>::OpConversionPattern;
+// ops. We can handle the mul add chain with a random order. SrcOpTy is
+// arith::AddIOp for integer chains and arith::AddFOp for bfloat16 chains.
+template <typename SrcOpTy>
+struct FoldMulAddChainToConvOpPattern : public OpConversionPattern<SrcOpTy> {
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+  using OpAdaptor = typename SrcOpTy::Adaptor;
 
   FoldMulAddChainToConvOpPattern(MLIRContext *context, AnalysisManager &am,
                                  unsigned shiftParam = 0)
-      : OpConversionPattern<arith::AddIOp>(context), am(am),
-        shiftParam(shiftParam) {}
+      : OpConversionPattern<SrcOpTy>(context), am(am), shiftParam(shiftParam) {
+  }
 
   LogicalResult
-  matchAndRewrite(arith::AddIOp srcOp, OpAdaptor adaptor,
+  matchAndRewrite(SrcOpTy srcOp, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
     canFoldMulAddChainToConvOpAnalysis analysis =
         am.getChildAnalysis<canFoldMulAddChainToConvOpAnalysis>(srcOp);
     if (!analysis.canFoldMulAddChainToConvOp)
       return failure();
 
-    SmallVector<SmallVector<arith::MulIOp, 8>, 8> groupFusedOps =
+    SmallVector<SmallVector<Operation *, 8>, 8> groupFusedOps =
         analysis.groupFusedOps;
     MulDefMapTy macChainMap = analysis.macChainMap;
     unsigned dupFactor = analysis.dupFactor;
     bool hasMulConv = analysis.hasMulConv;
     Value acc = analysis.acc;
 
-    for (auto fusedOps : groupFusedOps) {
-      arith::MulIOp mulOp = (*fusedOps.begin());
+    for (unsigned groupIdx = 0; groupIdx < groupFusedOps.size(); groupIdx++) {
+      auto &fusedOps = groupFusedOps[groupIdx];
+      Operation *mulOp = (*fusedOps.begin());
 
       // Get the mul op's lhs and rhs defining ops. We keep splat op at rhs.
       if (isa<aievec::BroadcastOp>(mulOp->getOperand(0).getDefiningOp())) {
@@ -425,14 +550,11 @@ struct FoldMulAddChainToConvOpPattern
       Value lhs = mulOp->getOperand(0);
       Value rhs = mulOp->getOperand(1);
 
-      VectorType vType = cast<VectorType>(mulOp.getResult().getType());
+      VectorType vType = cast<VectorType>(mulOp->getResult(0).getType());
       Type sType = vType.getElementType();
-      IntegerType iType = cast<IntegerType>(sType);
-      unsigned width = iType.getWidth() <= 8 ? 32 : 64;
-      int32_t M = iType.getWidth() == 8 ? 32 : 16;
-      int32_t N = iType.getWidth() == 8 ? 8 : 4;
+      auto [M, N] = getConvOpShape(sType);
 
-      Type ctype = mlir::IntegerType::get(iType.getContext(), width);
+      Type ctype = getConvOpAccElemType(sType);
       Type opType = VectorType::get(vType.getShape(), ctype);
 
       aievec::BroadcastOp bcastOp =
@@ -468,6 +590,9 @@ struct FoldMulAddChainToConvOpPattern
           }
         }
       }
+      // A non-constant innermost index is taken as is.
+      if (val < 0)
+        val = 0;
 
       aievec::UPDOp newBcastOp = bcastUPDOp;
 
@@ -487,8 +612,8 @@ struct FoldMulAddChainToConvOpPattern
             newBcastOp.getLoc(), resType, newBcastOp.getResult(), 0);
       }
 
-      int32_t shiftBytes = (bcastOp.getIdx() + val) *
-                           getElementSizeInBits(vType) / 8 / dupFactor;
+      int32_t elemBytes = getElementSizeInBits(vType) / 8;
+      int32_t shiftBytes = (bcastOp.getIdx() + val) * elemBytes / dupFactor;
 
       rhs = shuffleOp->getResult(0);
 
@@ -504,6 +629,32 @@ struct FoldMulAddChainToConvOpPattern
             constOp.getResult());
       }
 
+      // Zero the coefficients past the last tap of this group if they belong
+      // to another row of the kernel, or may lie past its end. With k the
+      // number of bytes to keep, shift(zero, rhs, k) moves the first k bytes of
+      // rhs to the top of the vector, and shifting that with zero by 64 - k
+      // bytes moves them back to the bottom, followed by zeros.
+      if (analysis.coefficientMasks[groupIdx]) {
+        Location loc = rhs.getLoc();
+        int32_t keepBytes = fusedOps.size() * elemBytes;
+        TypedAttr zeroAttr =
+            sType.isa<FloatType>()
+                ? TypedAttr(rewriter.getFloatAttr(sType, 0.0))
+                : TypedAttr(rewriter.getIntegerAttr(sType, 0));
+        auto zeroConstOp = rewriter.create<arith::ConstantOp>(loc, zeroAttr);
+        auto zeroOp = rewriter.create<aievec::BroadcastScalarOp>(
+            loc, resType, zeroConstOp.getResult());
+        auto keepConstOp = rewriter.create<arith::ConstantOp>(
+            loc, rewriter.getI32IntegerAttr(keepBytes));
+        auto topOp = rewriter.create<aievec::ShiftOp>(
+            loc, resType, zeroOp.getResult(), rhs, keepConstOp.getResult());
+        auto backConstOp = rewriter.create<arith::ConstantOp>(
+            loc, rewriter.getI32IntegerAttr(64 - keepBytes));
+        rhs = rewriter.create<aievec::ShiftOp>(loc, resType, topOp.getResult(),
+                                               zeroOp.getResult(),
+                                               backConstOp.getResult());
+      }
+
       aievec::UPDOp lUPDOp = cast<aievec::UPDOp>(lhs.getDefiningOp());
       SmallVector<Value, 8> lIndices;
       lIndices.append(lUPDOp.getIndices().begin(), lUPDOp.getIndices().end());
@@ -519,27 +670,19 @@ struct FoldMulAddChainToConvOpPattern
       }
 
       Operation *convOp = nullptr;
-      if (fusedOps == groupFusedOps.back()) {
-        if (hasMulConv) {
-          convOp = rewriter.create<aievec::MulConvOp>(srcOp->getLoc(), opType,
-                                                      lhs, rhs, M, N);
-          hasMulConv = false;
-        } else {
-          convOp = rewriter.create<aievec::FMAConvOp>(
-              srcOp->getLoc(), opType, lhs, rhs, acc, M, N, false);
-        }
+      if (hasMulConv) {
+        convOp = rewriter.create<aievec::MulConvOp>(srcOp->getLoc(), opType,
+                                                    lhs, rhs, M, N);
+        hasMulConv = false;
+      } else {
+        convOp = rewriter.create<aievec::FMAConvOp>(srcOp->getLoc(), opType,
+                                                    lhs, rhs, acc, M, N, false);
+      }
+
+      if (groupIdx == groupFusedOps.size() - 1) {
         rewriter.replaceOpWithNewOp<aievec::SRSOp>(
             srcOp, vType, convOp->getResult(0), shiftParam);
         return success();
-      } else {
-        if (hasMulConv) {
-          convOp = rewriter.create<aievec::MulConvOp>(srcOp->getLoc(), opType,
-                                                      lhs, rhs, M, N);
-          hasMulConv = false;
-        } else {
-          convOp = rewriter.create<aievec::FMAConvOp>(
-              srcOp->getLoc(), opType, lhs, rhs, acc, M, N, false);
-        }
       }
       acc = convOp->getResult(0);
     }
@@ -559,11 +702,16 @@ void configureAIEVecConvOpTransformationLegalizations(ConversionTarget &target,
     return !am.getChildAnalysis<canFoldMulAddChainToConvOpAnalysis>(op)
                 .canFoldMulAddChainToConvOp;
   });
+  target.addDynamicallyLegalOp<arith::AddFOp>([&am](arith::AddFOp op) {
+    return !am.getChildAnalysis<canFoldMulAddChainToConvOpAnalysis>(op)
+                .canFoldMulAddChainToConvOp;
+  });
 }
 
 void populateAIEVecConvOpTransformationPatterns(RewritePatternSet &patterns,
                                                 AnalysisManager &am,
                                                 unsigned shiftParam) {
-  patterns.add<FoldMulAddChainToConvOpPattern>(patterns.getContext(), am,
-                                               shiftParam);
+  patterns.add<FoldMulAddChainToConvOpPattern<arith::AddIOp>,
+               FoldMulAddChainToConvOpPattern<arith::AddFOp>>(
+      patterns.getContext(), am, shiftParam);
 }
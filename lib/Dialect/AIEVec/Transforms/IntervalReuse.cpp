@@ -15,6 +15,7 @@
 #include "aie/Dialect/AIEVec/Transforms/IntervalReuse.h"
 #include "aie/Dialect/AIEVec/AIEVecUtils.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
 
 using namespace mlir;
 using namespace xilinx::aievec;
@@ -132,23 +133,29 @@ bool IntervalReuse::potentialReuse(
 // N+7]. The returned bounds are vector size aligned. This means that if the
 // access is A[N+1:N+8], and the vector size is 256 bits, then the returned
 // bound is [N:N+15]. We assume that each row of the array is properly aligned.
+// If the enclosing loop is strided, i.e., loopStepSize > 1, consecutive lanes
+// read elements loopStepSize apart, so the read A[N:N+14:2] of a 1x8 vector
+// has the bound [N, N+15].
 static std::pair<int32_t, int32_t>
 computeAccessExtent(vector::TransferReadOp readOp, int32_t offset,
                     int32_t loopStepSize, bool isSplat, unsigned minVecSize) {
   VectorType vType = readOp.getResult().getType().cast<VectorType>();
   unsigned vecSize = getVectorLaneSize(vType);
   int32_t elementSizeInBits = getElementSizeInBits(vType);
-  // Create chunks greater in size than minVecSize
-  int32_t vecSizeInBits = std::max(minVecSize, vecSize * elementSizeInBits);
+  // Create chunks greater in size than minVecSize. AIE vectors are a power of
+  // two in size, so the chunks of a read with a non-power-of-two vectorization
+  // factor are rounded up to the next power of two.
+  int32_t vecSizeInBits =
+      llvm::PowerOf2Ceil(std::max(minVecSize, vecSize * elementSizeInBits));
+  int32_t alignedVecSize = llvm::PowerOf2Ceil(vecSize);
 
-  assert(isPowerOfTwo(vecSizeInBits) &&
-         "Current support is only for power-of-two vector sizes");
+  // Number of elements spanned by the lanes of the read
+  int32_t span = loopStepSize > 1 ? loopStepSize * (vecSize - 1) + 1
+                                  : loopStepSize * vecSize;
 
-  // Below computation is base on the assumption that vectorization factor is
-  // always a power of 2.
   int32_t lb = (offset * elementSizeInBits) & ~(vecSizeInBits - 1);
-  int32_t ub = (isSplat ? (offset & ~(vecSize - 1)) + vecSize
-                        : offset + loopStepSize * vecSize) *
+  int32_t ub = (isSplat ? (offset & ~(alignedVecSize - 1)) + alignedVecSize
+                        : offset + span) *
                elementSizeInBits;
   // Adjust to the nearest multiple of vecSizeInBits
   ub = (ub + vecSizeInBits - 1) & ~(vecSizeInBits - 1);
@@ -0,0 +1,208 @@
+//===- AIETargetChessLLVMIR.cpp ---------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// Translate the lowered code of a core to LLVM IR that xchesscc accepts.
+// xchesscc is built on an older LLVM, so the module is linked with the chess
+// intrinsic wrapper, attributes the older LLVM doesn't know are removed, and
+// the textual IR is rewritten where the newer LLVM prints syntax that the
+// older one can't parse.
+//
+//===----------------------------------------------------------------------===//
+
+#include "AIETargets.h"
+
+#include "mlir/Target/LLVMIR/Export.h"
+
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Linker/Linker.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Regex.h"
+#include "llvm/Support/SourceMgr.h"
+
+using namespace mlir;
+
+namespace xilinx {
+namespace AIE {
+
+// Read the intrinsic wrapper generated by xchesscc.  It comes from the older
+// LLVM as well, so drop its target description (the core module's is used
+// instead) and the attributes that the newer LLVM can't parse.
+static std::unique_ptr<llvm::Module>
+parseIntrinsicWrapper(StringRef filename, llvm::LLVMContext &llvmContext,
+                      ModuleOp module) {
+  auto buffer = llvm::MemoryBuffer::getFile(filename);
+  if (!buffer) {
+    module.emitOpError("cannot open intrinsic wrapper '")
+        << filename << "': " << buffer.getError().message();
+    return nullptr;
+  }
+
+  SmallVector<StringRef> lines;
+  (*buffer)->getBuffer().split(lines, '\n');
+  llvm::Regex unsupported("(noalias_sidechannel|nocallback)[^,]*,");
+  std::string text;
+  for (StringRef line : lines) {
+    if (line.startswith("target"))
+      continue;
+    std::string legal = line.str();
+    while (unsupported.match(legal))
+      legal = unsupported.sub("", legal);
+    text += legal + "\n";
+  }
+
+  llvm::SMDiagnostic err;
+  auto wrapper = llvm::parseIR(llvm::MemoryBufferRef(text, filename), err,
+                               llvmContext);
+  if (!wrapper) {
+    std::string message;
+    llvm::raw_string_ostream os(message);
+    err.print(filename.data(), os);
+    module.emitOpError("cannot parse intrinsic wrapper: ") << os.str();
+  }
+  return wrapper;
+}
+
+// Remove the attributes that were introduced after the LLVM xchesscc is
+// based on, from functions and call sites alike.
+static void stripUnsupportedAttributes(llvm::Module &llvmModule) {
+  const llvm::Attribute::AttrKind fnAttrs[] = {llvm::Attribute::MustProgress,
+                                              llvm::Attribute::NoCallback};
+  for (llvm::Function &f : llvmModule) {
+    for (auto kind : fnAttrs)
+      f.removeFnAttr(kind);
+    f.removeRetAttr(llvm::Attribute::NoUndef);
+    for (unsigned i = 0; i < f.arg_size(); i++)
+      f.removeParamAttr(i, llvm::Attribute::NoUndef);
+
+    for (llvm::Instruction &inst : llvm::instructions(f)) {
+      auto *call = dyn_cast<llvm::CallBase>(&inst);
+      if (!call)
+        continue;
+      for (auto kind : fnAttrs)
+        call->removeFnAttr(kind);
+      call->removeRetAttr(llvm::Attribute::NoUndef);
+      for (unsigned i = 0; i < call->arg_size(); i++)
+        call->removeParamAttr(i, llvm::Attribute::NoUndef);
+    }
+  }
+}
+
+// Return `constant` with the poison values in it replaced by undef, as poison
+// has no older equivalent.
+static llvm::Constant *replacePoison(llvm::Constant *constant) {
+  if (isa<llvm::PoisonValue>(constant))
+    return llvm::UndefValue::get(constant->getType());
+  if (!isa<llvm::ConstantAggregate>(constant))
+    return constant;
+
+  SmallVector<llvm::Constant *> elements;
+  bool changed = false;
+  for (llvm::Value *operand : constant->operands()) {
+    auto *element = cast<llvm::Constant>(operand);
+    elements.push_back(replacePoison(element));
+    changed |= elements.back() != element;
+  }
+  if (!changed)
+    return constant;
+  if (auto *structType = dyn_cast<llvm::StructType>(constant->getType()))
+    return llvm::ConstantStruct::get(structType, elements);
+  if (auto *arrayType = dyn_cast<llvm::ArrayType>(constant->getType()))
+    return llvm::ConstantArray::get(arrayType, elements);
+  return llvm::ConstantVector::get(elements);
+}
+
+// Rewrite the values that the older LLVM can't parse: poison becomes undef,
+// and the arguments of function definitions, whose numbered names the older
+// parser rejects, are named.
+static void legalizeValues(llvm::Module &llvmModule) {
+  for (llvm::GlobalVariable &global : llvmModule.globals())
+    if (global.hasInitializer())
+      global.setInitializer(replacePoison(global.getInitializer()));
+
+  for (llvm::Function &f : llvmModule) {
+    if (f.isDeclaration())
+      continue;
+    for (llvm::Argument &arg : f.args())
+      if (!arg.hasName())
+        arg.setName("arg" + Twine(arg.getArgNo()));
+    for (llvm::Instruction &inst : llvm::instructions(f))
+      for (llvm::Use &use : inst.operands())
+        if (auto *constant = dyn_cast<llvm::Constant>(use.get()))
+          if (!isa<llvm::GlobalValue>(constant))
+            use.set(replacePoison(constant));
+  }
+}
+
+// Rewrite a line of printed IR into the syntax of the older LLVM, which
+// spells memory effects as attributes rather than memory(...).
+static std::string legalizeLine(StringRef line) {
+  static const std::pair<StringRef, StringRef> memoryAttrs[] = {
+      {"memory(none)", "readnone"},
+      {"memory(read)", "readonly"},
+      {"memory(write)", "writeonly"},
+      {"memory(argmem: readwrite)", "argmemonly"},
+      {"memory(argmem: read)", "argmemonly readonly"},
+      {"memory(argmem: write)", "argmemonly writeonly"},
+      {"memory(inaccessiblemem: readwrite)", "inaccessiblememonly"},
+      {"memory(inaccessiblemem: read)", "inaccessiblememonly readonly"},
+      {"memory(inaccessiblemem: write)", "inaccessiblememonly writeonly"},
+      {"memory(argmem: readwrite, inaccessiblemem: readwrite)",
+       "inaccessiblemem_or_argmemonly"},
+      {"memory(argmem: read, inaccessiblemem: read)",
+       "inaccessiblemem_or_argmemonly readonly"},
+      {"memory(argmem: write, inaccessiblemem: write)",
+       "inaccessiblemem_or_argmemonly writeonly"}};
+
+  std::string legal = line.str();
+  for (auto &[from, to] : memoryAttrs) {
+    size_t pos;
+    while ((pos = legal.find(from.str())) != std::string::npos)
+      legal.replace(pos, from.size(), to.str());
+  }
+  return legal;
+}
+
+LogicalResult AIETranslateToChessLLVMIR(ModuleOp module, raw_ostream &output,
+                                        StringRef intrinsicWrapper) {
+  llvm::LLVMContext llvmContext;
+  auto llvmModule = translateModuleToLLVMIR(module, llvmContext);
+  if (!llvmModule)
+    return module.emitOpError("failed to translate to LLVM IR");
+
+  if (!intrinsicWrapper.empty()) {
+    auto wrapper = parseIntrinsicWrapper(intrinsicWrapper, llvmContext, module);
+    if (!wrapper)
+      return failure();
+    wrapper->setDataLayout(llvmModule->getDataLayout());
+    wrapper->setTargetTriple(llvmModule->getTargetTriple());
+    if (llvm::Linker::linkModules(*llvmModule, std::move(wrapper)))
+      return module.emitOpError("failed to link the intrinsic wrapper");
+  }
+
+  stripUnsupportedAttributes(*llvmModule);
+  legalizeValues(*llvmModule);
+
+  std::string text;
+  llvm::raw_string_ostream os(text);
+  llvmModule->print(os, nullptr);
+  SmallVector<StringRef> lines;
+  StringRef(os.str()).split(lines, '\n');
+  for (StringRef line : lines)
+    output << legalizeLine(line) << "\n";
+  return success();
+}
+
+} // namespace AIE
+} // namespace xilinx
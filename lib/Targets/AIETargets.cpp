@@ -19,6 +19,7 @@
 #include "mlir/IR/Location.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Pass/Pass.h"
+#include "mlir/Target/LLVMIR/Dialect/All.h"
 #include "mlir/Target/LLVMIR/Export.h"
 #include "mlir/Target/LLVMIR/Import.h"
 #include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
@@ -47,6 +48,10 @@ static llvm::cl::opt<int>
 static llvm::cl::opt<int>
     tileRow("tilerow", llvm::cl::desc("row coordinate of core to translate"),
             llvm::cl::init(0));
+static llvm::cl::opt<std::string> chessIntrinsicWrapper(
+    "chess-intrinsic-wrapper",
+    llvm::cl::desc("LLVM IR of the chess intrinsic wrapper to link with"),
+    llvm::cl::init(""));
 
 llvm::json::Value attrToJSON(Attribute &attr) {
   if (auto a = attr.dyn_cast<StringAttr>()) {
@@ -126,6 +131,225 @@ void writeLDScriptMap(raw_ostream &output, BufferOp buf, int offset,
   output << ". += 0x" << llvm::utohexstr(numBytes) << ";\n";
 }
 
+LogicalResult AIETranslateToLdScript(ModuleOp module, raw_ostream &output,
+                                     int tileCol, int tileRow) {
+  DenseMap<std::pair<int, int>, Operation *> tiles;
+  DenseMap<Operation *, CoreOp> cores;
+  DenseMap<Operation *, MemOp> mems;
+  DenseMap<std::pair<Operation *, int>, LockOp> locks;
+  DenseMap<Operation *, SmallVector<BufferOp, 4>> buffers;
+  DenseMap<Operation *, SwitchboxOp> switchboxes;
+
+  if (module.getOps<DeviceOp>().empty()) {
+    module.emitOpError("expected AIE.device operation at toplevel");
+  }
+  DeviceOp targetOp = *(module.getOps<DeviceOp>().begin());
+
+  NetlistAnalysis NL(targetOp, tiles, cores, mems, locks, buffers, switchboxes);
+  NL.collectTiles(tiles);
+  NL.collectBuffers(buffers);
+
+  for (auto tile : targetOp.getOps<TileOp>())
+    if (tile.colIndex() == tileCol && tile.rowIndex() == tileRow) {
+      auto srcCoord = std::make_pair(tile.colIndex(), tile.rowIndex());
+      const auto &target_model = getTargetModel(tile);
+
+      // Figure out how much memory we have left for random allocations
+      auto core = tile.getCoreOp();
+      int max = core.getStackSize();
+      for (auto buf : buffers[tiles[srcCoord]]) {
+        int bufferBaseAddr = NL.getBufferBaseAddress(buf);
+        int numBytes = buf.getAllocationSize();
+        max = std::max(max, bufferBaseAddr + numBytes);
+      }
+      int origin = target_model.getMemInternalBaseAddress(srcCoord) + max;
+      int length = target_model.getLocalMemorySize() - max;
+      // output << "// Tile(" << tileCol << ", " << tileRow << ")\n";
+      // output << "// Memory map: name base_address num_bytes\n";
+      output << R"THESCRIPT(
+MEMORY
+{
+   program (RX) : ORIGIN = 0, LENGTH = 0x0020000
+)THESCRIPT";
+      output << "   data (!RX) : ORIGIN = 0x" << llvm::utohexstr(origin)
+             << ", LENGTH = 0x" << llvm::utohexstr(length);
+      output << R"THESCRIPT(
+}
+ENTRY(_main_init)
+SECTIONS
+{
+  . = 0x0;
+  .text : { 
+     /* the _main_init symbol from me_basic.o has to come at address zero. */
+     *me_basic.o(.text)
+     . = 0x200;
+     _ctors_start = .;
+     _init_array_start = .;
+     KEEP(SORT(*.init_array))
+     _ctors_end = .;
+     _init_array_end = .;
+     _dtors_start = .;
+     _dtors_end = .;
+     *(.text)
+  } > program
+  .data : { 
+     *(.data*);
+     *(.rodata*)
+  } > data
+)THESCRIPT";
+      auto doBuffer = [&](Optional<TileID> tile, int offset, std::string dir) {
+        if (tile) {
+          if (tiles.count(*tile))
+            for (auto buf : buffers[tiles[*tile]])
+              writeLDScriptMap(output, buf, offset, NL);
+        } else {
+          output << "/* No tile with memory exists to the " << dir << ". */\n";
+          output << ". = 0x" << llvm::utohexstr(offset) << ";\n";
+          uint32_t localMemSize = target_model.getLocalMemorySize();
+          output << ". += 0x" << llvm::utohexstr(localMemSize) << ";\n";
+        }
+      };
+
+      // Stack
+      output << ". = 0x"
+             << llvm::utohexstr(
+                    target_model.getMemInternalBaseAddress(srcCoord))
+             << ";\n";
+      output << "_sp_start_value_DM_stack = .;\n";
+
+      if (auto core = tile.getCoreOp())
+        output << ". += 0x" << llvm::utohexstr(core.getStackSize())
+               << "; /* stack */\n";
+      else
+        output << "/* no stack allocated */\n";
+
+      doBuffer(target_model.getMemSouth(srcCoord),
+               target_model.getMemSouthBaseAddress(), std::string("south"));
+      doBuffer(target_model.getMemWest(srcCoord),
+               target_model.getMemWestBaseAddress(), std::string("west"));
+      doBuffer(target_model.getMemNorth(srcCoord),
+               target_model.getMemNorthBaseAddress(), std::string("north"));
+      doBuffer(target_model.getMemEast(srcCoord),
+               target_model.getMemEastBaseAddress(), std::string("east"));
+
+      output << "  .bss : { *(.bss) } > data\n";
+      output << "  .bss.DMb.4 : { *(.bss.DMb.4) } > data\n";
+      output << "}\n";
+      if (auto coreOp = tile.getCoreOp()) {
+        if (auto fileAttr = coreOp->getAttrOfType<StringAttr>("link_with")) {
+          auto fileName = std::string(fileAttr.getValue());
+          output << "INPUT(" << fileName << ")\n";
+        }
+        output << "PROVIDE(_main = core_" << tile.getCol() << "_"
+               << tile.getRow() << ");\n";
+      }
+    }
+  return success();
+}
+
+LogicalResult AIETranslateToBCF(ModuleOp module, raw_ostream &output,
+                                int tileCol, int tileRow) {
+  DenseMap<std::pair<int, int>, Operation *> tiles;
+  DenseMap<Operation *, CoreOp> cores;
+  DenseMap<Operation *, MemOp> mems;
+  DenseMap<std::pair<Operation *, int>, LockOp> locks;
+  DenseMap<Operation *, SmallVector<BufferOp, 4>> buffers;
+  DenseMap<Operation *, SwitchboxOp> switchboxes;
+
+  if (module.getOps<DeviceOp>().empty()) {
+    module.emitOpError("expected AIE.device operation at toplevel");
+  }
+  DeviceOp targetOp = *(module.getOps<DeviceOp>().begin());
+
+  NetlistAnalysis NL(targetOp, tiles, cores, mems, locks, buffers, switchboxes);
+  NL.collectTiles(tiles);
+  NL.collectBuffers(buffers);
+
+  // _entry_point _main_init
+  // _symbol      _main _after _main_init
+  // _symbol      _main_init 0
+  // _reserved DMb      0x00000 0x20000
+  // _symbol   a        0x38000 0x2000
+  // _extern   a
+  // _stack    DM_stack 0x20000  0x400 //stack for core
+  // _reserved DMb 0x40000 0xc0000 // And everything else the core can't
+  // see
+  // // Include all symbols from rom.c
+  // _include _file rom.o
+  for (auto tile : targetOp.getOps<TileOp>())
+    if (tile.colIndex() == tileCol && tile.rowIndex() == tileRow) {
+      const auto &target_model = getTargetModel(tile);
+
+      std::string corefunc = std::string("core_") +
+                             std::to_string(tile.getCol()) + "_" +
+                             std::to_string(tile.getRow());
+      output << "_entry_point _main_init\n";
+      output << "_symbol " << corefunc << " _after _main_init\n";
+      output << "_symbol      _main_init 0\n";
+      std::string initReserved =
+          (target_model.getTargetArch() == AIEArch::AIE2) ? "0x40000"
+                                                          : "0x20000";
+      output << "_reserved DMb      0x00000 " << initReserved
+             << " //Don't put data in code memory\n";
+
+      auto srcCoord = std::make_pair(tile.colIndex(), tile.rowIndex());
+      auto doBuffer = [&](Optional<TileID> tile, int offset, std::string dir) {
+        if (tile) {
+          if (tiles.count(*tile))
+            for (auto buf : buffers[tiles[*tile]])
+              writeBCFMap(output, buf, offset, NL);
+          uint32_t localMemSize = target_model.getLocalMemorySize();
+          if (tile != srcCoord)
+            output << "_reserved DMb 0x" << llvm::utohexstr(offset) << " "
+                   << "0x" << llvm::utohexstr(localMemSize) << " "
+                   << " // Don't allocate variables outside of local "
+                      "memory.\n";
+          // TODO How to set as reserved if no buffer exists (or reserve
+          // remaining buffer)
+        } else {
+          uint32_t localMemSize = target_model.getLocalMemorySize();
+          output << "_reserved DMb 0x" << llvm::utohexstr(offset) << " "
+                 << "0x" << llvm::utohexstr(localMemSize) << " "
+                 << " // No tile with memory exists to the " << dir << ".\n";
+        }
+      };
+
+      doBuffer(target_model.getMemSouth(srcCoord),
+               target_model.getMemSouthBaseAddress(), std::string("south"));
+      doBuffer(target_model.getMemWest(srcCoord),
+               target_model.getMemWestBaseAddress(), std::string("west"));
+      doBuffer(target_model.getMemNorth(srcCoord),
+               target_model.getMemNorthBaseAddress(), std::string("north"));
+      doBuffer(target_model.getMemEast(srcCoord),
+               target_model.getMemEastBaseAddress(), std::string("east"));
+
+      int stacksize = 0;
+      if (auto core = tile.getCoreOp())
+        stacksize = core.getStackSize();
+      output << "_stack    DM_stack 0x"
+             << llvm::utohexstr(
+                    target_model.getMemInternalBaseAddress(srcCoord))
+             << "  0x" << llvm::utohexstr(stacksize) << " //stack for core\n";
+
+      if (target_model.getTargetArch() == AIEArch::AIE2) {
+        output << "_reserved DMb 0x80000 0x80000 // And everything else "
+                  "the core can't see\n";
+      } else {
+        output << "_reserved DMb 0x40000 0xc0000 // And everything else "
+                  "the core can't see\n";
+      }
+      if (auto coreOp = tile.getCoreOp()) {
+        if (auto fileAttr = coreOp->getAttrOfType<StringAttr>("link_with")) {
+          auto fileName = std::string(fileAttr.getValue());
+          output << "_include _file " << fileName << "\n";
+        }
+      }
+      output << "_resolve _main core_" << tile.getCol() << "_"
+             << tile.getRow() << "\n";
+    }
+  return success();
+}
+
 void registerAIETranslations() {
   TranslateFromMLIRRegistration registrationMMap(
       "aie-generate-mmap", "Generate AIE memory map",
@@ -238,124 +462,7 @@ void registerAIETranslations() {
   TranslateFromMLIRRegistration registrationLDScript(
       "aie-generate-ldscript", "Generate AIE loader script",
       [](ModuleOp module, raw_ostream &output) {
-        DenseMap<std::pair<int, int>, Operation *> tiles;
-        DenseMap<Operation *, CoreOp> cores;
-        DenseMap<Operation *, MemOp> mems;
-        DenseMap<std::pair<Operation *, int>, LockOp> locks;
-        DenseMap<Operation *, SmallVector<BufferOp, 4>> buffers;
-        DenseMap<Operation *, SwitchboxOp> switchboxes;
-
-        if (module.getOps<DeviceOp>().empty()) {
-          module.emitOpError("expected AIE.device operation at toplevel");
-        }
-        DeviceOp targetOp = *(module.getOps<DeviceOp>().begin());
-
-        NetlistAnalysis NL(targetOp, tiles, cores, mems, locks, buffers,
-                           switchboxes);
-        NL.collectTiles(tiles);
-        NL.collectBuffers(buffers);
-
-        for (auto tile : targetOp.getOps<TileOp>())
-          if (tile.colIndex() == tileCol && tile.rowIndex() == tileRow) {
-            auto srcCoord = std::make_pair(tile.colIndex(), tile.rowIndex());
-            const auto &target_model = getTargetModel(tile);
-
-            // Figure out how much memory we have left for random allocations
-            auto core = tile.getCoreOp();
-            int max = core.getStackSize();
-            for (auto buf : buffers[tiles[srcCoord]]) {
-              int bufferBaseAddr = NL.getBufferBaseAddress(buf);
-              int numBytes = buf.getAllocationSize();
-              max = std::max(max, bufferBaseAddr + numBytes);
-            }
-            int origin = target_model.getMemInternalBaseAddress(srcCoord) + max;
-            int length = target_model.getLocalMemorySize() - max;
-            // output << "// Tile(" << tileCol << ", " << tileRow << ")\n";
-            // output << "// Memory map: name base_address num_bytes\n";
-            output << R"THESCRIPT(
-MEMORY
-{
-   program (RX) : ORIGIN = 0, LENGTH = 0x0020000
-)THESCRIPT";
-            output << "   data (!RX) : ORIGIN = 0x" << llvm::utohexstr(origin)
-                   << ", LENGTH = 0x" << llvm::utohexstr(length);
-            output << R"THESCRIPT(
-}
-ENTRY(_main_init)
-SECTIONS
-{
-  . = 0x0;
-  .text : { 
-     /* the _main_init symbol from me_basic.o has to come at address zero. */
-     *me_basic.o(.text)
-     . = 0x200;
-     _ctors_start = .;
-     _init_array_start = .;
-     KEEP(SORT(*.init_array))
-     _ctors_end = .;
-     _init_array_end = .;
-     _dtors_start = .;
-     _dtors_end = .;
-     *(.text)
-  } > program
-  .data : { 
-     *(.data*);
-     *(.rodata*)
-  } > data
-)THESCRIPT";
-            auto doBuffer = [&](Optional<TileID> tile, int offset,
-                                std::string dir) {
-              if (tile) {
-                if (tiles.count(*tile))
-                  for (auto buf : buffers[tiles[*tile]])
-                    writeLDScriptMap(output, buf, offset, NL);
-              } else {
-                output << "/* No tile with memory exists to the " << dir
-                       << ". */\n";
-                output << ". = 0x" << llvm::utohexstr(offset) << ";\n";
-                uint32_t localMemSize = target_model.getLocalMemorySize();
-                output << ". += 0x" << llvm::utohexstr(localMemSize) << ";\n";
-              }
-            };
-
-            // Stack
-            output << ". = 0x"
-                   << llvm::utohexstr(
-                          target_model.getMemInternalBaseAddress(srcCoord))
-                   << ";\n";
-            output << "_sp_start_value_DM_stack = .;\n";
-
-            if (auto core = tile.getCoreOp())
-              output << ". += 0x" << llvm::utohexstr(core.getStackSize())
-                     << "; /* stack */\n";
-            else
-              output << "/* no stack allocated */\n";
-
-            doBuffer(target_model.getMemSouth(srcCoord),
-                     target_model.getMemSouthBaseAddress(),
-                     std::string("south"));
-            doBuffer(target_model.getMemWest(srcCoord),
-                     target_model.getMemWestBaseAddress(), std::string("west"));
-            doBuffer(target_model.getMemNorth(srcCoord),
-                     target_model.getMemNorthBaseAddress(),
-                     std::string("north"));
-            doBuffer(target_model.getMemEast(srcCoord),
-                     target_model.getMemEastBaseAddress(), std::string("east"));
-
-            output << "  .bss : { *(.bss) } > data\n";
-            output << "  .bss.DMb.4 : { *(.bss.DMb.4) } > data\n";
-            output << "}\n";
-            if (auto coreOp = tile.getCoreOp()) {
-              if (auto fileAttr =
-                      coreOp->getAttrOfType<StringAttr>("link_with")) {
-                auto fileName = std::string(fileAttr.getValue());
-                output << "INPUT(" << fileName << ")\n";
-              }
-              output << "PROVIDE(_main = core_" << tile.getCol() << "_"
-                     << tile.getRow() << ");\n";
-            }
-          }
-        return success();
+        return AIETranslateToLdScript(module, output, tileCol, tileRow);
       },
       registerDialects);
 
@@ -371,115 +478,21 @@ SECTIONS
   TranslateFromMLIRRegistration registrationBCF(
       "aie-generate-bcf", "Generate AIE bcf",
       [](ModuleOp module, raw_ostream &output) {
-        DenseMap<std::pair<int, int>, Operation *> tiles;
-        DenseMap<Operation *, CoreOp> cores;
-        DenseMap<Operation *, MemOp> mems;
-        DenseMap<std::pair<Operation *, int>, LockOp> locks;
-        DenseMap<Operation *, SmallVector<BufferOp, 4>> buffers;
-        DenseMap<Operation *, SwitchboxOp> switchboxes;
-
-        if (module.getOps<DeviceOp>().empty()) {
-          module.emitOpError("expected AIE.device operation at toplevel");
-        }
-        DeviceOp targetOp = *(module.getOps<DeviceOp>().begin());
-
-        NetlistAnalysis NL(targetOp, tiles, cores, mems, locks, buffers,
-                           switchboxes);
-        NL.collectTiles(tiles);
-        NL.collectBuffers(buffers);
-
-        // _entry_point _main_init
-        // _symbol      _main _after _main_init
-        // _symbol      _main_init 0
-        // _reserved DMb      0x00000 0x20000
-        // _symbol   a        0x38000 0x2000
-        // _extern   a
-        // _stack    DM_stack 0x20000  0x400 //stack for core
-        // _reserved DMb 0x40000 0xc0000 // And everything else the core can't
-        // see
-        // // Include all symbols from rom.c
-        // _include _file rom.o
-        for (auto tile : targetOp.getOps<TileOp>())
-          if (tile.colIndex() == tileCol && tile.rowIndex() == tileRow) {
-            const auto &target_model = getTargetModel(tile);
-
-            std::string corefunc = std::string("core_") +
-                                   std::to_string(tile.getCol()) + "_" +
-                                   std::to_string(tile.getRow());
-            output << "_entry_point _main_init\n";
-            output << "_symbol " << corefunc << " _after _main_init\n";
-            output << "_symbol      _main_init 0\n";
-            std::string initReserved =
-                (target_model.getTargetArch() == AIEArch::AIE2) ? "0x40000"
-                                                                : "0x20000";
-            output << "_reserved DMb      0x00000 " << initReserved
-                   << " //Don't put data in code memory\n";
-
-            auto srcCoord = std::make_pair(tile.colIndex(), tile.rowIndex());
-            auto doBuffer = [&](Optional<TileID> tile, int offset,
-                                std::string dir) {
-              if (tile) {
-                if (tiles.count(*tile))
-                  for (auto buf : buffers[tiles[*tile]])
-                    writeBCFMap(output, buf, offset, NL);
-                uint32_t localMemSize = target_model.getLocalMemorySize();
-                if (tile != srcCoord)
-                  output << "_reserved DMb 0x" << llvm::utohexstr(offset) << " "
-                         << "0x" << llvm::utohexstr(localMemSize) << " "
-                         << " // Don't allocate variables outside of local "
-                            "memory.\n";
-                // TODO How to set as reserved if no buffer exists (or reserve
-                // remaining buffer)
-              } else {
-                uint32_t localMemSize = target_model.getLocalMemorySize();
-                output << "_reserved DMb 0x" << llvm::utohexstr(offset) << " "
-                       << "0x" << llvm::utohexstr(localMemSize) << " "
-                       << " // No tile with memory exists to the " << dir
-                       << ".\n";
-              }
-            };
-
-            doBuffer(target_model.getMemSouth(srcCoord),
-                     target_model.getMemSouthBaseAddress(),
-                     std::string("south"));
-            doBuffer(target_model.getMemWest(srcCoord),
-                     target_model.getMemWestBaseAddress(), std::string("west"));
-            doBuffer(target_model.getMemNorth(srcCoord),
-                     target_model.getMemNorthBaseAddress(),
-                     std::string("north"));
-            doBuffer(target_model.getMemEast(srcCoord),
-                     target_model.getMemEastBaseAddress(), std::string("east"));
-
-            int stacksize = 0;
-            if (auto core = tile.getCoreOp())
-              stacksize = core.getStackSize();
-            output << "_stack    DM_stack 0x"
-                   << llvm::utohexstr(
-                          target_model.getMemInternalBaseAddress(srcCoord))
-                   << "  0x" << llvm::utohexstr(stacksize)
-                   << " //stack for core\n";
-
-            if (target_model.getTargetArch() == AIEArch::AIE2) {
-              output << "_reserved DMb 0x80000 0x80000 // And everything else "
-                        "the core can't see\n";
-            } else {
-              output << "_reserved DMb 0x40000 0xc0000 // And everything else "
-                        "the core can't see\n";
-            }
-            if (auto coreOp = tile.getCoreOp()) {
-              if (auto fileAttr =
-                      coreOp->getAttrOfType<StringAttr>("link_with")) {
-                auto fileName = std::string(fileAttr.getValue());
-                output << "_include _file " << fileName << "\n";
-              }
-            }
-            output << "_resolve _main core_" << tile.getCol() << "_"
-                   << tile.getRow() << "\n";
-          }
-        return success();
+        return AIETranslateToBCF(module, output, tileCol, tileRow);
       },
       registerDialects);
 
+  TranslateFromMLIRRegistration registrationChessLLVMIR(
+      "aie-generate-chess-llvmir",
+      "Translate lowered core code to LLVM IR for xchesscc",
+      [](ModuleOp module, raw_ostream &output) {
+        return AIETranslateToChessLLVMIR(module, output, chessIntrinsicWrapper);
+      },
+      [](DialectRegistry &registry) {
+        registry.insert<DLTIDialect, func::FuncDialect>();
+        registerAllToLLVMIRTranslations(registry);
+      });
+
   TranslateFromMLIRRegistration registrationTargetArch(
       "aie-generate-target-arch", "Get the target architecture",
       [](ModuleOp module, raw_ostream &output) {
@@ -521,6 +534,34 @@ SECTIONS
       },
       registerDialects);
 
+  TranslateFromMLIRRegistration registrationCoreOptions(
+      "aie-generate-core-options",
+      "Generate python dictionary of per-core compile options",
+      [](ModuleOp module, raw_ostream &output) {
+        if (module.getOps<DeviceOp>().empty())
+          return module.emitOpError(
+              "expected AIE.device operation at toplevel");
+        DeviceOp targetOp = *(module.getOps<DeviceOp>().begin());
+
+        output << "{";
+        for (auto coreOp : targetOp.getOps<CoreOp>()) {
+          auto options =
+              coreOp->getAttrOfType<DictionaryAttr>("compile_options");
+          if (!options)
+            continue;
+          output << '(' << coreOp.colIndex() << ',' << coreOp.rowIndex()
+                 << "):{";
+          for (NamedAttribute option : options)
+            if (auto value = option.getValue().dyn_cast<IntegerAttr>())
+              output << '\'' << option.getName().getValue()
+                     << "':" << value.getInt() << ',';
+          output << "},";
+        }
+        output << "}\n";
+        return success();
+      },
+      registerDialects);
+
   TranslateFromMLIRRegistration registrationXADF(
       "adf-generate-cpp-graph", "Translate ADFDialect to C++ graph",
       ADFGenerateCPPGraph, [](DialectRegistry &registry) {
@@ -26,5 +26,8 @@ mlir::LogicalResult AIETranslateShimSolution(mlir::ModuleOp module,
                                              llvm::raw_ostream &);
 mlir::LogicalResult AIETranslateGraphXPE(mlir::ModuleOp module,
                                          llvm::raw_ostream &);
+mlir::LogicalResult AIETranslateToChessLLVMIR(mlir::ModuleOp module,
+                                              llvm::raw_ostream &output,
+                                              llvm::StringRef intrinsicWrapper);
 }
 }
@@ -27,6 +27,8 @@
 #include "mlir/Support/IndentedOstream.h"
 #include "mlir/Support/MathExtras.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/TypeSwitch.h"
@@ -150,6 +152,12 @@ struct CppEmitter {
   // Return true if the specified dim of memref is parametric
   bool isMemRefDimParam(Value memref, unsigned index);
 
+  // Record that the memory of memref may be accessed through another pointer
+  void setMayAlias(Value memref) { aliasingMemRefs.insert(memref); }
+
+  // Return true if memref can't be accessed through a restrict pointer
+  bool mayAlias(Value memref) { return aliasingMemRefs.contains(memref); }
+
   /// Return the existing or a new label of a Block.
   StringRef getOrCreateName(Block &block, std::string prefix = "label");
 
@@ -209,6 +217,9 @@ private:
   /// Map from a dynamic memref index to the parameter
   DenseMap<std::pair<Value, unsigned>, std::string> paramIndexMapper;
 
+  /// Memref arguments that may alias another memref argument
+  DenseSet<Value> aliasingMemRefs;
+
   /// The number of values in the current scope. This is used to declare the
   /// names of values in a scope.
   std::stack<int64_t> valueInScopeCount;
@@ -396,6 +407,84 @@ static bool isReadOnly(Value read) {
   return true;
 }
 
+static DenseSet<unsigned>
+getAliasingMemRefArgs(func::FuncOp funcOp,
+                      SmallPtrSetImpl<Operation *> &visiting);
+
+// Return true if the two memrefs passed at a call site may share memory. They
+// are known to be disjoint if each comes from its own allocation, AIE buffer,
+// or global, or is a non-aliasing memref argument of the caller.
+static bool mayAlias(Value lhs, Value rhs,
+                     SmallPtrSetImpl<Operation *> &visiting) {
+  if (lhs == rhs)
+    return true;
+  auto isAllocation = [](Value value) {
+    Operation *op = value.getDefiningOp();
+    return op && (isa<memref::AllocOp, memref::AllocaOp>(op) ||
+                  op->getName().getStringRef() == "AIE.buffer");
+  };
+  auto isDisjointArg = [&](Value value) {
+    auto arg = value.dyn_cast<BlockArgument>();
+    if (!arg)
+      return false;
+    auto funcOp = dyn_cast<func::FuncOp>(arg.getOwner()->getParentOp());
+    if (!funcOp || arg.getOwner() != &funcOp.front())
+      return false;
+    return !getAliasingMemRefArgs(funcOp, visiting)
+                .contains(arg.getArgNumber());
+  };
+  auto lhsGlobal = lhs.getDefiningOp<memref::GetGlobalOp>();
+  auto rhsGlobal = rhs.getDefiningOp<memref::GetGlobalOp>();
+  if (lhsGlobal && rhsGlobal)
+    return lhsGlobal.getName() == rhsGlobal.getName();
+  // A fresh allocation can't overlap anything else
+  if (isAllocation(lhs) || isAllocation(rhs))
+    return !((isAllocation(lhs) || lhsGlobal || isDisjointArg(lhs)) &&
+             (isAllocation(rhs) || rhsGlobal || isDisjointArg(rhs)));
+  // An argument may point to a global, but not to another disjoint argument
+  return !(isDisjointArg(lhs) && isDisjointArg(rhs));
+}
+
+// Collect the memref arguments of the function that may alias another memref
+// argument at one of its call sites in the module. Such arguments can't be
+// declared restrict. If the function is never called from the module, its
+// memref arguments are assumed not to alias.
+static DenseSet<unsigned>
+getAliasingMemRefArgs(func::FuncOp funcOp,
+                      SmallPtrSetImpl<Operation *> &visiting) {
+  DenseSet<unsigned> aliasing;
+  auto moduleOp = funcOp->getParentOfType<ModuleOp>();
+  if (!moduleOp)
+    return aliasing;
+
+  // Be conservative on recursive calls
+  if (!visiting.insert(funcOp).second) {
+    for (unsigned i = 0; i < funcOp.getNumArguments(); ++i)
+      aliasing.insert(i);
+    return aliasing;
+  }
+
+  moduleOp.walk([&](func::CallOp callOp) {
+    if (callOp.getCallee() != funcOp.getName())
+      return;
+    auto operands = callOp.getOperands();
+    for (unsigned i = 0; i < operands.size(); ++i) {
+      if (!isa<MemRefType>(operands[i].getType()))
+        continue;
+      for (unsigned j = i + 1; j < operands.size(); ++j) {
+        if (!isa<MemRefType>(operands[j].getType()))
+          continue;
+        if (mayAlias(operands[i], operands[j], visiting)) {
+          aliasing.insert(i);
+          aliasing.insert(j);
+        }
+      }
+    }
+  });
+  visiting.erase(funcOp);
+  return aliasing;
+}
+
 //===----------------------------------------------------------------------===//
 // Print non-AIE dialect ops
 //===----------------------------------------------------------------------===//
@@ -532,7 +621,7 @@ static LogicalResult printOperation(CppEmitter &emitter, aievec::UPDOp updOp) {
     if (!emitter.hasValueInScope(result))
       return failure();
     // If the source array of upd is read-only, load from restrict pointer
-    bool readOnly = isReadOnly(source);
+    bool readOnly = isReadOnly(source) && !emitter.mayAlias(source);
     std::string restrictPrefix =
         readOnly ? ("r_" + emitter.getOrCreateName(result).str() + "_") : "";
     // Create a restrict pointer
@@ -1294,8 +1383,8 @@ static LogicalResult printOperation(CppEmitter &emitter,
   int32_t lsize = getElementSizeInBits(lhsType);
   auto iType = eltType.dyn_cast<IntegerType>();
 
-  // Only support int16 and int8 cases
-  if (!iType || !(lsize == 16 || lsize == 8)) {
+  // Only support int16, int8 and bfloat16 cases
+  if (!(iType && (lsize == 16 || lsize == 8)) && !eltType.isBF16()) {
     return failure();
   }
 
@@ -1669,8 +1758,8 @@ static LogicalResult printOperation(CppEmitter &emitter,
   int32_t lsize = getElementSizeInBits(lhsType);
   auto iType = eltType.dyn_cast<IntegerType>();
 
-  // Only support int16 and int8 cases
-  if (!iType || !(lsize == 16 || lsize == 8)) {
+  // Only support int16, int8 and bfloat16 cases
+  if (!(iType && (lsize == 16 || lsize == 8)) && !eltType.isBF16()) {
     return failure();
   }
 
@@ -1702,6 +1791,62 @@ static LogicalResult printOperation(CppEmitter &emitter,
   return success();
 }
 
+// Generate the matrix-multiply intrinsics for AIE-ML
+static LogicalResult printOperation(CppEmitter &emitter,
+                                    aievec::MatMulOp matmulOp) {
+  if (!AIEML)
+    return failure();
+
+  auto acc = matmulOp.getAcc();
+  auto lhs = matmulOp.getLhs();
+  auto rhs = matmulOp.getRhs();
+
+  // The sources should have already been emitted
+  if (!emitter.hasValueInScope(acc) || !emitter.hasValueInScope(lhs) ||
+      !emitter.hasValueInScope(rhs))
+    return failure();
+
+  // Create opname based on the lhs and rhs shape
+  VectorType lhsType = lhs.getType().cast<VectorType>();
+  VectorType rhsType = rhs.getType().cast<VectorType>();
+  int64_t M = lhsType.getDimSize(0);
+  int64_t K = lhsType.getDimSize(1);
+  int64_t N = rhsType.getDimSize(1);
+  std::string opname = "mac_" + std::to_string(M) + "x" + std::to_string(K) +
+                       "_" + std::to_string(K) + "x" + std::to_string(N);
+
+  // The accumulator is kept in a vector register between intrinsics, so it
+  // is moved in and out of an accumulator register around the intrinsic.
+  VectorType accType = acc.getType().cast<VectorType>();
+  Type accEltType = accType.getElementType();
+  int64_t lanes = accType.getNumElements();
+  std::string accTypeName = "v" + std::to_string(lanes);
+  std::string vecTypeName = accTypeName;
+  if (accEltType.isa<FloatType>()) {
+    accTypeName += "accfloat";
+    vecTypeName += "float";
+  } else {
+    unsigned width = accEltType.getIntOrFloatBitWidth();
+    accTypeName += "acc" + std::to_string(width);
+    vecTypeName += "int" + std::to_string(width);
+  }
+
+  raw_indented_ostream &os = emitter.ostream();
+
+  if (failed(emitter.emitAssignPrefix(*matmulOp)))
+    return failure();
+
+  os << vecTypeName << "(" << opname << "(";
+  os << emitter.getOrCreateName(lhs);
+  os << ", ";
+  os << emitter.getOrCreateName(rhs);
+  os << ", ";
+  os << accTypeName << "(" << emitter.getOrCreateName(acc) << ")";
+  os << "))";
+
+  return success();
+}
+
 // Generate the comparison intrinsics(eq, ne, lt, le, gt, ge) for AIE-ML
 static LogicalResult printOperation(CppEmitter &emitter, aievec::CmpOp cmpOp) {
   if (!AIEML) {
@@ -1854,6 +1999,23 @@ static LogicalResult printOperation(CppEmitter &emitter,
 }
 
 // Generate the memref store op
+// Print a vector.shape_cast as a copy. Vectors are emitted as flat vectors
+// regardless of their shape, so the cast doesn't change the data.
+static LogicalResult printOperation(CppEmitter &emitter,
+                                    vector::ShapeCastOp shapeCastOp) {
+  Value source = shapeCastOp.getSource();
+
+  // The source should have already been emitted
+  if (!emitter.hasValueInScope(source))
+    return failure();
+
+  if (failed(emitter.emitAssignPrefix(*shapeCastOp)))
+    return failure();
+
+  emitter.ostream() << emitter.getOrCreateName(source);
+  return success();
+}
+
 static LogicalResult printOperation(CppEmitter &emitter,
                                     memref::StoreOp storeOp) {
   Value value = storeOp.getValue();
@@ -2125,15 +2287,15 @@ static LogicalResult printOperation(CppEmitter &emitter, scf::ForOp forOp) {
   auto tc = getTripCount(forOp);
   if (tc.first) {
     auto step = getStep(forOp);
-    int64_t lb =
-        step.first && step.second > 0 ? floorDiv(tc.second, step.second) : 1;
-    int64_t ub =
-        step.first && step.second > 0 ? ceilDiv(tc.second, step.second) : 0;
+    // With a known step, the loop runs exactly ceil(tc / step) times, so the
+    // compiler can pipeline it without a remainder check
+    bool knownStep = step.first && step.second > 0;
+    int64_t iterations = knownStep ? ceilDiv(tc.second, step.second) : 1;
     os << "chess_loop_range(";
-    os << std::to_string(lb);
+    os << std::to_string(iterations);
     os << ", ";
-    if (step.first && step.second > 0)
-      os << std::to_string(ub);
+    if (knownStep)
+      os << std::to_string(iterations);
     os << ")\n";
   }
   os << "{\n";
@@ -2292,16 +2454,37 @@ static LogicalResult printOperation(CppEmitter &emitter,
     return failure();
 
   raw_indented_ostream &os = emitter.ostream();
+  // Declarations of runtime library functions with C linkage, e.g., the vector
+  // math ones, are marked as such.
+  if (functionOp.isDeclaration() && functionOp->hasAttr("aie.c_linkage"))
+    os << "extern \"C\" ";
   if (failed(emitter.emitTypes(functionOp.getLoc(),
                                functionOp.getFunctionType().getResults())))
     return failure();
   os << " " << functionOp.getName();
 
+  // Memref arguments are printed as restrict pointers, unless a call site
+  // may pass them overlapping memory.
+  SmallPtrSet<Operation *, 4> visiting;
+  DenseSet<unsigned> aliasingArgs =
+      getAliasingMemRefArgs(functionOp, visiting);
+  auto emitArgType = [&](unsigned index, Type type) -> LogicalResult {
+    auto memRefType = dyn_cast<MemRefType>(type);
+    if (!memRefType || !aliasingArgs.contains(index))
+      return emitter.emitType(functionOp.getLoc(), type);
+    if (failed(emitter.emitType(functionOp.getLoc(),
+                                memRefType.getElementType())))
+      return failure();
+    os << " *";
+    return success();
+  };
+
   os << "(";
   if (functionOp.isDeclaration()) {
+    unsigned index = 0;
     if (failed(interleaveCommaWithError(
             functionOp.getArgumentTypes(), os, [&](Type type) -> LogicalResult {
-              if (failed(emitter.emitType(functionOp.getLoc(), type)))
+              if (failed(emitArgType(index++, type)))
                 return failure();
               // If it is a memref argument, we need to check if it has dynamic
               // shape. If so, the dimensions have to be printed out
@@ -2320,8 +2503,10 @@ static LogicalResult printOperation(CppEmitter &emitter,
   if (failed(interleaveCommaWithError(
           functionOp.getArguments(), os,
           [&](BlockArgument arg) -> LogicalResult {
-            if (failed(emitter.emitType(functionOp.getLoc(), arg.getType())))
+            if (failed(emitArgType(arg.getArgNumber(), arg.getType())))
               return failure();
+            if (aliasingArgs.contains(arg.getArgNumber()))
+              emitter.setMayAlias(arg);
             os << " " << emitter.getOrCreateName(arg);
             // If it is a memref argument, we need to check if it has dynamic
             // shape. If so, the dimensions have to be printed out
@@ -2846,7 +3031,7 @@ LogicalResult CppEmitter::emitOperation(Operation &op, bool trailingSemicolon) {
           .Case<arith::AddIOp>(
               [&](auto op) { return printOperation<arith::AddIOp>(*this, op); })
           // Vector ops.
-          .Case<vector::TransferWriteOp>(
+          .Case<vector::ShapeCastOp, vector::TransferWriteOp>(
               [&](auto op) { return printOperation(*this, op); })
           // Memref ops.
           .Case<memref::StoreOp>(
@@ -2859,7 +3044,7 @@ LogicalResult CppEmitter::emitOperation(Operation &op, bool trailingSemicolon) {
                 aievec::BroadcastScalarOp, aievec::MulConvOp, aievec::FMAConvOp,
                 aievec::ShiftOp, aievec::ShuffleOp, aievec::CastOp,
                 aievec::MinOp, aievec::MaxOp, aievec::CmpOp, aievec::SelOp,
-                aievec::ExtElemOp>(
+                aievec::ExtElemOp, aievec::MatMulOp>(
               [&](auto op) { return printOperation(*this, op); })
           .Default([&](Operation *) {
             return op.emitOpError("unable to find printer for op");
@@ -2942,16 +3127,19 @@ LogicalResult CppEmitter::emitType(Location loc, Type type, bool stdintType,
   // VectorType: printed as v'lane''eltType'
   if (auto tType = type.dyn_cast<VectorType>()) {
     Type eltType = tType.getElementType();
-    if (tType.getRank() != 1)
+    // Multi-dimensional vectors (e.g., matrix tiles) are emitted as flat
+    // vectors of the same number of elements.
+    if (tType.getRank() < 1 || !tType.hasStaticShape())
       return failure();
 
-    unsigned dimSize = tType.getDimSize(tType.getRank() - 1);
+    unsigned dimSize = tType.getNumElements();
 
     if (eltType.isa<IntegerType>()) {
       os << "v" << std::to_string(dimSize);
       auto iType = eltType.cast<IntegerType>();
       unsigned width = iType.getWidth();
-      if ((dimSize == 16 && width == 64) || (dimSize == 32 && width == 32)) {
+      if ((dimSize == 16 && width == 64) || (dimSize == 32 && width == 32) ||
+          (dimSize == 16 && width == 32)) {
         if (isAcc) {
           return (os << "acc" << width), success();
         } else {
@@ -0,0 +1,92 @@
+//===- adf_to_aie.mlir -----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt %s -split-input-file --convert-adf-to-aie="iterations=4" | FileCheck %s
+
+// Windows become objectFifos, broadcast to every kernel that reads them.
+// CHECK-LABEL: module @window
+// CHECK: AIE.device(xcvc1902) {
+// CHECK:   %[[GIN:.*]] = AIE.tile(2, 0)
+// CHECK:   %[[K1:.*]] = AIE.tile(2, 1)
+// CHECK:   %[[K2:.*]] = AIE.tile(3, 1)
+// CHECK:   %[[GOUT:.*]] = AIE.tile(3, 0)
+// CHECK:   %[[IN:.*]] = AIE.objectFifo.createObjectFifo(%[[GIN]], {%[[K1]], %[[K2]]}, 2) {sym_name = "gin"} : !AIE.objectFifo<memref<32xi32>>
+// CHECK:   %[[K1OUT:.*]] = AIE.objectFifo.createObjectFifo(%[[K1]], {%[[K2]]}, 2) {sym_name = "k1_out"} : !AIE.objectFifo<memref<64xi16>>
+// CHECK:   %[[K2OUT:.*]] = AIE.objectFifo.createObjectFifo(%[[K2]], {%[[GOUT]]}, 2) {sym_name = "k2_out"} : !AIE.objectFifo<memref<32xi32>>
+// CHECK:   func.func private @kfunc1(memref<32xi32>, memref<64xi16>)
+// CHECK:   func.func private @kfunc3(memref<32xi32>, memref<64xi16>, memref<32xi32>)
+// CHECK:   AIE.core(%[[K1]]) {
+// CHECK:     scf.for
+// CHECK:       %[[S0:.*]] = AIE.objectFifo.acquire<Consume> (%[[IN]] : !AIE.objectFifo<memref<32xi32>>, 1) : !AIE.objectFifoSubview<memref<32xi32>>
+// CHECK:       %[[A0:.*]] = AIE.objectFifo.subview.access %[[S0]][0] : !AIE.objectFifoSubview<memref<32xi32>> -> memref<32xi32>
+// CHECK:       %[[S1:.*]] = AIE.objectFifo.acquire<Produce> (%[[K1OUT]] : !AIE.objectFifo<memref<64xi16>>, 1) : !AIE.objectFifoSubview<memref<64xi16>>
+// CHECK:       %[[A1:.*]] = AIE.objectFifo.subview.access %[[S1]][0] : !AIE.objectFifoSubview<memref<64xi16>> -> memref<64xi16>
+// CHECK:       func.call @kfunc1(%[[A0]], %[[A1]]) : (memref<32xi32>, memref<64xi16>) -> ()
+// CHECK:       AIE.objectFifo.release<Consume> (%[[IN]] : !AIE.objectFifo<memref<32xi32>>, 1)
+// CHECK:       AIE.objectFifo.release<Produce> (%[[K1OUT]] : !AIE.objectFifo<memref<64xi16>>, 1)
+// CHECK:     }
+// CHECK:     AIE.end
+// CHECK:   }
+// CHECK:   AIE.core(%[[K2]]) {
+// CHECK:     scf.for
+// CHECK:       AIE.objectFifo.acquire<Consume> (%[[IN]] : !AIE.objectFifo<memref<32xi32>>, 1)
+// CHECK:       AIE.objectFifo.acquire<Consume> (%[[K1OUT]] : !AIE.objectFifo<memref<64xi16>>, 1)
+// CHECK:       AIE.objectFifo.acquire<Produce> (%[[K2OUT]] : !AIE.objectFifo<memref<32xi32>>, 1)
+// CHECK:       func.call @kfunc3
+// CHECK-NOT: ADF.
+module @window {
+  func.func private @kfunc1(%in : !ADF.window<!ADF.int32, 128, 0>)
+                              -> (!ADF.window<!ADF.int16, 128, 0>)
+  func.func private @kfunc3(%in0 : !ADF.window<!ADF.int32, 128, 0>,
+                            %in1 : !ADF.window<!ADF.int16, 128, 0>)
+                              -> (!ADF.window<!ADF.int32, 128, 0>)
+
+  ADF.graph("simpleWindow") {
+    %gi = ADF.input_port("gin") [0:i1, 128:i32] -> !ADF.interface<!ADF.int32>
+    %1 = ADF.kernel @kfunc1(%gi) : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int16>
+    %2 = ADF.kernel @kfunc3(%gi, %1) : (!ADF.interface<!ADF.int32>, !ADF.interface<!ADF.int16>) -> !ADF.interface<!ADF.int32>
+    %go = ADF.output_port("gout") %2 : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+  }
+}
+
+// -----
+
+// Streams become flows between shim DMAs and the Core ports of the kernels,
+// and are not arguments of the kernels.
+// CHECK-LABEL: module @stream
+// CHECK: AIE.device(xcvc1902) {
+// CHECK:   %[[GIN:.*]] = AIE.tile(2, 0)
+// CHECK:   %[[K1:.*]] = AIE.tile(2, 1)
+// CHECK:   %[[K2:.*]] = AIE.tile(3, 1)
+// CHECK:   %[[GOUT:.*]] = AIE.tile(3, 0)
+// CHECK:   AIE.flow(%[[GIN]], DMA : 0, %[[K1]], Core : 0)
+// CHECK:   AIE.flow(%[[GIN]], DMA : 0, %[[K2]], Core : 0)
+// CHECK:   AIE.flow(%[[K1]], Core : 0, %[[K2]], Core : 1)
+// CHECK:   AIE.flow(%[[K2]], Core : 0, %[[GOUT]], DMA : 0)
+// CHECK:   func.func private @kfunc1()
+// CHECK:   func.func private @kfunc2()
+// CHECK:   AIE.core(%[[K1]]) {
+// CHECK:     func.call @kfunc1() : () -> ()
+// CHECK:   AIE.core(%[[K2]]) {
+// CHECK:     func.call @kfunc2() : () -> ()
+module @stream {
+  func.func private @kfunc1(%in : !ADF.stream<!ADF.int32>)
+                              -> (!ADF.stream<!ADF.int32>)
+  func.func private @kfunc2(%in0 : !ADF.stream<!ADF.int32>,
+                            %in1 : !ADF.stream<!ADF.int32>)
+                              -> (!ADF.stream<!ADF.int32>)
+
+  ADF.graph("simpleStream") {
+    %gi = ADF.input_port("gin") [1:i1, -1:i32] -> !ADF.interface<!ADF.int32>
+    %1 = ADF.kernel @kfunc1(%gi) : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+    %2 = ADF.kernel @kfunc2(%gi, %1) : (!ADF.interface<!ADF.int32>, !ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+    %go = ADF.output_port("gout") %2 : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+  }
+}
@@ -0,0 +1,53 @@
+//===- adf_to_aie_invalid.mlir ---------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt %s -split-input-file --convert-adf-to-aie -verify-diagnostics
+
+module {
+  // expected-error@+1 {{runtime parameters are not supported}}
+  func.func private @kfunc(%p : !ADF.parameter<!ADF.int32>)
+                             -> (!ADF.window<!ADF.int32, 128, 0>)
+
+  ADF.graph("param") {
+    %gp = ADF.input_port("gp") [0:i1, 128:i32] -> !ADF.interface<!ADF.int32>
+    %1 = ADF.kernel @kfunc(%gp) : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+    %go = ADF.output_port("gout") %1 : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+  }
+}
+
+// -----
+
+module {
+  func.func private @kfunc(%in : !ADF.window<!ADF.int32, 128, 0>)
+                             -> (!ADF.window<!ADF.int32, 128, 0>)
+
+  ADF.graph("mismatch") {
+    %gi = ADF.input_port("gin") [1:i1, -1:i32] -> !ADF.interface<!ADF.int32>
+    // expected-error@+1 {{but operand 0 provides}}
+    %1 = ADF.kernel @kfunc(%gi) : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+    %go = ADF.output_port("gout") %1 : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+  }
+}
+
+// -----
+
+module {
+  func.func @kfunc(%in : !ADF.window<!ADF.int32, 128, 0>)
+                     -> (!ADF.window<!ADF.int32, 128, 0>) {
+    return %in : !ADF.window<!ADF.int32, 128, 0>
+  }
+
+  ADF.graph("definition") {
+    %gi = ADF.input_port("gin") [0:i1, 128:i32] -> !ADF.interface<!ADF.int32>
+    // expected-error@+1 {{kernel function @kfunc must be a declaration}}
+    %1 = ADF.kernel @kfunc(%gi) : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+    %go = ADF.output_port("gout") %1 : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+  }
+}
@@ -0,0 +1,14 @@
+// RUN: aie-opt %s --convert-aievec-to-llvm | FileCheck %s
+module {
+  func.func @test(%a : vector<16xi32>, %b : vector<16xi32>) -> vector<16xi32> {
+    %0 = aievec.cmp %a, %b {pred = "sgt"} : vector<16xi32>, vector<16xi32>, ui32
+    %1 = aievec.sel %a, %b, %0 : vector<16xi32>, vector<16xi32>, ui32, vector<16xi32>
+    return %1 : vector<16xi32>
+  }
+}
+
+// CHECK-DAG: llvm.func @llvm.aie2.cmp.sgt.v16int32(vector<16xi32>, vector<16xi32>) -> i32
+// CHECK-DAG: llvm.func @llvm.aie2.sel.v16int32(vector<16xi32>, vector<16xi32>, i32) -> vector<16xi32>
+// CHECK: [[CMP:%.+]] = llvm.call @llvm.aie2.cmp.sgt.v16int32(%arg0, %arg1) : (vector<16xi32>, vector<16xi32>) -> i32
+// CHECK: [[SEL:%.+]] = llvm.call @llvm.aie2.sel.v16int32(%arg0, %arg1, [[CMP]]) : (vector<16xi32>, vector<16xi32>, i32) -> vector<16xi32>
+// CHECK: return [[SEL]] : vector<16xi32>
@@ -0,0 +1,13 @@
+// RUN: aie-opt %s --convert-aievec-to-llvm | FileCheck %s
+module {
+  func.func @test(%a : vector<64xi8>, %b : vector<64xi8>, %c : vector<32xi32>) {
+    %0 = aievec.mul_conv %a, %b {M = 32 : i32, N = 8 : i32} : vector<64xi8>, vector<64xi8>, vector<32xi32>
+    %1 = aievec.fma_conv %a, %b, %c {M = 32 : i32, N = 8 : i32} : vector<64xi8>, vector<64xi8>, vector<32xi32>
+    return
+  }
+}
+
+// CHECK-DAG: llvm.func @llvm.aie2.mul.conv.32x8.v64i8(vector<64xi8>, vector<64xi8>) -> vector<32xi32>
+// CHECK-DAG: llvm.func @llvm.aie2.mac.conv.32x8.v64i8(vector<64xi8>, vector<64xi8>, vector<32xi32>) -> vector<32xi32>
+// CHECK: {{.*}} = llvm.call @llvm.aie2.mul.conv.32x8.v64i8(%arg0, %arg1) : (vector<64xi8>, vector<64xi8>) -> vector<32xi32>
+// CHECK: {{.*}} = llvm.call @llvm.aie2.mac.conv.32x8.v64i8(%arg0, %arg1, %arg2) : (vector<64xi8>, vector<64xi8>, vector<32xi32>) -> vector<32xi32>
@@ -0,0 +1,29 @@
+// RUN: aie-opt %s --convert-aievec-to-llvm | FileCheck %s
+module {
+  func.func @test(%a : vector<32xi16>, %b : vector<32xi16>,
+                  %c : vector<16xi32>, %d : vector<16xi64>) {
+    %0 = aievec.add_elem %a, %b : vector<32xi16>
+    %1 = aievec.sub_elem %a, %b : vector<32xi16>
+    %2 = aievec.min %a, %b : vector<32xi16>
+    %3 = aievec.max %a, %b : vector<32xi16>
+    %4 = aievec.mul_elem %a, %b : vector<32xi16>, vector<32xi16>, vector<32xi32>
+    %5 = aievec.mac_elem %c, %c, %d : vector<16xi32>, vector<16xi32>, vector<16xi64>
+    %6 = aievec.mac_elem %c, %c, %d {fmsub = true} : vector<16xi32>, vector<16xi32>, vector<16xi64>
+    return
+  }
+}
+
+// CHECK-DAG: llvm.func @llvm.aie2.add.v32int16(vector<32xi16>, vector<32xi16>) -> vector<32xi16>
+// CHECK-DAG: llvm.func @llvm.aie2.sub.v32int16(vector<32xi16>, vector<32xi16>) -> vector<32xi16>
+// CHECK-DAG: llvm.func @llvm.aie2.min.v32int16(vector<32xi16>, vector<32xi16>) -> vector<32xi16>
+// CHECK-DAG: llvm.func @llvm.aie2.max.v32int16(vector<32xi16>, vector<32xi16>) -> vector<32xi16>
+// CHECK-DAG: llvm.func @llvm.aie2.mul.elem.v32i16.v32acc32(vector<32xi16>, vector<32xi16>) -> vector<32xi32>
+// CHECK-DAG: llvm.func @llvm.aie2.mac.elem.v16i32.v16acc64(vector<16xi32>, vector<16xi32>, vector<16xi64>) -> vector<16xi64>
+// CHECK-DAG: llvm.func @llvm.aie2.msc.elem.v16i32.v16acc64(vector<16xi32>, vector<16xi32>, vector<16xi64>) -> vector<16xi64>
+// CHECK: {{.*}} = llvm.call @llvm.aie2.add.v32int16(%arg0, %arg1) : (vector<32xi16>, vector<32xi16>) -> vector<32xi16>
+// CHECK: {{.*}} = llvm.call @llvm.aie2.sub.v32int16(%arg0, %arg1) : (vector<32xi16>, vector<32xi16>) -> vector<32xi16>
+// CHECK: {{.*}} = llvm.call @llvm.aie2.min.v32int16(%arg0, %arg1) : (vector<32xi16>, vector<32xi16>) -> vector<32xi16>
+// CHECK: {{.*}} = llvm.call @llvm.aie2.max.v32int16(%arg0, %arg1) : (vector<32xi16>, vector<32xi16>) -> vector<32xi16>
+// CHECK: {{.*}} = llvm.call @llvm.aie2.mul.elem.v32i16.v32acc32(%arg0, %arg1) : (vector<32xi16>, vector<32xi16>) -> vector<32xi32>
+// CHECK: {{.*}} = llvm.call @llvm.aie2.mac.elem.v16i32.v16acc64(%arg2, %arg2, %arg3) : (vector<16xi32>, vector<16xi32>, vector<16xi64>) -> vector<16xi64>
+// CHECK: {{.*}} = llvm.call @llvm.aie2.msc.elem.v16i32.v16acc64(%arg2, %arg2, %arg3) : (vector<16xi32>, vector<16xi32>, vector<16xi64>) -> vector<16xi64>
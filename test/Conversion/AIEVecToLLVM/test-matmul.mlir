@@ -0,0 +1,13 @@
+// RUN: aie-opt %s --convert-aievec-to-llvm | FileCheck %s
+module {
+  func.func @test(%a : vector<4x8xi8>, %b : vector<8x4xi8>, %c : vector<4x4xi32>) -> vector<4x4xi32> {
+    %0 = aievec.matmul %a, %b, %c : vector<4x8xi8>, vector<8x4xi8> into vector<4x4xi32>
+    return %0 : vector<4x4xi32>
+  }
+}
+// CHECK: llvm.func @llvm.aie2.mac.4x8.8x4.v32int8(vector<32xi8>, vector<32xi8>, vector<16xi32>) -> vector<16xi32>
+// CHECK: [[A:%.+]] = vector.shape_cast %{{.*}} : vector<4x8xi8> to vector<32xi8>
+// CHECK: [[B:%.+]] = vector.shape_cast %{{.*}} : vector<8x4xi8> to vector<32xi8>
+// CHECK: [[C:%.+]] = vector.shape_cast %{{.*}} : vector<4x4xi32> to vector<16xi32>
+// CHECK: [[R:%.+]] = llvm.call @llvm.aie2.mac.4x8.8x4.v32int8([[A]], [[B]], [[C]]) : (vector<32xi8>, vector<32xi8>, vector<16xi32>) -> vector<16xi32>
+// CHECK: {{.*}} = vector.shape_cast [[R]] : vector<16xi32> to vector<4x4xi32>
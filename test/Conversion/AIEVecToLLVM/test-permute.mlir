@@ -0,0 +1,26 @@
+// RUN: aie-opt %s --convert-aievec-to-llvm | FileCheck %s
+module {
+  func.func @test(%a : vector<64xi8>, %b : vector<16xi32>, %s : bf16) -> i32 {
+    %c16 = arith.constant 16 : i32
+    %0 = aievec.shift %a, %a, %c16 {isAcc = false} : vector<64xi8>, vector<64xi8>, i32, vector<64xi8>
+    %1 = aievec.shuffle %0 {mode = 0 : i32} : vector<64xi8>, vector<64xi8>
+    %2 = aievec.broadcast %b {idx = 3 : i8} : vector<16xi32>, vector<16xi32>
+    %3 = aievec.broadcast_scalar %s : bf16, vector<32xbf16>
+    %4 = aievec.ext_elem %2, %c16 : vector<16xi32>, i32, i32
+    return %4 : i32
+  }
+}
+
+// CHECK-DAG: llvm.func @llvm.aie2.shift.v64int8(vector<64xi8>, vector<64xi8>, i32) -> vector<64xi8>
+// CHECK-DAG: llvm.func @llvm.aie2.shuffle.v64int8(vector<64xi8>, i32) -> vector<64xi8>
+// CHECK-DAG: llvm.func @llvm.aie2.broadcast.v16int32(vector<16xi32>, i32) -> vector<16xi32>
+// CHECK-DAG: llvm.func @llvm.aie2.broadcast.scalar.v32bfloat16(bf16) -> vector<32xbf16>
+// CHECK-DAG: llvm.func @llvm.aie2.ext.elem.v16int32(vector<16xi32>, i32) -> i32
+// CHECK: [[C16:%.+]] = arith.constant 16 : i32
+// CHECK: [[SHIFT:%.+]] = llvm.call @llvm.aie2.shift.v64int8(%arg0, %arg0, [[C16]]) : (vector<64xi8>, vector<64xi8>, i32) -> vector<64xi8>
+// CHECK: [[MODE:%.+]] = llvm.mlir.constant(0 : i32) : i32
+// CHECK: {{.*}} = llvm.call @llvm.aie2.shuffle.v64int8([[SHIFT]], [[MODE]]) : (vector<64xi8>, i32) -> vector<64xi8>
+// CHECK: [[IDX:%.+]] = llvm.mlir.constant(3 : i32) : i32
+// CHECK: [[BCAST:%.+]] = llvm.call @llvm.aie2.broadcast.v16int32(%arg1, [[IDX]]) : (vector<16xi32>, i32) -> vector<16xi32>
+// CHECK: {{.*}} = llvm.call @llvm.aie2.broadcast.scalar.v32bfloat16(%arg2) : (bf16) -> vector<32xbf16>
+// CHECK: {{.*}} = llvm.call @llvm.aie2.ext.elem.v16int32([[BCAST]], [[C16]]) : (vector<16xi32>, i32) -> i32
@@ -0,0 +1,14 @@
+// RUN: aie-opt %s --convert-aievec-to-llvm | FileCheck %s
+// Test a direct load with an offset (in bits) from the accessed element
+module {
+  func.func @test(%arg0: memref<256xi16>) {
+    %i = arith.constant 16 : index
+    %0 = aievec.upd %arg0[%i] {index = 0 : i8, offset = 64 : si32} : memref<256xi16>, vector<16xi16>
+    return
+  }
+}
+// CHECK: [[EPTR:%.+]] = llvm.getelementptr {{.*}} : (!llvm.ptr<i16>, i64) -> !llvm.ptr<i16>
+// CHECK: [[OFF:%.+]] = llvm.mlir.constant(4 : index) : i64
+// CHECK: [[OPTR:%.+]] = llvm.getelementptr [[EPTR]][[[OFF]]] : (!llvm.ptr<i16>, i64) -> !llvm.ptr<i16>
+// CHECK: [[VPTR:%.+]] = llvm.bitcast [[OPTR]] : !llvm.ptr<i16> to !llvm.ptr<vector<16xi16>>
+// CHECK: {{.*}} = llvm.load [[VPTR]] {alignment = 1 : i64} : !llvm.ptr<vector<16xi16>>
@@ -0,0 +1,15 @@
+// RUN: aie-opt %s --convert-aievec-to-llvm | FileCheck %s
+module {
+  func.func @test(%arg0 : vector<8xi32>, %arg1 : vector<16xi16>) {
+    %0 = aievec.ups %arg0 {shift = 0 : i8} : vector<8xi32>, vector<8xi80>
+    %1 = aievec.ups %arg1 {shift = 4 : i8} : vector<16xi16>, vector<16xi48>
+    return
+  }
+}
+
+// CHECK-DAG: llvm.func @llvm.aie.ups.v8acc80.v8i32(vector<8xi32>, i32) -> vector<8xi80>
+// CHECK-DAG: llvm.func @llvm.aie.ups.v16acc48.v16i16(vector<16xi16>, i32) -> vector<16xi48>
+// CHECK: [[SHIFT0:%.+]] = llvm.mlir.constant(0 : i32) : i32
+// CHECK: {{.*}} = llvm.call @llvm.aie.ups.v8acc80.v8i32(%arg0, [[SHIFT0]]) : (vector<8xi32>, i32) -> vector<8xi80>
+// CHECK: [[SHIFT4:%.+]] = llvm.mlir.constant(4 : i32) : i32
+// CHECK: {{.*}} = llvm.call @llvm.aie.ups.v16acc48.v16i16(%arg1, [[SHIFT4]]) : (vector<16xi16>, i32) -> vector<16xi48>
@@ -0,0 +1,219 @@
+// RUN: aie-opt %s -split-input-file --legalize-vector-for-aievec="aie-target=aieml" | FileCheck %s
+// RUN: aie-opt %s -split-input-file --legalize-vector-for-aievec | FileCheck %s --check-prefix=CHECK-V1
+
+// CHECK-LABEL: func @vecadd_f32
+// CHECK-COUNT-8: vector.transfer_read {{.*}} : memref<256xf32>, vector<16xf32>
+// CHECK-COUNT-4: arith.addf {{.*}} : vector<16xf32>
+// CHECK-COUNT-4: vector.transfer_write {{.*}} : vector<16xf32>, memref<256xf32>
+// CHECK-NOT: vector<64xf32>
+// CHECK-V1-LABEL: func @vecadd_f32
+// CHECK-V1-COUNT-4: vector.transfer_read {{.*}} : memref<256xf32>, vector<32xf32>
+// CHECK-V1-COUNT-2: arith.addf {{.*}} : vector<32xf32>
+// CHECK-V1-COUNT-2: vector.transfer_write {{.*}} : vector<32xf32>, memref<256xf32>
+func.func @vecadd_f32(%a: memref<256xf32>, %b: memref<256xf32>, %c: memref<256xf32>) {
+  %cst = arith.constant 0.000000e+00 : f32
+  affine.for %i = 0 to 256 step 64 {
+    %0 = vector.transfer_read %a[%i], %cst : memref<256xf32>, vector<64xf32>
+    %1 = vector.transfer_read %b[%i], %cst : memref<256xf32>, vector<64xf32>
+    %2 = arith.addf %0, %1 : vector<64xf32>
+    vector.transfer_write %2, %c[%i] : vector<64xf32>, memref<256xf32>
+  }
+  return
+}
+
+// -----
+
+// Vectors that already fit in a register are left alone.
+// CHECK-LABEL: func @vecadd_i32
+// CHECK: %[[A:.*]] = vector.transfer_read {{.*}} : memref<256xi32>, vector<32xi32>
+// CHECK: %[[B:.*]] = vector.transfer_read {{.*}} : memref<256xi32>, vector<32xi32>
+// CHECK: %[[S:.*]] = arith.addi %[[A]], %[[B]] : vector<32xi32>
+// CHECK: vector.transfer_write %[[S]], {{.*}} : vector<32xi32>, memref<256xi32>
+func.func @vecadd_i32(%a: memref<256xi32>, %b: memref<256xi32>, %c: memref<256xi32>) {
+  %c0_i32 = arith.constant 0 : i32
+  affine.for %i = 0 to 256 step 32 {
+    %0 = vector.transfer_read %a[%i], %c0_i32 : memref<256xi32>, vector<32xi32>
+    %1 = vector.transfer_read %b[%i], %c0_i32 : memref<256xi32>, vector<32xi32>
+    %2 = arith.addi %0, %1 : vector<32xi32>
+    vector.transfer_write %2, %c[%i] : vector<32xi32>, memref<256xi32>
+  }
+  return
+}
+
+// -----
+
+// Lengths that aren't a multiple of the register size are split into the
+// largest slices that divide them evenly.
+// CHECK-LABEL: func @vecmul_i32_48
+// CHECK-COUNT-3: arith.muli {{.*}} : vector<16xi32>
+// CHECK-NOT: vector<48xi32>
+func.func @vecmul_i32_48(%a: memref<96xi32>, %b: memref<96xi32>) {
+  %c0_i32 = arith.constant 0 : i32
+  affine.for %i = 0 to 96 step 48 {
+    %0 = vector.transfer_read %a[%i], %c0_i32 : memref<96xi32>, vector<48xi32>
+    %1 = arith.muli %0, %0 : vector<48xi32>
+    vector.transfer_write %1, %b[%i] : vector<48xi32>, memref<96xi32>
+  }
+  return
+}
+
+// -----
+
+// Comparisons are split according to the type of the compared values, and
+// the resulting masks follow the same shape.
+// CHECK-LABEL: func @vecsel_i16
+// CHECK-COUNT-2: arith.cmpi slt, {{.*}} : vector<32xi16>
+// CHECK-COUNT-2: arith.select {{.*}} : vector<32xi1>, vector<32xi16>
+func.func @vecsel_i16(%a: memref<128xi16>, %b: memref<128xi16>, %c: memref<128xi16>) {
+  %c0_i16 = arith.constant 0 : i16
+  affine.for %i = 0 to 128 step 64 {
+    %0 = vector.transfer_read %a[%i], %c0_i16 : memref<128xi16>, vector<64xi16>
+    %1 = vector.transfer_read %b[%i], %c0_i16 : memref<128xi16>, vector<64xi16>
+    %2 = arith.cmpi slt, %0, %1 : vector<64xi16>
+    %3 = arith.select %2, %0, %1 : vector<64xi1>, vector<64xi16>
+    vector.transfer_write %3, %c[%i] : vector<64xi16>, memref<128xi16>
+  }
+  return
+}
+
+// -----
+
+// Reductions are split into partial reductions on register-sized slices.
+// CHECK-LABEL: func @reduce_f32
+// CHECK-COUNT-4: vector.reduction <add>, {{.*}} : vector<16xf32> into f32
+func.func @reduce_f32(%a: memref<64xf32>) -> f32 {
+  %c0 = arith.constant 0 : index
+  %cst = arith.constant 0.000000e+00 : f32
+  %0 = vector.transfer_read %a[%c0], %cst : memref<64xf32>, vector<64xf32>
+  %1 = vector.reduction <add>, %0 : vector<64xf32> into f32
+  return %1 : f32
+}
+
+// -----
+
+// AIE has no bf16 vector support, so bf16 vector ops are unrolled element by
+// element.
+// CHECK-LABEL: func @vecadd_bf16
+// CHECK: arith.addf {{.*}} : vector<4xbf16>
+// CHECK-V1-LABEL: func @vecadd_bf16
+// CHECK-V1-COUNT-4: arith.addf {{.*}} : vector<1xbf16>
+// CHECK-V1-NOT: arith.addf {{.*}} : vector<4xbf16>
+func.func @vecadd_bf16(%a: memref<4xbf16>, %b: memref<4xbf16>) {
+  %c0 = arith.constant 0 : index
+  %cst = arith.constant 0.000000e+00 : bf16
+  %0 = vector.transfer_read %a[%c0], %cst : memref<4xbf16>, vector<4xbf16>
+  %1 = arith.addf %0, %0 : vector<4xbf16>
+  vector.transfer_write %1, %b[%c0] : vector<4xbf16>, memref<4xbf16>
+  return
+}
+
+// -----
+
+// Reductions carried across loop iterations are accumulated lane-wise, and
+// reduced once after the loop.
+// CHECK-LABEL: func @dot_f32
+// CHECK-DAG: %[[CST:.*]] = arith.constant 0.000000e+00 : f32
+// CHECK-DAG: %[[ZERO:.*]] = arith.constant dense<0.000000e+00> : vector<16xf32>
+// CHECK: %[[LOOP:.*]]:2 = affine.for {{.*}} iter_args(%{{.*}} = %[[CST]], %[[VACC:.*]] = %[[ZERO]]) -> (f32, vector<16xf32>) {
+// CHECK:   %[[MUL:.*]] = arith.mulf {{.*}} : vector<16xf32>
+// CHECK-NOT: vector.reduction
+// CHECK:   %[[SUM:.*]] = arith.addf %[[VACC]], %[[MUL]] : vector<16xf32>
+// CHECK:   affine.yield %{{.*}}, %[[SUM]] : f32, vector<16xf32>
+// CHECK: %[[RED:.*]] = vector.reduction <add>, %[[LOOP]]#1 : vector<16xf32> into f32
+// CHECK: %[[RES:.*]] = arith.addf %[[RED]], %[[CST]] : f32
+// CHECK: return %[[RES]] : f32
+func.func @dot_f32(%a: memref<256xf32>, %b: memref<256xf32>) -> f32 {
+  %cst = arith.constant 0.000000e+00 : f32
+  %0 = affine.for %i = 0 to 256 step 16 iter_args(%acc = %cst) -> f32 {
+    %1 = vector.transfer_read %a[%i], %cst : memref<256xf32>, vector<16xf32>
+    %2 = vector.transfer_read %b[%i], %cst : memref<256xf32>, vector<16xf32>
+    %3 = arith.mulf %1, %2 : vector<16xf32>
+    %4 = vector.reduction <add>, %3, %acc : vector<16xf32> into f32
+    affine.yield %4 : f32
+  }
+  return %0 : f32
+}
+
+// -----
+
+// Reductions split into register-sized slices accumulate every slice in the
+// same vector.
+// CHECK-LABEL: func @sum_i32
+// CHECK: scf.for {{.*}} -> (i32, vector<32xi32>) {
+// CHECK-COUNT-2: arith.addi {{.*}} : vector<32xi32>
+// CHECK-NOT: vector.reduction
+// CHECK: scf.yield
+// CHECK: vector.reduction <add>, {{.*}} : vector<32xi32> into i32
+// CHECK-NOT: vector.reduction
+func.func @sum_i32(%a: memref<1024xi32>, %init: i32) -> i32 {
+  %c0 = arith.constant 0 : index
+  %c64 = arith.constant 64 : index
+  %c1024 = arith.constant 1024 : index
+  %c0_i32 = arith.constant 0 : i32
+  %0 = scf.for %i = %c0 to %c1024 step %c64 iter_args(%acc = %init) -> i32 {
+    %1 = vector.transfer_read %a[%i], %c0_i32 : memref<1024xi32>, vector<64xi32>
+    %2 = vector.reduction <add>, %1 : vector<64xi32> into i32
+    %3 = arith.addi %acc, %2 : i32
+    scf.yield %3 : i32
+  }
+  return %0 : i32
+}
+
+// -----
+
+// Maximums accumulate the initial value in every lane.
+// CHECK-LABEL: func @max_f32
+// CHECK: %[[INIT:.*]] = vector.broadcast %{{.*}} : f32 to vector<16xf32>
+// CHECK: %[[LOOP:.*]]:2 = affine.for {{.*}} iter_args(%{{.*}} = %{{.*}}, %[[VACC:.*]] = %[[INIT]]) -> (f32, vector<16xf32>) {
+// CHECK:   arith.maxf %[[VACC]], %{{.*}} : vector<16xf32>
+// CHECK: %[[RED:.*]] = vector.reduction <maxf>, %[[LOOP]]#1 : vector<16xf32> into f32
+// CHECK: return %[[RED]] : f32
+func.func @max_f32(%a: memref<256xf32>, %init: f32) -> f32 {
+  %cst = arith.constant 0.000000e+00 : f32
+  %0 = affine.for %i = 0 to 256 step 16 iter_args(%acc = %init) -> f32 {
+    %1 = vector.transfer_read %a[%i], %cst : memref<256xf32>, vector<16xf32>
+    %2 = vector.reduction <maxf>, %1, %acc : vector<16xf32> into f32
+    affine.yield %2 : f32
+  }
+  return %0 : f32
+}
+
+// -----
+
+// Multi-dimensional vectors keep as many inner dimensions as fit in a
+// register, and are only unrolled along the outer ones.
+// CHECK-LABEL: func @vecadd_2d_i32
+// CHECK-COUNT-2: arith.addi {{.*}} : vector<2x16xi32>
+// CHECK-NOT: vector<1x16xi32>
+// CHECK-LABEL: func @vecadd_2d_i16
+// CHECK: arith.addi {{.*}} : vector<4x16xi16>
+// CHECK-NOT: vector<1x16xi16>
+func.func @vecadd_2d_i32(%a: vector<4x16xi32>, %b: vector<4x16xi32>) -> vector<4x16xi32> {
+  %0 = arith.addi %a, %b : vector<4x16xi32>
+  return %0 : vector<4x16xi32>
+}
+func.func @vecadd_2d_i16(%a: vector<4x16xi16>, %b: vector<4x16xi16>) -> vector<4x16xi16> {
+  %0 = arith.addi %a, %b : vector<4x16xi16>
+  return %0 : vector<4x16xi16>
+}
+
+// -----
+
+// Xor isn't idempotent, so the accumulator starts from zero instead of the
+// initial value, which is folded in once after the loop.
+// CHECK-LABEL: func @xor_i32
+// CHECK: %[[ZERO:.*]] = arith.constant dense<0> : vector<32xi32>
+// CHECK: %[[LOOP:.*]]:2 = affine.for {{.*}} iter_args(%{{.*}} = %{{.*}}, %[[VACC:.*]] = %[[ZERO]]) -> (i32, vector<32xi32>) {
+// CHECK:   arith.xori %[[VACC]], %{{.*}} : vector<32xi32>
+// CHECK: %[[RED:.*]] = vector.reduction <xor>, %[[LOOP]]#1 : vector<32xi32> into i32
+// CHECK: %[[RES:.*]] = arith.xori %[[RED]], %{{.*}} : i32
+// CHECK: return %[[RES]] : i32
+func.func @xor_i32(%a: memref<256xi32>, %init: i32) -> i32 {
+  %c0_i32 = arith.constant 0 : i32
+  %0 = affine.for %i = 0 to 256 step 32 iter_args(%acc = %init) -> i32 {
+    %1 = vector.transfer_read %a[%i], %c0_i32 : memref<256xi32>, vector<32xi32>
+    %2 = vector.reduction <xor>, %1, %acc : vector<32xi32> into i32
+    affine.yield %2 : i32
+  }
+  return %0 : i32
+}
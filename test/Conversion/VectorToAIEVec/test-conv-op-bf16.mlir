@@ -0,0 +1,124 @@
+// RUN: aie-opt %s -split-input-file --convert-vector-to-aievec="aie-target=aieml" | FileCheck %s
+
+// The taps of a 1D kernel don't fill the 8 coefficients of the convolution,
+// and no other group follows them, so the remaining ones are zeroed.
+func.func @conv1d(%arg0: memref<16x288xbf16>, %arg1: memref<16xbf16>, %arg2: memref<16x256xbf16>) {
+  %c0 = arith.constant 0 : index
+  affine.for %arg3 = 0 to 16 {
+    affine.for %arg4 = 0 to 256 step 16 {
+      %0 = aievec.upd %arg0[%arg3, %arg4] {index = 0 : i8, offset = 0 : si32} : memref<16x288xbf16>, vector<16xbf16>
+      %1 = aievec.upd %arg1[%c0] {index = 0 : i8, offset = 0 : si32} : memref<16xbf16>, vector<16xbf16>
+      %2 = aievec.broadcast %1 {idx = 0 : i8} : vector<16xbf16>, vector<16xbf16>
+      %3 = arith.mulf %0, %2 : vector<16xbf16>
+      %4 = affine.apply affine_map<(d0) -> (d0 + 1)>(%arg4)
+      %5 = aievec.upd %arg0[%arg3, %4] {index = 0 : i8, offset = 0 : si32} : memref<16x288xbf16>, vector<16xbf16>
+      %6 = aievec.broadcast %1 {idx = 1 : i8} : vector<16xbf16>, vector<16xbf16>
+      %7 = arith.mulf %5, %6 : vector<16xbf16>
+      %8 = arith.addf %3, %7 : vector<16xbf16>
+      %9 = affine.apply affine_map<(d0) -> (d0 + 2)>(%arg4)
+      %10 = aievec.upd %arg0[%arg3, %9] {index = 0 : i8, offset = 0 : si32} : memref<16x288xbf16>, vector<16xbf16>
+      %11 = aievec.broadcast %1 {idx = 2 : i8} : vector<16xbf16>, vector<16xbf16>
+      %12 = arith.mulf %10, %11 : vector<16xbf16>
+      %13 = arith.addf %8, %12 : vector<16xbf16>
+      vector.transfer_write %13, %arg2[%arg3, %arg4] {in_bounds = [true]} : vector<16xbf16>, memref<16x256xbf16>
+    }
+  }
+  return
+}
+
+// CHECK-LABEL:  func @conv1d
+// CHECK-SAME: %[[A0:[A-Za-z0-9]+]]: memref<16x288xbf16>
+// CHECK-SAME: %[[A1:[A-Za-z0-9]+]]: memref<16xbf16>
+// CHECK-SAME: %[[A2:[A-Za-z0-9]+]]: memref<16x256xbf16>
+//      CHECK:    %[[C0:.*]] = arith.constant 0 : index
+//      CHECK:    %[[K:.*]] = aievec.upd %[[A1]][%[[C0]]] {index = 0 : i8, offset = 0 : si32} : memref<16xbf16>, vector<32xbf16>
+//      CHECK:    %[[Z:.*]] = aievec.broadcast_scalar %{{.*}} : bf16, vector<32xbf16>
+//      CHECK:    %[[KT:.*]] = aievec.shift %[[Z]], %[[K]], %{{.*}} {isAcc = false} : vector<32xbf16>, vector<32xbf16>, i32, vector<32xbf16>
+//      CHECK:    %[[T0:.*]] = aievec.shift %[[KT]], %[[Z]], %{{.*}} {isAcc = false} : vector<32xbf16>, vector<32xbf16>, i32, vector<32xbf16>
+//      CHECK:    affine.for %[[A3:.*]] = 0 to 16 {
+//      CHECK:      affine.for %[[A4:.*]] = 0 to 256 step 16 {
+//      CHECK:        %[[T1:.*]] = aievec.upd %[[A0]][%[[A3]], %[[A4]]] {index = 0 : i8, offset = 0 : si32} : memref<16x288xbf16>, vector<32xbf16>
+//      CHECK:        %[[T2:.*]] = aievec.mul_conv %[[T1]], %[[T0]] {M = 16 : i32, N = 8 : i32} : vector<32xbf16>, vector<32xbf16>, vector<16xf32>
+//      CHECK:        %[[T3:.*]] = aievec.srs %[[T2]] {shift = 0 : i8} : vector<16xf32>, vector<16xbf16>
+//      CHECK:        vector.transfer_write %[[T3]], %[[A2]][%[[A3]], %[[A4]]] {in_bounds = [true]} : vector<16xbf16>, memref<16x256xbf16>
+
+// -----
+
+// A 3x3 kernel is folded into one convolution per kernel row. The rows of the
+// kernel are contiguous, so the first two rows zero the coefficients that
+// belong to the next row before they are used, and the last row zeroes the
+// ones past the end of the kernel.
+func.func @conv2d(%arg0: memref<18x288xbf16>, %arg1: memref<9xbf16>, %arg2: memref<16x256xbf16>) {
+  %c0 = arith.constant 0 : index
+  affine.for %arg3 = 0 to 16 {
+    affine.for %arg4 = 0 to 256 step 16 {
+      %k = aievec.upd %arg1[%c0] {index = 0 : i8, offset = 0 : si32} : memref<9xbf16>, vector<16xbf16>
+      %r1 = affine.apply affine_map<(d0) -> (d0 + 1)>(%arg3)
+      %r2 = affine.apply affine_map<(d0) -> (d0 + 2)>(%arg3)
+      %c1 = affine.apply affine_map<(d0) -> (d0 + 1)>(%arg4)
+      %c2 = affine.apply affine_map<(d0) -> (d0 + 2)>(%arg4)
+      %0 = aievec.upd %arg0[%arg3, %arg4] {index = 0 : i8, offset = 0 : si32} : memref<18x288xbf16>, vector<16xbf16>
+      %1 = aievec.broadcast %k {idx = 0 : i8} : vector<16xbf16>, vector<16xbf16>
+      %2 = arith.mulf %0, %1 : vector<16xbf16>
+      %3 = aievec.upd %arg0[%arg3, %c1] {index = 0 : i8, offset = 0 : si32} : memref<18x288xbf16>, vector<16xbf16>
+      %4 = aievec.broadcast %k {idx = 1 : i8} : vector<16xbf16>, vector<16xbf16>
+      %5 = arith.mulf %3, %4 : vector<16xbf16>
+      %6 = arith.addf %2, %5 : vector<16xbf16>
+      %7 = aievec.upd %arg0[%arg3, %c2] {index = 0 : i8, offset = 0 : si32} : memref<18x288xbf16>, vector<16xbf16>
+      %8 = aievec.broadcast %k {idx = 2 : i8} : vector<16xbf16>, vector<16xbf16>
+      %9 = arith.mulf %7, %8 : vector<16xbf16>
+      %10 = arith.addf %6, %9 : vector<16xbf16>
+      %11 = aievec.upd %arg0[%r1, %arg4] {index = 0 : i8, offset = 0 : si32} : memref<18x288xbf16>, vector<16xbf16>
+      %12 = aievec.broadcast %k {idx = 3 : i8} : vector<16xbf16>, vector<16xbf16>
+      %13 = arith.mulf %11, %12 : vector<16xbf16>
+      %14 = arith.addf %10, %13 : vector<16xbf16>
+      %15 = aievec.upd %arg0[%r1, %c1] {index = 0 : i8, offset = 0 : si32} : memref<18x288xbf16>, vector<16xbf16>
+      %16 = aievec.broadcast %k {idx = 4 : i8} : vector<16xbf16>, vector<16xbf16>
+      %17 = arith.mulf %15, %16 : vector<16xbf16>
+      %18 = arith.addf %14, %17 : vector<16xbf16>
+      %19 = aievec.upd %arg0[%r1, %c2] {index = 0 : i8, offset = 0 : si32} : memref<18x288xbf16>, vector<16xbf16>
+      %20 = aievec.broadcast %k {idx = 5 : i8} : vector<16xbf16>, vector<16xbf16>
+      %21 = arith.mulf %19, %20 : vector<16xbf16>
+      %22 = arith.addf %18, %21 : vector<16xbf16>
+      %23 = aievec.upd %arg0[%r2, %arg4] {index = 0 : i8, offset = 0 : si32} : memref<18x288xbf16>, vector<16xbf16>
+      %24 = aievec.broadcast %k {idx = 6 : i8} : vector<16xbf16>, vector<16xbf16>
+      %25 = arith.mulf %23, %24 : vector<16xbf16>
+      %26 = arith.addf %22, %25 : vector<16xbf16>
+      %27 = aievec.upd %arg0[%r2, %c1] {index = 0 : i8, offset = 0 : si32} : memref<18x288xbf16>, vector<16xbf16>
+      %28 = aievec.broadcast %k {idx = 7 : i8} : vector<16xbf16>, vector<16xbf16>
+      %29 = arith.mulf %27, %28 : vector<16xbf16>
+      %30 = arith.addf %26, %29 : vector<16xbf16>
+      %31 = aievec.upd %arg0[%r2, %c2] {index = 0 : i8, offset = 0 : si32} : memref<18x288xbf16>, vector<16xbf16>
+      %32 = aievec.broadcast %k {idx = 8 : i8} : vector<16xbf16>, vector<16xbf16>
+      %33 = arith.mulf %31, %32 : vector<16xbf16>
+      %34 = arith.addf %30, %33 : vector<16xbf16>
+      vector.transfer_write %34, %arg2[%arg3, %arg4] {in_bounds = [true]} : vector<16xbf16>, memref<16x256xbf16>
+    }
+  }
+  return
+}
+
+// CHECK-LABEL:  func @conv2d
+// CHECK-SAME: %[[A0:[A-Za-z0-9]+]]: memref<18x288xbf16>
+// CHECK-SAME: %[[A1:[A-Za-z0-9]+]]: memref<9xbf16>
+// CHECK-SAME: %[[A2:[A-Za-z0-9]+]]: memref<16x256xbf16>
+//      CHECK:    %[[K:.*]] = aievec.upd %[[A1]][%{{.*}}] {index = 0 : i8, offset = 0 : si32} : memref<9xbf16>, vector<32xbf16>
+//      CHECK:    %[[Z:.*]] = aievec.broadcast_scalar %{{.*}} : bf16, vector<32xbf16>
+//      CHECK:    %[[K0T:.*]] = aievec.shift %[[Z]], %[[K]], %{{.*}} {isAcc = false} : vector<32xbf16>, vector<32xbf16>, i32, vector<32xbf16>
+//      CHECK:    %[[K0:.*]] = aievec.shift %[[K0T]], %[[Z]], %{{.*}} {isAcc = false} : vector<32xbf16>, vector<32xbf16>, i32, vector<32xbf16>
+//      CHECK:    %[[K1S:.*]] = aievec.shift %[[K]], %[[K]], %{{.*}} {isAcc = false} : vector<32xbf16>, vector<32xbf16>, i32, vector<32xbf16>
+//      CHECK:    %[[K1T:.*]] = aievec.shift %[[Z]], %[[K1S]], %{{.*}} {isAcc = false} : vector<32xbf16>, vector<32xbf16>, i32, vector<32xbf16>
+//      CHECK:    %[[K1:.*]] = aievec.shift %[[K1T]], %[[Z]], %{{.*}} {isAcc = false} : vector<32xbf16>, vector<32xbf16>, i32, vector<32xbf16>
+//      CHECK:    %[[K2S:.*]] = aievec.shift %[[K]], %[[K]], %{{.*}} {isAcc = false} : vector<32xbf16>, vector<32xbf16>, i32, vector<32xbf16>
+//      CHECK:    %[[K2T:.*]] = aievec.shift %[[Z]], %[[K2S]], %{{.*}} {isAcc = false} : vector<32xbf16>, vector<32xbf16>, i32, vector<32xbf16>
+//      CHECK:    %[[K2:.*]] = aievec.shift %[[K2T]], %[[Z]], %{{.*}} {isAcc = false} : vector<32xbf16>, vector<32xbf16>, i32, vector<32xbf16>
+//      CHECK:    affine.for %[[A3:.*]] = 0 to 16 {
+//      CHECK:      affine.for %[[A4:.*]] = 0 to 256 step 16 {
+//      CHECK:        %[[D0:.*]] = aievec.upd %[[A0]][%[[A3]], %[[A4]]] {index = 0 : i8, offset = 0 : si32} : memref<18x288xbf16>, vector<32xbf16>
+//      CHECK:        %[[M0:.*]] = aievec.mul_conv %[[D0]], %[[K0]] {M = 16 : i32, N = 8 : i32} : vector<32xbf16>, vector<32xbf16>, vector<16xf32>
+//      CHECK:        %[[D1:.*]] = aievec.upd %[[A0]][%{{.*}}, %[[A4]]] {index = 0 : i8, offset = 0 : si32} : memref<18x288xbf16>, vector<32xbf16>
+//      CHECK:        %[[M1:.*]] = aievec.fma_conv %[[D1]], %[[K1]], %[[M0]] {M = 16 : i32, N = 8 : i32} : vector<32xbf16>, vector<32xbf16>, vector<16xf32>
+//      CHECK:        %[[D2:.*]] = aievec.upd %[[A0]][%{{.*}}, %[[A4]]] {index = 0 : i8, offset = 0 : si32} : memref<18x288xbf16>, vector<32xbf16>
+//      CHECK:        %[[M2:.*]] = aievec.fma_conv %[[D2]], %[[K2]], %[[M1]] {M = 16 : i32, N = 8 : i32} : vector<32xbf16>, vector<32xbf16>, vector<16xf32>
+//      CHECK:        %[[R:.*]] = aievec.srs %[[M2]] {shift = 0 : i8} : vector<16xf32>, vector<16xbf16>
+//      CHECK:        vector.transfer_write %[[R]], %[[A2]][%[[A3]], %[[A4]]] {in_bounds = [true]} : vector<16xbf16>, memref<16x256xbf16>
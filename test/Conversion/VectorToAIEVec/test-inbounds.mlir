@@ -0,0 +1,70 @@
+// RUN: aie-opt %s -split-input-file --convert-vector-to-aievec="aie-target=aieml" | FileCheck %s
+
+// The last iteration of the loop reads and writes past the end of %a and %b,
+// so it is peeled into an epilogue. The accesses of the main loop are proven
+// to be in bounds, and the read is lowered to a UPD. The ones in the epilogue
+// are left out of bounds, and the read isn't turned into a full-width UPD.
+// CHECK-LABEL: func @ragged_loop
+// CHECK: affine.for %[[I:.*]] = 0 to 96 step 16 {
+// CHECK:   aievec.upd %{{.*}}[%[[I]]] {{.*}} : memref<100xi32>, vector<16xi32>
+// CHECK:   vector.transfer_write %{{.*}}, %{{.*}}[%[[I]]] {in_bounds = [true]} : vector<16xi32>, memref<100xi32>
+// CHECK: }
+// CHECK-NOT: aievec.upd
+// CHECK: vector.transfer_read %{{.*}}[%{{.*}}], %{{.*}} : memref<100xi32>, vector<16xi32>
+// CHECK-NOT: aievec.upd
+// CHECK: vector.transfer_write %{{.*}}, %{{.*}}[%{{.*}}] : vector<16xi32>, memref<100xi32>
+// CHECK-NOT: affine.for
+func.func @ragged_loop(%a: memref<100xi32>, %b: memref<100xi32>) {
+  %c0_i32 = arith.constant 0 : i32
+  affine.for %i = 0 to 100 step 16 {
+    %0 = vector.transfer_read %a[%i], %c0_i32 : memref<100xi32>, vector<16xi32>
+    %1 = arith.addi %0, %0 : vector<16xi32>
+    vector.transfer_write %1, %b[%i] : vector<16xi32>, memref<100xi32>
+  }
+  return
+}
+
+// -----
+
+// Accesses through affine maps are bounded by the range of the map.
+// CHECK-LABEL: func @shifted_access
+// CHECK: vector.transfer_write %{{.*}} {in_bounds = [true]} : vector<16xi32>, memref<128xi32>
+func.func @shifted_access(%a: memref<128xi32>, %b: memref<128xi32>) {
+  %c0_i32 = arith.constant 0 : i32
+  affine.for %i = 0 to 96 step 16 {
+    %0 = vector.transfer_read %a[%i], %c0_i32 : memref<128xi32>, vector<16xi32>
+    %j = affine.apply affine_map<(d0) -> (d0 + 32)>(%i)
+    vector.transfer_write %0, %b[%j] : vector<16xi32>, memref<128xi32>
+  }
+  return
+}
+
+// -----
+
+// Nothing is known about the size of a dynamic memref, so its accesses are
+// left out of bounds, and the read isn't turned into a UPD.
+// CHECK-LABEL: func @dynamic_memref
+// CHECK: vector.transfer_read %{{.*}}[%{{.*}}], %{{.*}} : memref<?xi32>, vector<16xi32>
+// CHECK: vector.transfer_write %{{.*}}, %{{.*}}[%{{.*}}] : vector<16xi32>, memref<?xi32>
+func.func @dynamic_memref(%a: memref<?xi32>, %b: memref<?xi32>) {
+  %c0_i32 = arith.constant 0 : i32
+  affine.for %i = 0 to 128 step 16 {
+    %0 = vector.transfer_read %a[%i], %c0_i32 : memref<?xi32>, vector<16xi32>
+    vector.transfer_write %0, %b[%i] : vector<16xi32>, memref<?xi32>
+  }
+  return
+}
+
+// -----
+
+// Nothing is known about the range of an index passed as an argument, so the
+// read can't be proven to be in bounds and isn't turned into a UPD.
+// CHECK-LABEL: func @dynamic_index
+// CHECK-NOT: aievec.upd
+// CHECK: vector.transfer_read %{{.*}}[%{{.*}}], %{{.*}} : memref<128xi32>, vector<16xi32>
+// CHECK-NOT: aievec.upd
+func.func @dynamic_index(%a: memref<128xi32>, %i: index) -> vector<16xi32> {
+  %c0_i32 = arith.constant 0 : i32
+  %0 = vector.transfer_read %a[%i], %c0_i32 : memref<128xi32>, vector<16xi32>
+  return %0 : vector<16xi32>
+}
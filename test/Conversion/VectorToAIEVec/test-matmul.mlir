@@ -0,0 +1,112 @@
+// RUN: aie-opt %s -split-input-file --convert-vector-to-aievec="aie-target=aieml" | FileCheck %s
+
+#map0 = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// CHECK-LABEL: func @matmul_i8
+// CHECK-SAME: %[[A:[A-Za-z0-9]+]]: vector<4x8xi8>
+// CHECK-SAME: %[[B:[A-Za-z0-9]+]]: vector<8x4xi8>
+// CHECK-SAME: %[[C:[A-Za-z0-9]+]]: vector<4x4xi32>
+func.func @matmul_i8(%a : vector<4x8xi8>, %b : vector<8x4xi8>,
+                     %c : vector<4x4xi32>) -> vector<4x4xi32> {
+  // CHECK: %[[R:.*]] = aievec.matmul %[[A]], %[[B]], %[[C]] : vector<4x8xi8>, vector<8x4xi8> into vector<4x4xi32>
+  // CHECK-NOT: vector.contract
+  %0 = arith.extsi %a : vector<4x8xi8> to vector<4x8xi32>
+  %1 = arith.extsi %b : vector<8x4xi8> to vector<8x4xi32>
+  %2 = vector.contract {indexing_maps = [#map0, #map1, #map2],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>} %0, %1, %c
+                        : vector<4x8xi32>, vector<8x4xi32> into vector<4x4xi32>
+  // CHECK: return %[[R]] : vector<4x4xi32>
+  return %2 : vector<4x4xi32>
+}
+
+// -----
+
+#map0 = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// CHECK-LABEL: func @matmul_i16
+// CHECK-SAME: %[[A:[A-Za-z0-9]+]]: vector<4x4xi16>
+// CHECK-SAME: %[[B:[A-Za-z0-9]+]]: vector<4x4xi16>
+// CHECK-SAME: %[[C:[A-Za-z0-9]+]]: vector<4x4xi64>
+func.func @matmul_i16(%a : vector<4x4xi16>, %b : vector<4x4xi16>,
+                      %c : vector<4x4xi64>) -> vector<4x4xi64> {
+  // CHECK: %[[R:.*]] = aievec.matmul %[[A]], %[[B]], %[[C]] : vector<4x4xi16>, vector<4x4xi16> into vector<4x4xi64>
+  %0 = arith.extsi %a : vector<4x4xi16> to vector<4x4xi64>
+  %1 = arith.extsi %b : vector<4x4xi16> to vector<4x4xi64>
+  %2 = vector.contract {indexing_maps = [#map0, #map1, #map2],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>} %0, %1, %c
+                        : vector<4x4xi64>, vector<4x4xi64> into vector<4x4xi64>
+  // CHECK: return %[[R]] : vector<4x4xi64>
+  return %2 : vector<4x4xi64>
+}
+
+// -----
+
+#map0 = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// CHECK-LABEL: func @matmul_bf16
+// CHECK-SAME: %[[A:[A-Za-z0-9]+]]: vector<4x8xbf16>
+// CHECK-SAME: %[[B:[A-Za-z0-9]+]]: vector<8x4xbf16>
+// CHECK-SAME: %[[C:[A-Za-z0-9]+]]: vector<4x4xf32>
+func.func @matmul_bf16(%a : vector<4x8xbf16>, %b : vector<8x4xbf16>,
+                       %c : vector<4x4xf32>) -> vector<4x4xf32> {
+  // CHECK: %[[R:.*]] = aievec.matmul %[[A]], %[[B]], %[[C]] : vector<4x8xbf16>, vector<8x4xbf16> into vector<4x4xf32>
+  %0 = arith.extf %a : vector<4x8xbf16> to vector<4x8xf32>
+  %1 = arith.extf %b : vector<8x4xbf16> to vector<8x4xf32>
+  %2 = vector.contract {indexing_maps = [#map0, #map1, #map2],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>} %0, %1, %c
+                        : vector<4x8xf32>, vector<8x4xf32> into vector<4x4xf32>
+  // CHECK: return %[[R]] : vector<4x4xf32>
+  return %2 : vector<4x4xf32>
+}
+
+// -----
+
+#map0 = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// Contractions larger than a single intrinsic are split into 4x8x4 tiles,
+// accumulating along the reduction dimension.
+// CHECK-LABEL: func @matmul_i8_8x16x8
+// CHECK-COUNT-8: aievec.matmul {{.*}} : vector<4x8xi8>, vector<8x4xi8> into vector<4x4xi32>
+// CHECK-NOT: vector.contract
+func.func @matmul_i8_8x16x8(%a : vector<8x16xi8>, %b : vector<16x8xi8>,
+                            %c : vector<8x8xi32>) -> vector<8x8xi32> {
+  %0 = arith.extsi %a : vector<8x16xi8> to vector<8x16xi32>
+  %1 = arith.extsi %b : vector<16x8xi8> to vector<16x8xi32>
+  %2 = vector.contract {indexing_maps = [#map0, #map1, #map2],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>} %0, %1, %c
+                        : vector<8x16xi32>, vector<16x8xi32> into vector<8x8xi32>
+  return %2 : vector<8x8xi32>
+}
+
+// -----
+
+#map0 = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// Accumulators narrower than the one of the intrinsic aren't supported.
+// CHECK-LABEL: func @matmul_i8_acc_i16
+// CHECK-NOT: aievec.matmul
+// CHECK: vector.contract
+func.func @matmul_i8_acc_i16(%a : vector<4x8xi8>, %b : vector<8x4xi8>,
+                             %c : vector<4x4xi16>) -> vector<4x4xi16> {
+  %0 = arith.extsi %a : vector<4x8xi8> to vector<4x8xi16>
+  %1 = arith.extsi %b : vector<8x4xi8> to vector<8x4xi16>
+  %2 = vector.contract {indexing_maps = [#map0, #map1, #map2],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>} %0, %1, %c
+                        : vector<4x8xi16>, vector<8x4xi16> into vector<4x4xi16>
+  return %2 : vector<4x4xi16>
+}
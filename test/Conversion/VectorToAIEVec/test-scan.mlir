@@ -0,0 +1,42 @@
+// RUN: aie-opt %s -split-input-file --convert-vector-to-aievec="aie-target=aieml" | FileCheck %s
+
+// Inclusive scans ignore the initial value.
+// CHECK-LABEL: func @scan_inclusive_i32
+// CHECK-SAME: %[[SRC:[A-Za-z0-9]+]]: vector<16xi32>
+// CHECK-DAG: %[[C0:.*]] = arith.constant 0 : i32
+// CHECK-DAG: %[[C60:.*]] = arith.constant 60 : i32
+// CHECK-DAG: %[[C56:.*]] = arith.constant 56 : i32
+// CHECK-DAG: %[[C48:.*]] = arith.constant 48 : i32
+// CHECK-DAG: %[[C32:.*]] = arith.constant 32 : i32
+// CHECK: %[[ZERO:.*]] = aievec.broadcast_scalar %[[C0]] : i32, vector<16xi32>
+// CHECK: %[[S1:.*]] = aievec.shift %[[ZERO]], %[[SRC]], %[[C60]] {isAcc = false} : vector<16xi32>, vector<16xi32>, i32, vector<16xi32>
+// CHECK: %[[A1:.*]] = aievec.add_elem %[[SRC]], %[[S1]] : vector<16xi32>
+// CHECK: %[[S2:.*]] = aievec.shift %[[ZERO]], %[[A1]], %[[C56]] {isAcc = false} : vector<16xi32>, vector<16xi32>, i32, vector<16xi32>
+// CHECK: %[[A2:.*]] = aievec.add_elem %[[A1]], %[[S2]] : vector<16xi32>
+// CHECK: %[[S4:.*]] = aievec.shift %[[ZERO]], %[[A2]], %[[C48]] {isAcc = false} : vector<16xi32>, vector<16xi32>, i32, vector<16xi32>
+// CHECK: %[[A4:.*]] = aievec.add_elem %[[A2]], %[[S4]] : vector<16xi32>
+// CHECK: %[[S8:.*]] = aievec.shift %[[ZERO]], %[[A4]], %[[C32]] {isAcc = false} : vector<16xi32>, vector<16xi32>, i32, vector<16xi32>
+// CHECK: %[[A8:.*]] = aievec.add_elem %[[A4]], %[[S8]] : vector<16xi32>
+// CHECK-NOT: aievec.broadcast_scalar
+// CHECK: return %[[A8]] : vector<16xi32>
+func.func @scan_inclusive_i32(%src : vector<16xi32>, %init : vector<i32>) -> vector<16xi32> {
+  %0:2 = vector.scan <add>, %src, %init {inclusive = true, reduction_dim = 0 : i64} : vector<16xi32>, vector<i32>
+  return %0#0 : vector<16xi32>
+}
+
+// -----
+
+// Exclusive scans shift the inclusive prefix sums up by one lane, and add the
+// initial value to every lane.
+// CHECK-LABEL: func @scan_exclusive_i16
+// CHECK-SAME: %{{[A-Za-z0-9]+}}: vector<32xi16>, %[[INIT:[A-Za-z0-9]+]]: vector<i16>
+// CHECK-COUNT-5: aievec.add_elem {{.*}} : vector<32xi16>
+// CHECK: %[[EXCL:.*]] = aievec.shift {{.*}} : vector<32xi16>, vector<32xi16>, i32, vector<32xi16>
+// CHECK: %[[I:.*]] = vector.extractelement %[[INIT]][] : vector<i16>
+// CHECK: %[[IV:.*]] = aievec.broadcast_scalar %[[I]] : i16, vector<32xi16>
+// CHECK: %[[DEST:.*]] = aievec.add_elem %[[EXCL]], %[[IV]] : vector<32xi16>
+// CHECK: return %[[DEST]] : vector<32xi16>
+func.func @scan_exclusive_i16(%src : vector<32xi16>, %init : vector<i16>) -> vector<32xi16> {
+  %0:2 = vector.scan <add>, %src, %init {inclusive = false, reduction_dim = 0 : i64} : vector<32xi16>, vector<i16>
+  return %0#0 : vector<32xi16>
+}
@@ -0,0 +1,70 @@
+// RUN: aie-opt %s -split-input-file --lower-vector-math-to-aievec="aie-target=aieml" | FileCheck %s
+// RUN: aie-opt %s -split-input-file --lower-vector-math-to-aievec | FileCheck %s --check-prefix=CHECK-V1
+
+// CHECK-LABEL: func.func private @vec_exp_v16float(vector<16xf32>) -> vector<16xf32> attributes {aie.c_linkage}
+// CHECK-LABEL: func @vecexp_f32
+// CHECK-SAME: %[[A:[A-Za-z0-9]+]]: vector<16xf32>
+// CHECK: %[[E:.*]] = call @vec_exp_v16float(%[[A]]) : (vector<16xf32>) -> vector<16xf32>
+// CHECK: return %[[E]] : vector<16xf32>
+// CHECK-V1-LABEL: func.func private @vec_exp_v8float(vector<8xf32>) -> vector<8xf32>
+// CHECK-V1-LABEL: func @vecexp_f32
+// CHECK-V1-SAME: %[[A:[A-Za-z0-9]+]]: vector<16xf32>
+// CHECK-V1: %[[A0:.*]] = aievec.ext %[[A]] {index = 0 : i8} : vector<16xf32>, vector<8xf32>
+// CHECK-V1: %[[E0:.*]] = call @vec_exp_v8float(%[[A0]]) : (vector<8xf32>) -> vector<8xf32>
+// CHECK-V1: %[[A1:.*]] = aievec.ext %[[A]] {index = 1 : i8} : vector<16xf32>, vector<8xf32>
+// CHECK-V1: %[[E1:.*]] = call @vec_exp_v8float(%[[A1]]) : (vector<8xf32>) -> vector<8xf32>
+// CHECK-V1: %[[E:.*]] = aievec.concat %[[E0]], %[[E1]] : vector<8xf32>, vector<16xf32>
+// CHECK-V1: return %[[E]] : vector<16xf32>
+func.func @vecexp_f32(%a: vector<16xf32>) -> vector<16xf32> {
+  %0 = math.exp %a : vector<16xf32>
+  return %0 : vector<16xf32>
+}
+
+// -----
+
+// Every function is declared once.
+// CHECK-DAG: func.func private @vec_tanh_v16float(vector<16xf32>) -> vector<16xf32>
+// CHECK-DAG: func.func private @vec_rsqrt_v16float(vector<16xf32>) -> vector<16xf32>
+// CHECK-NOT: func.func private
+// CHECK-LABEL: func @vectanh_rsqrt_f32
+// CHECK: call @vec_tanh_v16float
+// CHECK: call @vec_rsqrt_v16float
+// CHECK: call @vec_tanh_v16float
+func.func @vectanh_rsqrt_f32(%a: vector<16xf32>) -> vector<16xf32> {
+  %0 = math.tanh %a : vector<16xf32>
+  %1 = math.rsqrt %0 : vector<16xf32>
+  %2 = math.tanh %1 : vector<16xf32>
+  return %2 : vector<16xf32>
+}
+
+// -----
+
+// Sigmoids are lowered as a whole.
+// CHECK-LABEL: func @vecsigmoid_f32
+// CHECK-SAME: %[[A:[A-Za-z0-9]+]]: vector<16xf32>
+// CHECK-NOT: math.exp
+// CHECK-NOT: arith.divf
+// CHECK: %[[S:.*]] = call @vec_sigmoid_v16float(%[[A]]) : (vector<16xf32>) -> vector<16xf32>
+// CHECK-NOT: vec_exp
+// CHECK: return %[[S]] : vector<16xf32>
+func.func @vecsigmoid_f32(%a: vector<16xf32>) -> vector<16xf32> {
+  %cst = arith.constant dense<1.000000e+00> : vector<16xf32>
+  %0 = arith.negf %a : vector<16xf32>
+  %1 = math.exp %0 : vector<16xf32>
+  %2 = arith.addf %1, %cst : vector<16xf32>
+  %3 = arith.divf %cst, %2 : vector<16xf32>
+  return %3 : vector<16xf32>
+}
+
+// -----
+
+// Vectors the library can't take, and scalars, are left alone.
+// CHECK-LABEL: func @vecexp_unsupported
+// CHECK-NOT: call
+// CHECK: math.exp {{.*}} : vector<12xf32>
+// CHECK: math.exp {{.*}} : f32
+func.func @vecexp_unsupported(%a: vector<12xf32>, %b: f32) -> (vector<12xf32>, f32) {
+  %0 = math.exp %a : vector<12xf32>
+  %1 = math.exp %b : f32
+  return %0, %1 : vector<12xf32>, f32
+}
@@ -0,0 +1,15 @@
+; A reduced intrinsic wrapper, as xchesscc generates it from
+; chess_intrinsic_wrapper.cpp.
+
+target datalayout = "e-m:e-p:20:32-i1:8:32-i8:8:32-i16:16:32-i32:32:32-f32:32:32-i64:32-f64:32-a:0:32-n32"
+target triple = "chess"
+
+define void @llvm___aie___lock___acquire___reg(i32 noundef %0, i32 noundef %1) #0 {
+  tail call void @_Z25acquire_lock_and_wait_regjj(i32 noundef %0, i32 noundef %1) #1
+  ret void
+}
+
+declare void @_Z25acquire_lock_and_wait_regjj(i32 noundef, i32 noundef) #1
+
+attributes #0 = { mustprogress nounwind }
+attributes #1 = { nocallback nounwind }
@@ -0,0 +1,25 @@
+//===- attributes.mlir -----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-chess-llvmir %s | FileCheck %s
+
+// CHECK-LABEL: define i32 @core_1_2(i32 %arg0, i32 %arg1)
+// CHECK: = call i32 @llvm.smax.i32(i32 %arg0, i32 %arg1)
+// CHECK: declare i32 @llvm.smax.i32(i32, i32)
+// CHECK-NOT: nocallback
+// CHECK-NOT: memory(
+// CHECK: attributes #{{[0-9]+}} = { {{.*}}readnone{{.*}} }
+
+module {
+  llvm.func @core_1_2(%arg0: i32, %arg1: i32) -> i32 {
+    %0 = "llvm.intr.smax"(%arg0, %arg1) : (i32, i32) -> i32
+    llvm.return %0 : i32
+  }
+}
@@ -0,0 +1,38 @@
+//===- intrinsic-wrapper.mlir ----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-chess-llvmir --chess-intrinsic-wrapper=%S/Inputs/chess_intrinsic_wrapper.ll %s | FileCheck %s
+// RUN: aie-translate --aie-generate-chess-llvmir --chess-intrinsic-wrapper=%S/Inputs/chess_intrinsic_wrapper.ll %s | FileCheck %s --check-prefix=LEGAL
+// RUN: not aie-translate --aie-generate-chess-llvmir --chess-intrinsic-wrapper=%t.missing.ll %s 2>&1 | FileCheck %s --check-prefix=MISSING
+
+// The wrapper is linked into the module of the core, under the target of the
+// core, and is legalized like the code of the core.
+// CHECK: define void @core_1_2()
+// CHECK: call void @llvm___aie___lock___acquire___reg(i32 3, i32 1)
+// CHECK: define void @llvm___aie___lock___acquire___reg(i32 %arg0, i32 %arg1)
+// CHECK: tail call void @_Z25acquire_lock_and_wait_regjj(i32 %arg0, i32 %arg1)
+// CHECK: declare void @_Z25acquire_lock_and_wait_regjj(i32, i32)
+
+// LEGAL-NOT: target triple = "chess"
+// LEGAL-NOT: noundef
+// LEGAL-NOT: nocallback
+// LEGAL-NOT: mustprogress
+
+// MISSING: error: 'builtin.module' op cannot open intrinsic wrapper '{{.*}}missing.ll'
+
+module {
+  llvm.func @core_1_2() {
+    %0 = llvm.mlir.constant(3 : i32) : i32
+    %1 = llvm.mlir.constant(1 : i32) : i32
+    llvm.call @llvm___aie___lock___acquire___reg(%0, %1) : (i32, i32) -> ()
+    llvm.return
+  }
+  llvm.func @llvm___aie___lock___acquire___reg(i32, i32)
+}
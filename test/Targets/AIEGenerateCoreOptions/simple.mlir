@@ -0,0 +1,29 @@
+//===- simple.mlir ---------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-core-options %s | FileCheck --match-full-lines %s
+// CHECK: {(2,3):{'inline_threshold':500,'opt_level':3,},(3,3):{'opt_level':1,},}
+
+module {
+  AIE.device(xcvc1902) {
+    %t13 = AIE.tile(1, 3)
+    %t23 = AIE.tile(2, 3)
+    %t33 = AIE.tile(3, 3)
+    AIE.core(%t13) {
+      AIE.end
+    }
+    AIE.core(%t23) {
+      AIE.end
+    } { compile_options = {opt_level = 3 : i32, inline_threshold = 500 : i32} }
+    AIE.core(%t33) {
+      AIE.end
+    } { compile_options = {opt_level = 1 : i32} }
+  }
+}
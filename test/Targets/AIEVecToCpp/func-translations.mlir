@@ -4,6 +4,9 @@
 // CHECK: int32_t external_function(v16int32);
 func.func private @external_function(%v : vector<16xi32>) -> i32
 
+// CHECK: extern "C" v16float vec_exp_v16float(v16float);
+func.func private @vec_exp_v16float(%v : vector<16xf32>) -> vector<16xf32> attributes {aie.c_linkage}
+
 // CHECK: void external_function_with_memref(int16_t * restrict);
 func.func private @external_function_with_memref(%m : memref<64xi16>)
 
@@ -59,7 +59,7 @@ module  {
 //CHECK-NEXT:    size_t v16 = 16;
 //CHECK-NEXT:    for (size_t v17 = v14; v17 < v15; v17 += v16)
 //CHECK-NEXT:    chess_prepare_for_pipelining
-//CHECK-NEXT:    chess_loop_range(127, 128)
+//CHECK-NEXT:    chess_loop_range(128, 128)
 //CHECK-NEXT:    {
 //CHECK-NEXT:      v16int16 v18 = *(v16int16 *)(v3 + 2046*v9+v17);
 //CHECK-NEXT:      v32int16 v19;
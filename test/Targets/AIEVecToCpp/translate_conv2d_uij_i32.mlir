@@ -64,7 +64,7 @@ func.func @conv2d_0(%arg0: memref<2048x2048xi32>, %arg1: memref<9xi32>, %arg2: m
 //CHECK-NEXT:    size_t v18 = 8;
 //CHECK-NEXT:    for (size_t v19 = v16; v19 < v17; v19 += v18)
 //CHECK-NEXT:    chess_prepare_for_pipelining
-//CHECK-NEXT:    chess_loop_range(255, 256)
+//CHECK-NEXT:    chess_loop_range(256, 256)
 //CHECK-NEXT:    {
 //CHECK-NEXT:      v8int32 v20 = *(v8int32 *)(v3 + 2046*v11+v19);
 //CHECK-NEXT:      v16int32 v21;
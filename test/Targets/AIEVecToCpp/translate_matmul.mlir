@@ -0,0 +1,26 @@
+// RUN: aie-translate %s -aieml=true -aievec-to-cpp | FileCheck %s
+
+// CHECK-LABEL: v16int32 matmul_i8(v32int8 [[A:.*]], v32int8 [[B:.*]], v16int32 [[C:.*]]) {
+// CHECK: v16int32 [[R:.*]] = v16int32(mac_4x8_8x4([[A]], [[B]], v16acc32([[C]])));
+// CHECK: return [[R]];
+func.func @matmul_i8(%a : vector<4x8xi8>, %b : vector<8x4xi8>, %c : vector<4x4xi32>) -> vector<4x4xi32> {
+  %0 = aievec.matmul %a, %b, %c : vector<4x8xi8>, vector<8x4xi8> into vector<4x4xi32>
+  return %0 : vector<4x4xi32>
+}
+
+// CHECK-LABEL: v16float matmul_bf16(v32bfloat16 [[A:.*]], v32bfloat16 [[B:.*]], v16float [[C:.*]]) {
+// CHECK: v16float [[R:.*]] = v16float(mac_4x8_8x4([[A]], [[B]], v16accfloat([[C]])));
+func.func @matmul_bf16(%a : vector<4x8xbf16>, %b : vector<8x4xbf16>, %c : vector<4x4xf32>) -> vector<4x4xf32> {
+  %0 = aievec.matmul %a, %b, %c : vector<4x8xbf16>, vector<8x4xbf16> into vector<4x4xf32>
+  return %0 : vector<4x4xf32>
+}
+
+// Packed tiles are read as flat vectors and reshaped into matrices.
+// CHECK-LABEL: v16int64 matmul_i16(v16int16 [[A:.*]], v16int16 [[B:.*]], v16int64 [[C:.*]]) {
+// CHECK: v16int16 [[AM:.*]] = [[A]];
+// CHECK: v16int64 [[R:.*]] = v16int64(mac_4x4_4x4([[AM]], [[B]], v16acc64([[C]])));
+func.func @matmul_i16(%a : vector<16xi16>, %b : vector<4x4xi16>, %c : vector<4x4xi64>) -> vector<4x4xi64> {
+  %0 = vector.shape_cast %a : vector<16xi16> to vector<4x4xi16>
+  %1 = aievec.matmul %0, %b, %c : vector<4x4xi16>, vector<4x4xi16> into vector<4x4xi64>
+  return %1 : vector<4x4xi64>
+}
@@ -0,0 +1,38 @@
+// RUN: aie-translate %s -aievec-to-cpp | FileCheck %s
+
+// Arguments that a call site may bind to the same memory aren't restrict, and
+// aren't read through a restrict copy either.
+// CHECK-LABEL: void kernel_aliased(int16_t * v1, int16_t * v2) {
+// CHECK-NOT: restrict
+// CHECK: upd_w(v{{[0-9]+}}, 0, *(v16int16 *)(v1{{.*}}));
+func.func @kernel_aliased(%arg0: memref<64xi16>, %arg1: memref<64xi16>) {
+  %c0 = arith.constant 0 : index
+  %0 = aievec.upd %arg0[%c0] {index = 0 : i8, offset = 0 : si32} : memref<64xi16>, vector<32xi16>
+  vector.transfer_write %0, %arg1[%c0] : vector<32xi16>, memref<64xi16>
+  return
+}
+
+// CHECK-LABEL: void kernel_disjoint(int16_t * restrict v1, int16_t * restrict v2) {
+// CHECK: int16_t * restrict [[PTR:r_v[0-9]+_v1]] = v1;
+// CHECK: upd_w(v{{[0-9]+}}, 0, *(v16int16 *)([[PTR]]{{.*}}));
+func.func @kernel_disjoint(%arg0: memref<64xi16>, %arg1: memref<64xi16>) {
+  %c0 = arith.constant 0 : index
+  %0 = aievec.upd %arg0[%c0] {index = 0 : i8, offset = 0 : si32} : memref<64xi16>, vector<32xi16>
+  vector.transfer_write %0, %arg1[%c0] : vector<32xi16>, memref<64xi16>
+  return
+}
+
+// Only the memref arguments passed overlapping memory lose restrict.
+// CHECK: void external_kernel(int16_t *, int16_t *, int16_t * restrict);
+func.func private @external_kernel(memref<64xi16>, memref<64xi16>, memref<64xi16>)
+
+// CHECK-LABEL: void caller(int16_t * restrict v1, int16_t * restrict v2) {
+// CHECK: kernel_aliased(v1, v1);
+// CHECK: kernel_disjoint(v1, v2);
+// CHECK: external_kernel(v1, v1, v2);
+func.func @caller(%arg0: memref<64xi16>, %arg1: memref<64xi16>) {
+  func.call @kernel_aliased(%arg0, %arg0) : (memref<64xi16>, memref<64xi16>) -> ()
+  func.call @kernel_disjoint(%arg0, %arg1) : (memref<64xi16>, memref<64xi16>) -> ()
+  func.call @external_kernel(%arg0, %arg0, %arg1) : (memref<64xi16>, memref<64xi16>, memref<64xi16>) -> ()
+  return
+}
@@ -0,0 +1,48 @@
+//===- simple.mlir ---------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: aie-lower-cores --emit-ldscript --core-pipeline="convert-func-to-llvm{use-bare-ptr-memref-call-conv},convert-memref-to-llvm,convert-arith-to-llvm,reconcile-unrealized-casts" --output-dir %t %s
+// RUN: FileCheck --check-prefix=LL33 %s < %t/core_3_3.ll
+// RUN: FileCheck --check-prefix=LL43 %s < %t/core_4_3.ll
+// RUN: FileCheck --check-prefix=LD33 %s < %t/core_3_3.ld.script
+// RUN: FileCheck --check-prefix=MLIR43 %s < %t/core_4_3.opt.mlir
+
+// LL33: @a = external global [4 x i32]
+// LL33: define void @core_3_3()
+// LL33-NOT: core_4_3
+
+// LL43: define void @core_4_3()
+// LL43: call void @llvm.aie.lock.acquire.reg(i32 {{[0-9]+}}, i32 1)
+// LL43-NOT: core_3_3
+
+// LD33: a = .;
+// LD33: PROVIDE(_main = core_3_3);
+
+// MLIR43: llvm.func @core_4_3()
+
+module @lower_cores {
+ AIE.device(xcvc1902) {
+  %t33 = AIE.tile(3, 3)
+  %t43 = AIE.tile(4, 3)
+  %a = AIE.buffer(%t33) {address = 3104 : i32, sym_name = "a"} : memref<4xi32>
+  %l = AIE.lock(%t43, 0)
+  %core33 = AIE.core(%t33) {
+    %0 = arith.constant 0 : index
+    %377 = arith.constant 377 : i32
+    memref.store %377, %a[%0] : memref<4xi32>
+    AIE.end
+  }
+  %core43 = AIE.core(%t43) {
+    AIE.useLock(%l, Acquire, 1)
+    AIE.end
+  }
+ }
+}
@@ -0,0 +1,39 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2023 Xilinx Inc.
+
+# Print what the aiecc profiler makes of recorded commands.
+#
+#   profile_events.py TIMING
+#
+# TIMING is the --mlir-timing output of an aie-opt command that ran from time
+# 10, whose passes are printed as nested events.  Then the summary of a few
+# commands run on two workers is printed, including their critical path.  The
+# profiler comes from the aiecc package that is installed next to aiecc.py.
+
+import os
+import shutil
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.realpath(shutil.which('aiecc.py'))))
+import aiecc.profile
+
+def dump(events, depth=0):
+  for e in events:
+    print("%s%s %.4f-%.4f" % ('  ' * depth, e.name, e.start, e.end))
+    dump(e.children, depth + 1)
+
+p = aiecc.profile.profiler()
+with open(sys.argv[1]) as f:
+  p.record(['aie-opt'], 10.0, 10.0203, f.read())
+dump(p.events)
+
+p = aiecc.profile.profiler()
+for (command, start, end) in [('opt', 0.0, 1.0), ('opt', 0.0, 3.0),
+                              ('llc', 1.0, 2.0), ('llvm-objcopy', 2.0, 2.5),
+                              ('llc', 3.5, 4.0)]:
+  p.record([command], start, end)
+p.dump_summary(2)
@@ -0,0 +1,24 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2023 Xilinx Inc.
+
+# Send a command to an aiecc worker at a unix socket, the way a client that
+# doesn't go through aiecc could, and print the reply.
+#
+#   send_request.py SOCKET COMMAND...
+
+import json
+import socket
+import sys
+
+(address, command) = (sys.argv[1], sys.argv[2:])
+request = {'command': command, 'inputs': {}, 'outputs': []}
+with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as s:
+  s.connect(address)
+  s.sendall(json.dumps(request).encode() + b'\n')
+  reply = json.loads(s.makefile().readline())
+print("returncode: %d" % reply['returncode'])
+sys.stdout.write(reply['stderr'])
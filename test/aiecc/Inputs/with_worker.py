@@ -0,0 +1,42 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2023 Xilinx Inc.
+
+# Run a command while an aiecc worker listens at a unix socket.
+#
+#   with_worker.py SOCKET CACHEDIR PEANO COMMAND...
+#
+# The worker runs with the aiecc package that is installed next to aiecc.py
+# and, like aiecc --peano=PEANO, finds the Peano tools in PEANO/bin.  It is
+# stopped when the command is done.
+
+import os
+import shutil
+import subprocess
+import sys
+import time
+
+(socket, cachedir, peano, command) = (sys.argv[1], sys.argv[2], sys.argv[3], sys.argv[4:])
+env = dict(os.environ)
+env['PYTHONPATH'] = os.path.dirname(os.path.realpath(shutil.which('aiecc.py')))
+env['PATH'] = os.pathsep.join([os.path.join(peano, 'bin'), env['PATH']])
+if(os.path.exists(socket)):
+  os.remove(socket)
+worker = subprocess.Popen([sys.executable, '-m', 'aiecc.executor',
+                           '--listen', 'unix:' + socket,
+                           '--cache-dir', cachedir, '-j', '1'],
+                          env=env, stdout=subprocess.DEVNULL)
+try:
+  for i in range(600):
+    if(os.path.exists(socket) or worker.poll() is not None):
+      break
+    time.sleep(0.1)
+  if(not os.path.exists(socket)):
+    sys.exit("aiecc worker failed to start")
+  sys.exit(subprocess.call(command))
+finally:
+  worker.terminate()
+  worker.wait()
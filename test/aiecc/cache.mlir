@@ -0,0 +1,61 @@
+//===- cache.mlir ----------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The Peano tools are replaced by stand-ins, which is enough to exercise the
+// cache of the non-unified flow.
+// RUN: rm -rf %t.cache %t.prj
+// RUN: aiecc.py --peano=%S/Inputs/fake-peano --no-unified --compile --no-xchesscc --no-xbridge --no-link --no-compile-host -v --tmpdir=%t.prj --cache-dir=%t.cache %s | FileCheck %s --check-prefix=MISS
+// RUN: rm %t.prj/core_1_2.o %t.prj/core_2_2.o
+// RUN: aiecc.py --peano=%S/Inputs/fake-peano --no-unified --compile --no-xchesscc --no-xbridge --no-link --no-compile-host -v --tmpdir=%t.prj --cache-dir=%t.cache %s | FileCheck %s --check-prefix=HIT
+// RUN: test -f %t.prj/core_1_2.o && test -f %t.prj/core_2_2.o
+// RUN: sed 's/7 : i32/8 : i32/' %s > %t.changed.mlir
+// RUN: aiecc.py --peano=%S/Inputs/fake-peano --no-unified --compile --no-xchesscc --no-xbridge --no-link --no-compile-host -v --tmpdir=%t.prj --cache-dir=%t.cache %t.changed.mlir | FileCheck %s --check-prefix=CHANGED
+// RUN: aiecc.py --peano=%S/Inputs/fake-peano --no-unified --compile --no-xchesscc --no-xbridge --no-link --no-compile-host -v --tmpdir=%t.prj --cache-dir=%t.cache --lto %s | FileCheck %s --check-prefix=FLAGS
+
+// MISS-DAG: {{^}}llc {{.*}}core_1_2.stripped.ll
+// MISS-DAG: {{^}}llc {{.*}}core_2_2.stripped.ll
+// MISS: Cache: 0 hits, 2 misses
+
+// HIT-NOT: {{^}}llc
+// HIT: Reusing cached artifacts for core (1, 2)
+// HIT-NOT: {{^}}llc
+// HIT: Reusing cached artifacts for core (2, 2)
+// HIT-NOT: {{^}}llc
+// HIT: Cache: 2 hits, 0 misses
+
+// Only the core whose code changed is compiled again.
+// CHANGED-NOT: {{^}}llc
+// CHANGED: Reusing cached artifacts for core (1, 2)
+// CHANGED-NOT: Reusing cached artifacts
+// CHANGED: {{^}}llc {{.*}}core_2_2.stripped.ll
+// CHANGED: Cache: 1 hits, 1 misses
+
+// Flags that change the generated code are part of the key.
+// FLAGS-NOT: Reusing cached artifacts
+// FLAGS: Cache: 0 hits, 2 misses
+
+module {
+  %12 = AIE.tile(1, 2)
+  %22 = AIE.tile(2, 2)
+  %buf12 = AIE.buffer(%12) : memref<256xi32>
+  %buf22 = AIE.buffer(%22) : memref<256xi32>
+  AIE.core(%12) {
+    %0 = arith.constant 0 : i32
+    %1 = arith.constant 0 : index
+    memref.store %0, %buf12[%1] : memref<256xi32>
+    AIE.end
+  }
+  AIE.core(%22) {
+    %0 = arith.constant 7 : i32
+    %1 = arith.constant 0 : index
+    memref.store %0, %buf22[%1] : memref<256xi32>
+    AIE.end
+  }
+}
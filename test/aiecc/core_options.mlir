@@ -0,0 +1,35 @@
+//===- core_options.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aiecc.py --no-unified --compile --no-xchesscc --no-link --no-compile-host -nv %s | FileCheck %s
+
+// CHECK-DAG: opt --passes=default<O2>,strip -S {{.*}}core_1_2.ll
+// CHECK-DAG: llc {{.*}}core_1_2.stripped.ll -O2
+// CHECK-DAG: opt --passes=default<O3>,strip -unroll-threshold=600 -force-vector-width=1 -S {{.*}}core_2_2.ll
+// CHECK-DAG: llc {{.*}}core_2_2.stripped.ll -O3
+
+module {
+  %12 = AIE.tile(1, 2)
+  %22 = AIE.tile(2, 2)
+  %buf12 = AIE.buffer(%12) : memref<256xi32>
+  %buf22 = AIE.buffer(%22) : memref<256xi32>
+  AIE.core(%12) {
+    %0 = arith.constant 0 : i32
+    %1 = arith.constant 0 : index
+    memref.store %0, %buf12[%1] : memref<256xi32>
+    AIE.end
+  }
+  AIE.core(%22) {
+    %0 = arith.constant 0 : i32
+    %1 = arith.constant 0 : index
+    memref.store %0, %buf22[%1] : memref<256xi32>
+    AIE.end
+  } { compile_options = {opt_level = 3 : i32, unroll_threshold = 600 : i32, vector_width = 1 : i32} }
+}
@@ -0,0 +1,50 @@
+//===- dedup_cores.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t.prj
+// RUN: aiecc.py --peano=%S/Inputs/fake-peano --no-unified --compile --no-xchesscc --no-xbridge --no-link --no-compile-host -v --tmpdir=%t.prj --dedup-cores %s | FileCheck %s
+// RUN: test -f %t.prj/core_2_2.o
+
+// Cores (1, 2) and (2, 2) only differ in the names of the core and of its
+// buffer, so core (2, 2) renames the symbols of the object of core (1, 2).
+// Core (3, 2) stores another value and is compiled by itself.
+// CHECK: {{^}}llc {{.*}}core_1_2.stripped.ll
+// CHECK-NOT: {{^}}llc
+// CHECK: Core (2, 2) shares code with core (1, 2)
+// CHECK: {{^}}llvm-objcopy --redefine-sym=core_1_2=core_2_2 --redefine-sym=a=b {{.*}}core_1_2.o {{.*}}core_2_2.o
+// CHECK-NOT: shares code
+// CHECK: {{^}}llc {{.*}}core_3_2.stripped.ll
+
+module {
+  %12 = AIE.tile(1, 2)
+  %22 = AIE.tile(2, 2)
+  %32 = AIE.tile(3, 2)
+  %a = AIE.buffer(%12) { sym_name = "a" } : memref<256xi32>
+  %b = AIE.buffer(%22) { sym_name = "b" } : memref<256xi32>
+  %c = AIE.buffer(%32) { sym_name = "c" } : memref<256xi32>
+  AIE.core(%12) {
+    %0 = arith.constant 0 : i32
+    %1 = arith.constant 0 : index
+    memref.store %0, %a[%1] : memref<256xi32>
+    AIE.end
+  }
+  AIE.core(%22) {
+    %0 = arith.constant 0 : i32
+    %1 = arith.constant 0 : index
+    memref.store %0, %b[%1] : memref<256xi32>
+    AIE.end
+  }
+  AIE.core(%32) {
+    %0 = arith.constant 1 : i32
+    %1 = arith.constant 0 : index
+    memref.store %0, %c[%1] : memref<256xi32>
+    AIE.end
+  }
+}
@@ -0,0 +1,36 @@
+//===- in_process_lowering.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aiecc.py --no-unified --compile --no-xchesscc --no-xbridge --no-link --no-compile-host -nv --tmpdir=%t.default.prj %s | FileCheck %s --check-prefix=DEFAULT
+// RUN: aiecc.py --no-unified --in-process-lowering --compile --no-xchesscc --no-xbridge --no-link --no-compile-host -nv --tmpdir=%t.inprocess.prj %s | FileCheck %s --check-prefix=INPROCESS
+
+// Cores are lowered by separate aie-opt and aie-translate processes unless
+// in-process lowering is asked for.
+// DEFAULT-NOT: aie-lower-cores
+// DEFAULT: aie-opt --aie-localize-locks --aie-standard-lowering=tilecol=1 tilerow=2
+// DEFAULT: aie-translate {{.*}} --aie-generate-ldscript --tilecol=1 --tilerow=2
+// DEFAULT: aie-translate --opaque-pointers=0 --mlir-to-llvmir {{.*}}core_1_2.opt.mlir
+// DEFAULT-NOT: aie-lower-cores
+
+// INPROCESS: aie-lower-cores --opaque-pointers=0 --core-pipeline={{.*}} --emit-ldscript
+// INPROCESS-NOT: --aie-standard-lowering=tilecol
+// INPROCESS-NOT: --aie-generate-ldscript
+// INPROCESS: llc {{.*}}core_1_2.stripped.ll
+
+module {
+  %12 = AIE.tile(1, 2)
+  %buf = AIE.buffer(%12) : memref<256xi32>
+  AIE.core(%12) {
+    %0 = arith.constant 0 : i32
+    %1 = arith.constant 0 : index
+    memref.store %0, %buf[%1] : memref<256xi32>
+    AIE.end
+  }
+}
@@ -0,0 +1,36 @@
+//===- lto.mlir ------------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The kernel linked with the core is found next to its object, relative to
+// the working directory.
+// RUN: rm -rf %t.dir && mkdir -p %t.dir && cd %t.dir && touch kernel.cc && aiecc.py --peano=%S/Inputs/fake-peano --no-unified --compile --no-xchesscc --no-xbridge --no-link --no-compile-host -v --tmpdir=%t.dir/prj --lto %s | FileCheck %s
+// RUN: not aiecc.py --unified --compile --no-xchesscc --no-xbridge --no-link --no-compile-host -nv --tmpdir=%t.unified.prj --lto %s 2>&1 | FileCheck %s --check-prefix=UNIFIED
+// RUN: not aiecc.py --no-unified --compile --xchesscc --no-xbridge --no-link --no-compile-host -nv --tmpdir=%t.xchesscc.prj --lto %s 2>&1 | FileCheck %s --check-prefix=XCHESSCC
+
+// CHECK: {{^}}clang -O2 --target=aie-none-elf -D__AIEARCH__=10 -Xclang -no-opaque-pointers -emit-llvm -S kernel.cc -o {{.*}}prj/kernel.kernel.ll
+// CHECK: {{^}}llvm-link --opaque-pointers=0 {{.*}}prj/core_1_2.ll {{.*}}prj/kernel.kernel.ll -S -o {{.*}}prj/core_1_2.lto.ll
+// CHECK: {{^}}opt --passes=internalize,default<O2>,strip --internalize-public-api-list=core_1_2 -S {{.*}}prj/core_1_2.lto.ll -o {{.*}}prj/core_1_2.stripped.ll
+// CHECK: {{^}}llc {{.*}}prj/core_1_2.stripped.ll
+
+// UNIFIED: LTO (--lto) requires the non-unified flow compiling with Peano
+// UNIFIED-NOT: aie-opt
+// XCHESSCC: LTO (--lto) requires the non-unified flow compiling with Peano
+// XCHESSCC-NOT: aie-opt
+
+module {
+  %12 = AIE.tile(1, 2)
+  %buf = AIE.buffer(%12) : memref<256xi32>
+  AIE.core(%12) {
+    %0 = arith.constant 0 : i32
+    %1 = arith.constant 0 : index
+    memref.store %0, %buf[%1] : memref<256xi32>
+    AIE.end
+  } { link_with = "kernel.o" }
+}
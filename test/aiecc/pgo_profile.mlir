@@ -0,0 +1,52 @@
+//===- pgo_profile.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aiecc.py --peano=%S/Inputs/fake-peano --no-unified --compile --no-xchesscc --no-xbridge --no-link --no-compile-host -nv --tmpdir=%t.prj --pgo-profile=%S/Inputs/pgo_profile.json %s | FileCheck %s
+
+// Core (1, 2) is hot and its hot loop runs long, so it is also unrolled at
+// runtime.
+// CHECK-DAG: opt --passes=default<O3>,strip -inline-threshold=1000 -unroll-threshold=1200 -unroll-runtime -S {{.*}}core_1_2.ll
+// CHECK-DAG: llc {{.*}}core_1_2.stripped.ll -O3
+
+// Core (2, 2) barely runs.
+// CHECK-DAG: opt --passes=default<O1>,strip -S {{.*}}core_2_2.ll
+// CHECK-DAG: llc {{.*}}core_2_2.stripped.ll -O1
+
+// Core (3, 2) is hot, but keeps the optimization level of its
+// compile_options.
+// CHECK-DAG: opt --passes=default<O2>,strip -inline-threshold=1000 -unroll-threshold=1200 -S {{.*}}core_3_2.ll
+// CHECK-DAG: llc {{.*}}core_3_2.stripped.ll -O2
+
+module {
+  %12 = AIE.tile(1, 2)
+  %22 = AIE.tile(2, 2)
+  %32 = AIE.tile(3, 2)
+  %buf12 = AIE.buffer(%12) : memref<256xi32>
+  %buf22 = AIE.buffer(%22) : memref<256xi32>
+  %buf32 = AIE.buffer(%32) : memref<256xi32>
+  AIE.core(%12) {
+    %0 = arith.constant 0 : i32
+    %1 = arith.constant 0 : index
+    memref.store %0, %buf12[%1] : memref<256xi32>
+    AIE.end
+  }
+  AIE.core(%22) {
+    %0 = arith.constant 0 : i32
+    %1 = arith.constant 0 : index
+    memref.store %0, %buf22[%1] : memref<256xi32>
+    AIE.end
+  }
+  AIE.core(%32) {
+    %0 = arith.constant 0 : i32
+    %1 = arith.constant 0 : index
+    memref.store %0, %buf32[%1] : memref<256xi32>
+    AIE.end
+  } { compile_options = {opt_level = 2 : i32} }
+}
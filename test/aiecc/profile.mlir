@@ -0,0 +1,47 @@
+//===- profile.mlir --------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t.prj
+// RUN: aiecc.py --peano=%S/Inputs/fake-peano --no-unified --compile --no-xchesscc --no-xbridge --no-link --no-compile-host --profile --tmpdir=%t.prj %s | FileCheck %s
+// RUN: FileCheck --input-file=%t.prj/aiecc.trace.json %s --check-prefix=TRACE
+// RUN: %python %S/Inputs/profile_events.py %S/Inputs/mlir_timing.txt | FileCheck %s --check-prefix=TIMING
+
+// CHECK: Critical path: {{.*}} sec in {{[0-9]+}} commands
+// CHECK: Worker utilization:
+// CHECK: Trace written to {{.*}}aiecc.trace.json
+
+// TRACE: "traceEvents"
+// TRACE: "name": "aie-opt"
+// TRACE-SAME: "cat": "command"
+
+// The passes of the timing report nest inside the command that ran them, and
+// each starts when its predecessor ended.
+// TIMING: aie-opt 10.0000-10.0203
+// TIMING-NEXT:   Parser 10.0000-10.0030
+// TIMING-NEXT:   'AIE.device' Pipeline 10.0030-10.0180
+// TIMING-NEXT:     AIELocalizeLocks 10.0030-10.0130
+// TIMING-NEXT:     AIEObjectFifoStatefulTransform 10.0130-10.0180
+// TIMING-NEXT:   Output 10.0180-10.0200
+
+// The second opt waits for the first one, and llc waits for the second opt.
+// TIMING: Critical path: 3.5000 sec in 2 commands, 4.0000 sec from first to last command:
+// TIMING-NEXT: 3.0000 sec: opt
+// TIMING-NEXT: 0.5000 sec: llc
+
+module {
+  %12 = AIE.tile(1, 2)
+  %a = AIE.buffer(%12) { sym_name = "a" } : memref<256xi32>
+  AIE.core(%12) {
+    %0 = arith.constant 0 : i32
+    %1 = arith.constant 0 : index
+    memref.store %0, %a[%1] : memref<256xi32>
+    AIE.end
+  }
+}
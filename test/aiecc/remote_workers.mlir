@@ -0,0 +1,39 @@
+//===- remote_workers.mlir -------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t.cache %t.prj %t.fallback.cache %t.fallback.prj
+// RUN: %python %S/Inputs/with_worker.py %t.sock %t.cache %S/Inputs/fake-peano aiecc.py --peano=%S/Inputs/fake-peano --no-unified --compile --no-xchesscc --no-xbridge --no-link --no-compile-host -v --tmpdir=%t.prj --cache-dir=%t.cache --remote-workers=unix:%t.sock %s 2>&1 | FileCheck %s --check-prefix=REMOTE
+// RUN: test -f %t.prj/core_1_2.o
+// RUN: aiecc.py --peano=%S/Inputs/fake-peano --no-unified --compile --no-xchesscc --no-xbridge --no-link --no-compile-host -v --tmpdir=%t.fallback.prj --cache-dir=%t.fallback.cache --remote-workers=unix:%t.nosuchworker %s 2>&1 | FileCheck %s --check-prefix=FALLBACK
+// RUN: test -f %t.fallback.prj/core_1_2.o
+
+// The Peano stand-ins report their command on stderr.  opt and llc run on the
+// worker, on copies of their files in a scratch directory, and the object is
+// copied back.
+// REMOTE-DAG: {{^}}opt --passes=default<O2>,strip -S {{.*}}aiecc-worker-{{[^ ]*}}/0-core_1_2.ll -o {{.*}}aiecc-worker-{{[^ ]*}}/1-core_1_2.stripped.ll
+// REMOTE-DAG: {{^}}llc {{.*}}aiecc-worker-{{[^ ]*}}/0-core_1_2.stripped.ll {{.*}} -o {{.*}}aiecc-worker-{{[^ ]*}}/1-core_1_2.o
+// REMOTE-NOT: failed
+
+// Without a worker, the commands run locally.
+// FALLBACK: Worker unix:{{.*}}nosuchworker failed ({{.*}}), running locally: opt
+// FALLBACK: {{^}}opt --passes=default<O2>,strip -S {{.*}}.prj/core_1_2.ll -o {{.*}}.prj/core_1_2.stripped.ll
+// FALLBACK: Worker unix:{{.*}}nosuchworker failed ({{.*}}), running locally: llc
+// FALLBACK: {{^}}llc {{.*}}.prj/core_1_2.stripped.ll
+
+module {
+  %12 = AIE.tile(1, 2)
+  %buf = AIE.buffer(%12) : memref<256xi32>
+  AIE.core(%12) {
+    %0 = arith.constant 0 : i32
+    %1 = arith.constant 0 : index
+    memref.store %0, %buf[%1] : memref<256xi32>
+    AIE.end
+  }
+}
@@ -0,0 +1,34 @@
+//===- worker_requests.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// A worker only runs the code generation tools, on files in its scratch
+// directory, whatever its clients ask for.
+// RUN: rm -rf %t.cache %t.created
+// RUN: %python %S/Inputs/with_worker.py %t.sock %t.cache %S/Inputs/fake-peano %python %S/Inputs/send_request.py %t.sock touch %t.created | FileCheck %s --check-prefix=TOOL
+// RUN: not test -e %t.created
+// RUN: %python %S/Inputs/with_worker.py %t.sock %t.cache %S/Inputs/fake-peano %python %S/Inputs/send_request.py %t.sock /bin/touch %t.created | FileCheck %s --check-prefix=TOOLPATH
+// RUN: %python %S/Inputs/with_worker.py %t.sock %t.cache %S/Inputs/fake-peano %python %S/Inputs/send_request.py %t.sock llc %s -o %t.created | FileCheck %s --check-prefix=PATH
+// RUN: %python %S/Inputs/with_worker.py %t.sock %t.cache %S/Inputs/fake-peano %python %S/Inputs/send_request.py %t.sock llc ../input.ll | FileCheck %s --check-prefix=PARENT
+// RUN: %python %S/Inputs/with_worker.py %t.sock %t.cache %S/Inputs/fake-peano %python %S/Inputs/send_request.py %t.sock opt --load-pass-plugin=plugin.so | FileCheck %s --check-prefix=PLUGIN
+// RUN: not test -e %t.created
+
+// TOOL: returncode: 1
+// TOOL-NEXT: refusing to run touch: not one of opt, llc, llvm-objcopy
+// TOOLPATH: returncode: 1
+// TOOLPATH-NEXT: refusing to run /bin/touch
+// PATH: returncode: 1
+// PATH-NEXT: refusing to access files outside of the scratch directory: {{.*}}worker_requests.mlir
+// PARENT: returncode: 1
+// PARENT-NEXT: refusing to access files outside of the scratch directory: ../input.ll
+// PLUGIN: returncode: 1
+// PLUGIN-NEXT: refusing to load plugins: --load-pass-plugin=plugin.so
+
+module {
+}
@@ -0,0 +1,22 @@
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=16" --aie-vectorize -unaligned-loads-check=false | FileCheck %s
+
+// Consecutive lanes read every other element of A. The two taps are fused
+// into the columns of a single mul, and the stride is expressed by the
+// xoffsets and xsquare of the op.
+// CHECK-LABEL: func.func @conv1d_stride2
+// CHECK: %[[X:.*]] = aievec.upd %arg0[{{.*}}] {index = 0 : i8, offset = 0 : si32} : memref<2048xi16>, vector<32xi16>
+// CHECK-NOT: aievec.upd %arg0
+// CHECK: aievec.mul %[[X]], %{{.*}} {xoffsets = "0x06040200", xoffsets_hi = "0x0E0C0A08", xsquare = "0x3210", xstart = "0", {{.*}}} : vector<32xi16>, vector<16xi16>, vector<16xi48>
+func.func @conv1d_stride2(%A: memref<2048xi16>, %B: memref<2xi16>, %C: memref<2048xi16>) {
+    affine.for %i = 0 to 2046 step 2 {
+        %a0 = affine.load %A[%i] : memref<2048xi16>
+        %b0 = affine.load %B[0] : memref<2xi16>
+        %p0 = arith.muli %a0, %b0 : i16
+        %a1 = affine.load %A[%i+1] : memref<2048xi16>
+        %b1 = affine.load %B[1] : memref<2xi16>
+        %p1 = arith.muli %a1, %b1 : i16
+        %c = arith.addi %p0, %p1 : i16
+        affine.store %c, %C[%i] : memref<2048xi16>
+    }
+    return
+}
@@ -0,0 +1,22 @@
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=8" --aie-vectorize -unaligned-loads-check=false | FileCheck %s
+
+// Consecutive lanes read every other element of A, which is expressed by the
+// xoffsets of the mul/mac ops. Both reads of A are served by the same UPD.
+// CHECK-LABEL: func.func @conv1d_stride2
+// CHECK: %[[X:.*]] = aievec.upd %arg0[{{.*}}] {index = 0 : i8, offset = 0 : si32} : memref<2048xi32>, vector<16xi32>
+// CHECK-NOT: aievec.upd %arg0
+// CHECK: %[[M:.*]] = aievec.mul %[[X]], %{{.*}} {xoffsets = "0xECA86420", xstart = "0", zoffsets = "0x00000000", zstart = "0"} : vector<16xi32>, vector<8xi32>, vector<8xi80>
+// CHECK: aievec.mac %[[X]], %{{.*}}, %[[M]] {xoffsets = "0xECA86420", xstart = "1", zoffsets = "0x00000000", zstart = "1"} : vector<16xi32>, vector<8xi32>, vector<8xi80>
+func.func @conv1d_stride2(%A: memref<2048xi32>, %B: memref<2xi32>, %C: memref<2048xi32>) {
+    affine.for %i = 0 to 2046 step 2 {
+        %a0 = affine.load %A[%i] : memref<2048xi32>
+        %b0 = affine.load %B[0] : memref<2xi32>
+        %p0 = arith.muli %a0, %b0 : i32
+        %a1 = affine.load %A[%i+1] : memref<2048xi32>
+        %b1 = affine.load %B[1] : memref<2xi32>
+        %p1 = arith.muli %a1, %b1 : i32
+        %c = arith.addi %p0, %p1 : i32
+        affine.store %c, %C[%i] : memref<2048xi32>
+    }
+    return
+}
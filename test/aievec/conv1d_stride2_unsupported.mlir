@@ -0,0 +1,36 @@
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=16" --aie-vectorize -unaligned-loads-check=false -split-input-file 2>&1 | FileCheck %s
+
+// The lane offsets of the 8-bit scheme can't express a stride.
+// CHECK: Loop step of inner index of vector.transfer_read reads elements 2 apart, which arith.muli can't permute into its lanes.
+// CHECK: Cannot apply aie-vectorize to func.func because of unsupported loop steps.
+// CHECK-NOT: aievec.mul
+func.func @conv1d_stride2_i8(%A: memref<2048xi8>, %B: memref<2xi8>, %C: memref<2048xi8>) {
+    affine.for %i = 0 to 2046 step 2 {
+        %a0 = affine.load %A[%i] : memref<2048xi8>
+        %b0 = affine.load %B[0] : memref<2xi8>
+        %p0 = arith.muli %a0, %b0 : i8
+        %a1 = affine.load %A[%i+1] : memref<2048xi8>
+        %b1 = affine.load %B[1] : memref<2xi8>
+        %p1 = arith.muli %a1, %b1 : i8
+        %c = arith.addi %p0, %p1 : i8
+        affine.store %c, %C[%i] : memref<2048xi8>
+    }
+    return
+}
+
+// -----
+
+// Neither can the zbuff of the 16-bit scheme, so a stride is only supported
+// when the other operand is a splat.
+// CHECK: Loop step of inner index of vector.transfer_read reads elements 2 apart, which arith.muli can't permute into its lanes.
+// CHECK: Cannot apply aie-vectorize to func.func because of unsupported loop steps.
+// CHECK-NOT: aievec.mul
+func.func @mul_stride2_i16(%A: memref<2048xi16>, %B: memref<2048xi16>, %C: memref<2048xi16>) {
+    affine.for %i = 0 to 2046 step 2 {
+        %a = affine.load %A[%i] : memref<2048xi16>
+        %b = affine.load %B[%i] : memref<2048xi16>
+        %c = arith.muli %a, %b : i16
+        affine.store %c, %C[%i] : memref<2048xi16>
+    }
+    return
+}
@@ -0,0 +1,69 @@
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=16" --aie-vectorize="shift=10 zero-offset=4 unroll-jam=true" -aieml=true -canonicalize | FileCheck %s
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=16" --aie-vectorize="shift=10 zero-offset=4 unroll-jam=true" -canonicalize | FileCheck %s --check-prefix=CHECK-V1
+
+// On AIE-ML, the rows of eight outputs, and the ten input rows they read, fit
+// in the register files, so the row loop is unrolled and jammed by 8. On AIE,
+// even two outputs would spill the vector registers.
+
+// CHECK-LABEL: func.func @conv2d
+// CHECK: scf.for
+// CHECK: scf.for
+// CHECK-COUNT-8: vector.transfer_write
+// CHECK-NOT: vector.transfer_write
+// CHECK-V1-LABEL: func.func @conv2d
+// CHECK-V1: scf.for
+// CHECK-V1: scf.for
+// CHECK-V1-COUNT-1: vector.transfer_write
+// CHECK-V1-NOT: vector.transfer_write
+func.func @conv2d (%A: memref<18x288xi16>, %B: memref<12xi16>, %C: memref<16x256xi16>) {
+    affine.for %arg3 = 0 to 16 {
+        affine.for %arg4 = 0 to 256 {
+            %a11 = affine.load %A[%arg3, %arg4+0] : memref<18x288xi16>
+            %b11 = affine.load %B[0] : memref<12xi16>
+            %p11 = arith.muli %a11, %b11 : i16
+
+            %a12 = affine.load %A[%arg3, %arg4+1] : memref<18x288xi16>
+            %b12 = affine.load %B[1] : memref<12xi16>
+            %p12 = arith.muli %a12, %b12 : i16
+            %c12 = arith.addi %p11, %p12 : i16
+
+            %a13 = affine.load %A[%arg3, %arg4+2] : memref<18x288xi16>
+            %b13 = affine.load %B[2] : memref<12xi16>
+            %p13 = arith.muli %a13, %b13 : i16
+            %c13 = arith.addi %c12, %p13 : i16
+
+            %a21 = affine.load %A[%arg3+1, %arg4+0] : memref<18x288xi16>
+            %b21 = affine.load %B[4] : memref<12xi16>
+            %p21 = arith.muli %a21, %b21 : i16
+            %c21 = arith.addi %c13, %p21 : i16
+
+            %a22 = affine.load %A[%arg3+1, %arg4+1] : memref<18x288xi16>
+            %b22 = affine.load %B[5] : memref<12xi16>
+            %p22 = arith.muli %a22, %b22 : i16
+            %c22 = arith.addi %c21, %p22 : i16
+
+            %a23 = affine.load %A[%arg3+1, %arg4+2] : memref<18x288xi16>
+            %b23 = affine.load %B[6] : memref<12xi16>
+            %p23 = arith.muli %a23, %b23 : i16
+            %c23 = arith.addi %c22, %p23 : i16
+
+            %a31 = affine.load %A[%arg3+2, %arg4+0] : memref<18x288xi16>
+            %b31 = affine.load %B[8] : memref<12xi16>
+            %p31 = arith.muli %a31, %b31 : i16
+            %c31 = arith.addi %c23, %p31 : i16
+
+            %a32 = affine.load %A[%arg3+2, %arg4+1] : memref<18x288xi16>
+            %b32 = affine.load %B[9] : memref<12xi16>
+            %p32 = arith.muli %a32, %b32 : i16
+            %c32 = arith.addi %c31, %p32 : i16
+
+            %a33 = affine.load %A[%arg3+2, %arg4+2] : memref<18x288xi16>
+            %b33 = affine.load %B[10] : memref<12xi16>
+            %p33 = arith.muli %a33, %b33 : i16
+            %c33 = arith.addi %c32, %p33 : i16
+
+            affine.store %c33, %C[%arg3, %arg4] : memref<16x256xi16>
+        }
+    }
+    return
+}
@@ -0,0 +1,49 @@
+//===- badcore_options.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt %s -split-input-file -verify-diagnostics
+
+AIE.device(xcvc1902) {
+  %t = AIE.tile(1, 1)
+  // expected-error@+1 {{'AIE.core' op unknown compile option 'unroll'}}
+  AIE.core(%t) {
+    AIE.end
+  } { compile_options = {unroll = 4 : i32} }
+}
+
+// -----
+
+AIE.device(xcvc1902) {
+  %t = AIE.tile(1, 1)
+  // expected-error@+1 {{'AIE.core' op compile option 'opt_level' must be between 0 and 3}}
+  AIE.core(%t) {
+    AIE.end
+  } { compile_options = {opt_level = 4 : i32} }
+}
+
+// -----
+
+AIE.device(xcvc1902) {
+  %t = AIE.tile(1, 1)
+  // expected-error@+1 {{'AIE.core' op compile option 'vector_width' must be an integer}}
+  AIE.core(%t) {
+    AIE.end
+  } { compile_options = {vector_width = "wide"} }
+}
+
+// -----
+
+AIE.device(xcvc1902) {
+  %t = AIE.tile(1, 1)
+  // expected-error@+1 {{'AIE.core' op compile_options must be a dictionary}}
+  AIE.core(%t) {
+    AIE.end
+  } { compile_options = 3 : i32 }
+}
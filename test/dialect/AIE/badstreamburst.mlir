@@ -0,0 +1,39 @@
+//===- badstreamburst.mlir -------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt %s -split-input-file -verify-diagnostics
+
+AIE.device(xcvc1902) {
+  %t = AIE.tile(1, 1)
+  %buf = AIE.buffer(%t) : memref<64xi32>
+  AIE.core(%t) {
+    %c0 = arith.constant 0 : i32
+    %i4 = arith.constant 4 : index
+    // expected-error@+1 {{'AIE.putStreamBurst' op transfers elements [4, 68) of a memref of 64}}
+    AIE.putStreamBurst(%buf[%i4], %c0 : i32) {length = 64 : i32} : memref<64xi32>
+    AIE.end
+  }
+}
+
+// -----
+
+AIE.device(xcvc1902) {
+  %t = AIE.tile(1, 1)
+  %buf = AIE.buffer(%t) : memref<64xi32>
+  AIE.core(%t) {
+    %c0 = arith.constant 0 : i32
+    %i0 = arith.constant 0 : index
+    %i = arith.addi %i0, %i0 : index
+    // expected-error@+1 {{'AIE.getStreamBurst' op expected a constant offset}}
+    AIE.getStreamBurst(%buf[%i], %c0 : i32) {length = 16 : i32} : memref<64xi32>
+    AIE.end
+  }
+}
+
@@ -138,6 +138,7 @@ if(config.enable_chess_tests):
 
 tool_dirs = [config.aie_tools_dir, config.peano_tools_dir, config.llvm_tools_dir]
 tools = [
+    'aie-lower-cores',
     'aie-opt',
     'aie-translate',
     'aiecc.py',
@@ -0,0 +1,77 @@
+//===- lower_stream_burst.mlir ---------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-standard-lowering="tilecol=1 tilerow=3" %s | FileCheck --check-prefix=CHECK13 %s
+// RUN: aie-opt --aie-standard-lowering="tilecol=2 tilerow=3" %s | FileCheck --check-prefix=CHECK23 %s
+
+//CHECK13:  func.func @core_1_3() {
+//CHECK13:    %[[BUF:.*]] = memref.get_global @in : memref<64xi32>
+//CHECK13:    memref.load %[[BUF]][%{{.*}}] : memref<64xi32>
+//CHECK13:    call @llvm.aie.put.ms(%[[CH:[^,)]*]], %{{.*}}) : (i32, i32) -> ()
+//CHECK13-COUNT-2: call @llvm.aie.put.ms(%[[CH]], %{{.*}}) : (i32, i32) -> ()
+//CHECK13-NOT: call @llvm.aie.put
+//CHECK13:    %[[LB:.*]] = arith.constant 4 : index
+//CHECK13:    %[[UB:.*]] = arith.constant 52 : index
+//CHECK13:    %[[STEP:.*]] = arith.constant 16 : index
+//CHECK13:    scf.for %{{.*}} = %[[LB]] to %[[UB]] step %[[STEP]] {
+//CHECK13-COUNT-4: call @llvm.aie.put.wms(%[[CH]], %{{.*}}) : (i32, i128) -> ()
+//CHECK13:    }
+//CHECK13:    %[[I52:.*]] = arith.constant 52 : index
+//CHECK13:    %[[V:.*]] = vector.transfer_read %[[BUF]][%[[I52]]], %{{.*}} : memref<64xi32>, vector<4xi32>
+//CHECK13:    %[[W:.*]] = vector.bitcast %[[V]] : vector<4xi32> to vector<1xi128>
+//CHECK13:    vector.extract %[[W]][0] : vector<1xi128>
+//CHECK13:    call @llvm.aie.put.wms(%[[CH]], %{{.*}}) : (i32, i128) -> ()
+//CHECK13:    call @llvm.aie.put.wms(%[[CH]], %{{.*}}) : (i32, i128) -> ()
+//CHECK13:    %[[I60:.*]] = arith.constant 60 : index
+//CHECK13:    memref.load %[[BUF]][%[[I60]]] : memref<64xi32>
+//CHECK13-COUNT-3: call @llvm.aie.put.ms(%[[CH]], %{{.*}}) : (i32, i32) -> ()
+//CHECK13-NOT: call @llvm.aie.put
+//CHECK13:    return
+//CHECK13:  }
+
+//CHECK23:  func.func @core_2_3() {
+//CHECK23:    %[[BUF:.*]] = memref.get_global @out : memref<10xf32>
+//CHECK23-NOT: scf.for
+//CHECK23:    %[[W:.*]] = call @llvm.aie.get.wss(%[[CH:[^,)]*]]) : (i32) -> i128
+//CHECK23:    %[[B:.*]] = vector.broadcast %[[W]] : i128 to vector<1xi128>
+//CHECK23:    %[[V:.*]] = vector.bitcast %[[B]] : vector<1xi128> to vector<4xf32>
+//CHECK23:    vector.transfer_write %[[V]], %[[BUF]][%{{.*}}] : vector<4xf32>, memref<10xf32>
+//CHECK23:    call @llvm.aie.get.wss(%[[CH]]) : (i32) -> i128
+//CHECK23-COUNT-2: call @llvm.aie.get.fss(%[[CH]]) : (i32) -> f32
+//CHECK23:    return
+//CHECK23:  }
+
+// Test lowering of stream bursts to wide and scalar stream intrinsics
+module @test_stream_burst {
+ AIE.device(xcvc1902) {
+  %tile13 = AIE.tile(1, 3)
+  %tile23 = AIE.tile(2, 3)
+  %in = AIE.buffer(%tile13) { sym_name = "in" } : memref<64xi32>
+  %out = AIE.buffer(%tile23) { sym_name = "out" } : memref<10xf32>
+
+  // 3 scalar elements up to the first aligned wide word, 14 wide words: 12 in
+  // a loop unrolled 4 times and 2 unrolled after it, and a tail of 3 scalar
+  // elements.
+  %core13 = AIE.core(%tile13) {
+    %c0 = arith.constant 0 : i32
+    %i1 = arith.constant 1 : index
+    AIE.putStreamBurst(%in[%i1], %c0 : i32) {length = 62 : i32} : memref<64xi32>
+    AIE.end
+  }
+
+  // 2 wide words and a tail of 2 scalar elements.
+  %core23 = AIE.core(%tile23) {
+    %c1 = arith.constant 1 : i32
+    %i0 = arith.constant 0 : index
+    AIE.getStreamBurst(%out[%i0], %c1 : i32) {length = 10 : i32} : memref<10xf32>
+    AIE.end
+  }
+ }
+}
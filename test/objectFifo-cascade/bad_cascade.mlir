@@ -0,0 +1,34 @@
+//===- bad_cascade.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-cascade="fifos=back" --verify-diagnostics %s
+
+// Cascades run right-to-left on row 2.
+module @bad_cascade {
+ AIE.device(xcvc1902) {
+  %tile12 = AIE.tile(1, 2)
+  %tile22 = AIE.tile(2, 2)
+
+  // expected-error@+1 {{consumer doesn't follow the producer in the cascade chain}}
+  %back = AIE.objectFifo.createObjectFifo(%tile12, {%tile22}, 2) {sym_name = "back"} : !AIE.objectFifo<memref<12xi32>>
+
+  %core12 = AIE.core(%tile12) {
+    %0 = AIE.objectFifo.acquire<Produce> (%back : !AIE.objectFifo<memref<12xi32>>, 1) : !AIE.objectFifoSubview<memref<12xi32>>
+    AIE.objectFifo.release<Produce> (%back : !AIE.objectFifo<memref<12xi32>>, 1)
+    AIE.end
+  }
+
+  %core22 = AIE.core(%tile22) {
+    %0 = AIE.objectFifo.acquire<Consume> (%back : !AIE.objectFifo<memref<12xi32>>, 1) : !AIE.objectFifoSubview<memref<12xi32>>
+    AIE.objectFifo.release<Consume> (%back : !AIE.objectFifo<memref<12xi32>>, 1)
+    AIE.end
+  }
+ }
+}
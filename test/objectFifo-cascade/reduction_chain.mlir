@@ -0,0 +1,106 @@
+//===- reduction_chain.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-cascade %s | FileCheck %s
+
+// A reduction split across three cores of row 3, where cascades run
+// left-to-right. The partial sums move onto the cascade, while @back goes
+// against the cascade direction and is left alone.
+
+// CHECK-LABEL: module @reduction_chain
+// CHECK:   %[[T13:.*]] = AIE.tile(1, 3)
+// CHECK:   %[[T23:.*]] = AIE.tile(2, 3)
+// CHECK:   %[[T33:.*]] = AIE.tile(3, 3)
+// CHECK:   %[[P0:.*]] = AIE.buffer(%[[T13]]) {sym_name = "p0_cascade"} : memref<12xi32>
+// CHECK:   %[[P0C:.*]] = AIE.buffer(%[[T23]]) {sym_name = "p0_cascade_cons"} : memref<12xi32>
+// CHECK:   %[[P1:.*]] = AIE.buffer(%[[T23]]) {sym_name = "p1_cascade"} : memref<24xi32>
+// CHECK:   %[[P1C:.*]] = AIE.buffer(%[[T33]]) {sym_name = "p1_cascade_cons"} : memref<24xi32>
+// CHECK:   AIE.objectFifo.createObjectFifo(%[[T23]], {%[[T13]]}, 2) {sym_name = "back"}
+// CHECK-NOT: AIE.objectFifo.createObjectFifo
+
+// The producer pushes its partial sum when releasing it.
+// CHECK:   AIE.core(%[[T13]])
+// CHECK:     func.call @partial(%[[P0]])
+// CHECK:     %[[R0:.*]] = vector.transfer_read %[[P0]][%{{.*}}], %{{.*}} : memref<12xi32>, vector<12xi32>
+// CHECK:     %[[B0:.*]] = vector.bitcast %[[R0]] : vector<12xi32> to vector<1xi384>
+// CHECK:     %[[W0:.*]] = vector.extract %[[B0]][0] : vector<1xi384>
+// CHECK:     AIE.putCascade(%[[W0]] : i384)
+// CHECK:     AIE.objectFifo.acquire<Consume> (%{{.*}} : !AIE.objectFifo<memref<8xi32>>, 1)
+
+// The middle core pulls the partial sum of its predecessor when acquiring it,
+// and pushes its own in two cascade words.
+// CHECK:   AIE.core(%[[T23]])
+// CHECK:     %[[G1:.*]] = AIE.getCascade() : i384
+// CHECK:     %[[V1:.*]] = vector.broadcast %[[G1]] : i384 to vector<1xi384>
+// CHECK:     %[[D1:.*]] = vector.bitcast %[[V1]] : vector<1xi384> to vector<12xi32>
+// CHECK:     vector.transfer_write %[[D1]], %[[P0C]][%{{.*}}] : vector<12xi32>, memref<12xi32>
+// CHECK:     func.call @accumulate(%[[P0C]], %[[P1]])
+// CHECK:     scf.for %[[I:.*]] = %{{.*}} to %{{.*}} step %{{.*}} {
+// CHECK:       vector.transfer_read %[[P1]][%[[I]]]
+// CHECK:       AIE.putCascade
+// CHECK:     }
+// CHECK:     AIE.objectFifo.acquire<Produce> (%{{.*}} : !AIE.objectFifo<memref<8xi32>>, 1)
+
+// CHECK:   AIE.core(%[[T33]])
+// CHECK:     scf.for %[[J:.*]] = %{{.*}} to %{{.*}} step %{{.*}} {
+// CHECK:       AIE.getCascade() : i384
+// CHECK:       vector.transfer_write %{{.*}}, %[[P1C]][%[[J]]] : vector<12xi32>, memref<24xi32>
+// CHECK:     }
+// CHECK:     func.call @finish(%[[P1C]])
+// CHECK-NOT: AIE.objectFifo
+module @reduction_chain {
+ AIE.device(xcvc1902) {
+  %tile13 = AIE.tile(1, 3)
+  %tile23 = AIE.tile(2, 3)
+  %tile33 = AIE.tile(3, 3)
+
+  %p0 = AIE.objectFifo.createObjectFifo(%tile13, {%tile23}, 2) {sym_name = "p0"} : !AIE.objectFifo<memref<12xi32>>
+  %p1 = AIE.objectFifo.createObjectFifo(%tile23, {%tile33}, 2) {sym_name = "p1"} : !AIE.objectFifo<memref<24xi32>>
+  %back = AIE.objectFifo.createObjectFifo(%tile23, {%tile13}, 2) {sym_name = "back"} : !AIE.objectFifo<memref<8xi32>>
+
+  func.func private @partial(%out : memref<12xi32>) -> ()
+  func.func private @accumulate(%in : memref<12xi32>, %out : memref<24xi32>) -> ()
+  func.func private @finish(%in : memref<24xi32>) -> ()
+  func.func private @feedback(%out : memref<8xi32>) -> ()
+
+  %core13 = AIE.core(%tile13) {
+    %0 = AIE.objectFifo.acquire<Produce> (%p0 : !AIE.objectFifo<memref<12xi32>>, 1) : !AIE.objectFifoSubview<memref<12xi32>>
+    %1 = AIE.objectFifo.subview.access %0[0] : !AIE.objectFifoSubview<memref<12xi32>> -> memref<12xi32>
+    func.call @partial(%1) : (memref<12xi32>) -> ()
+    AIE.objectFifo.release<Produce> (%p0 : !AIE.objectFifo<memref<12xi32>>, 1)
+    %2 = AIE.objectFifo.acquire<Consume> (%back : !AIE.objectFifo<memref<8xi32>>, 1) : !AIE.objectFifoSubview<memref<8xi32>>
+    AIE.objectFifo.release<Consume> (%back : !AIE.objectFifo<memref<8xi32>>, 1)
+    AIE.end
+  }
+
+  %core23 = AIE.core(%tile23) {
+    %0 = AIE.objectFifo.acquire<Consume> (%p0 : !AIE.objectFifo<memref<12xi32>>, 1) : !AIE.objectFifoSubview<memref<12xi32>>
+    %1 = AIE.objectFifo.subview.access %0[0] : !AIE.objectFifoSubview<memref<12xi32>> -> memref<12xi32>
+    %2 = AIE.objectFifo.acquire<Produce> (%p1 : !AIE.objectFifo<memref<24xi32>>, 1) : !AIE.objectFifoSubview<memref<24xi32>>
+    %3 = AIE.objectFifo.subview.access %2[0] : !AIE.objectFifoSubview<memref<24xi32>> -> memref<24xi32>
+    func.call @accumulate(%1, %3) : (memref<12xi32>, memref<24xi32>) -> ()
+    AIE.objectFifo.release<Consume> (%p0 : !AIE.objectFifo<memref<12xi32>>, 1)
+    AIE.objectFifo.release<Produce> (%p1 : !AIE.objectFifo<memref<24xi32>>, 1)
+    %4 = AIE.objectFifo.acquire<Produce> (%back : !AIE.objectFifo<memref<8xi32>>, 1) : !AIE.objectFifoSubview<memref<8xi32>>
+    %5 = AIE.objectFifo.subview.access %4[0] : !AIE.objectFifoSubview<memref<8xi32>> -> memref<8xi32>
+    func.call @feedback(%5) : (memref<8xi32>) -> ()
+    AIE.objectFifo.release<Produce> (%back : !AIE.objectFifo<memref<8xi32>>, 1)
+    AIE.end
+  }
+
+  %core33 = AIE.core(%tile33) {
+    %0 = AIE.objectFifo.acquire<Consume> (%p1 : !AIE.objectFifo<memref<24xi32>>, 1) : !AIE.objectFifoSubview<memref<24xi32>>
+    %1 = AIE.objectFifo.subview.access %0[0] : !AIE.objectFifoSubview<memref<24xi32>> -> memref<24xi32>
+    func.call @finish(%1) : (memref<24xi32>) -> ()
+    AIE.objectFifo.release<Consume> (%p1 : !AIE.objectFifo<memref<24xi32>>, 1)
+    AIE.end
+  }
+ }
+}
@@ -0,0 +1,85 @@
+//===- place_tiles.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-place-tiles -split-input-file -verify-diagnostics %s | FileCheck %s
+
+// The consumer of an objectFifo moves next to its producer, so that they
+// communicate through shared memory. Of the tiles sharing memory with the
+// producer, the one closest to the input coordinates is chosen. Shim tiles
+// don't move.
+// CHECK-LABEL: module @objectFifo
+// CHECK: %[[SHIM:.*]] = AIE.tile(2, 0)
+// CHECK: %[[PROD:.*]] = AIE.tile(2, 1)
+// CHECK: %[[CONS:.*]] = AIE.tile(3, 1)
+// CHECK: AIE.objectFifo.createObjectFifo(%[[SHIM]], {%[[PROD]]}, 2)
+// CHECK: AIE.objectFifo.createObjectFifo(%[[PROD]], {%[[CONS]]}, 2)
+module @objectFifo {
+  AIE.device(xcvc1902) {
+    %tile20 = AIE.tile(2, 0)
+    %tile21 = AIE.tile(2, 1)
+    %tile71 = AIE.tile(7, 1)
+    %of0 = AIE.objectFifo.createObjectFifo(%tile20, {%tile21}, 2) {sym_name = "of0"} : !AIE.objectFifo<memref<16xi32>>
+    %of1 = AIE.objectFifo.createObjectFifo(%tile21, {%tile71}, 2) {sym_name = "of1"} : !AIE.objectFifo<memref<16xi32>>
+  }
+}
+
+// -----
+
+// Stream endpoints move as close to each other as possible.
+// CHECK-LABEL: module @flow
+// CHECK: %[[SHIM:.*]] = AIE.tile(6, 0)
+// CHECK: %[[CORE:.*]] = AIE.tile(6, 1)
+// CHECK: AIE.flow(%[[SHIM]], DMA : 0, %[[CORE]], DMA : 0)
+module @flow {
+  AIE.device(xcvc1902) {
+    %tile60 = AIE.tile(6, 0)
+    %tile08 = AIE.tile(0, 8)
+    AIE.flow(%tile60, DMA : 0, %tile08, DMA : 0)
+  }
+}
+
+// -----
+
+// Routed designs can't be placed anymore.
+module @routed {
+  AIE.device(xcvc1902) {
+    %tile22 = AIE.tile(2, 2)
+    // expected-error@+1 {{'AIE.switchbox' op must be created after tile placement}}
+    %sb = AIE.switchbox(%tile22) {
+      AIE.connect<Core : 0, South : 1>
+    }
+  }
+}
+
+// -----
+
+// Cores connected by the cascade stay cascade neighbours. The consumer would
+// otherwise move next to the shim tile it receives data from.
+// CHECK-LABEL: module @cascade
+// CHECK: AIE.tile(3, 0)
+// CHECK: AIE.tile(3, 3)
+// CHECK: AIE.tile(4, 3)
+module @cascade {
+  AIE.device(xcvc1902) {
+    %tile30 = AIE.tile(3, 0)
+    %tile33 = AIE.tile(3, 3)
+    %tile43 = AIE.tile(4, 3)
+    AIE.flow(%tile30, DMA : 0, %tile43, DMA : 0)
+    %core33 = AIE.core(%tile33) {
+      %0 = arith.constant 0 : i384
+      AIE.putCascade(%0 : i384)
+      AIE.end
+    }
+    %core43 = AIE.core(%tile43) {
+      %0 = AIE.getCascade() : i384
+      AIE.end
+    }
+  }
+}
@@ -0,0 +1,39 @@
+//===- tiling_search.mlir --------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-tiling-search %s | FileCheck %s
+// RUN: aie-opt --aie-tiling-search="report=2" -verify-diagnostics %s -o /dev/null
+
+// The reduction loop of a matmul stays on one core, the parallel loops are
+// spread over the columns and rows of the array.
+// CHECK-LABEL: func.func @matmul
+// CHECK: linalg.matmul {aie.tiling = {cores = [32, 8, 1], cycles = 276 : i64, tile_sizes = [2, 8, 8]}}
+func.func @matmul(%A: memref<64x64xi16>, %B: memref<64x64xi16>, %C: memref<64x64xi16>) {
+  // expected-remark@+2 {{tiling #0: tile sizes [2, 8, 8], cores [32, 8, 1], 276 cycles, 384 bytes of local memory}}
+  // expected-remark@+1 {{tiling #1: tile sizes [2, 4, 16], cores [32, 8, 1], 276 cycles, 416 bytes of local memory}}
+  linalg.matmul ins(%A, %B : memref<64x64xi16>, memref<64x64xi16>) outs(%C : memref<64x64xi16>)
+  return
+}
+
+// Small tiles on many cores win as long as the DMAs keep up with the vector
+// unit.
+// CHECK-LABEL: func.func @vecadd
+// CHECK: } {aie.tiling = {cores = [32], cycles = 25 : i64, tile_sizes = [8]}}
+func.func @vecadd(%a: memref<256xi32>, %b: memref<256xi32>, %c: memref<256xi32>) {
+  // expected-remark@+2 {{tiling #0: tile sizes [8], cores [32], 25 cycles, 192 bytes of local memory}}
+  // expected-remark@+1 {{tiling #1: tile sizes [16], cores [16], 34 cycles, 384 bytes of local memory}}
+  affine.for %i = 0 to 256 {
+    %0 = affine.load %a[%i] : memref<256xi32>
+    %1 = affine.load %b[%i] : memref<256xi32>
+    %2 = arith.addi %0, %1 : i32
+    affine.store %2, %c[%i] : memref<256xi32>
+  }
+  return
+}
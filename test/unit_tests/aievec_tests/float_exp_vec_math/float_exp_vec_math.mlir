@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Copyright (C) 2023, Advanced Micro Devices, Inc.
+
+// The call to the vector math runtime library must link against its
+// definition.
+// REQUIRES: valid_xchess_license
+// RUN: aie-opt %s --convert-vector-to-aievec="aie-target=aieml" -lower-affine | aie-translate -aieml=true --aievec-to-cpp -o dut.cc
+// RUN: xchesscc_wrapper aie2 -f -g +s +w work +o work -I%S -I. -I%S/../../../../aie_runtime_lib %S/testbench.cc dut.cc %S/../../../../aie_runtime_lib/AIE2/vec_math.cpp
+// RUN: mkdir -p data
+// RUN: xme_ca_udm_dbg -qf -T -P %aietools/data/aie_ml/lib/ -t "%S/../profiling.tcl ./work/a.out" >& xme_ca_udm_dbg.stdout
+// RUN: FileCheck --input-file=./xme_ca_udm_dbg.stdout %s
+// CHECK: TEST PASSED
+
+module {
+  func.func @dut(%arg0: memref<1024xf32>, %arg1: memref<1024xf32>) {
+    %cst = arith.constant 0.000000e+00 : f32
+    affine.for %arg2 = 0 to 1024 step 16 {
+      %0 = vector.transfer_read %arg0[%arg2], %cst : memref<1024xf32>, vector<16xf32>
+      %1 = math.exp %0 : vector<16xf32>
+      vector.transfer_write %1, %arg1[%arg2] : vector<16xf32>, memref<1024xf32>
+    }
+    return
+  }
+}
@@ -0,0 +1,234 @@
+//===- aie-lower-cores.cpp --------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// Lower every core of a design to its own LLVM IR module.  This performs the
+// same per-core steps as
+//
+//   aie-opt --aie-localize-locks --aie-standard-lowering=tilecol=C tilerow=R
+//   aie-opt <core pipeline>
+//   aie-translate --mlir-to-llvmir
+//   aie-translate --aie-generate-ldscript (or --aie-generate-bcf)
+//
+// but parses the design once and lowers the cores in parallel on the
+// context's thread pool, writing core_<col>_<row>.{opt.mlir,ll,ld.script,bcf}
+// into the output directory.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/IR/Diagnostics.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/IR/Threading.h"
+#include "mlir/InitAllDialects.h"
+#include "mlir/InitAllPasses.h"
+#include "mlir/Parser/Parser.h"
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Pass/PassRegistry.h"
+#include "mlir/Support/FileUtilities.h"
+#include "mlir/Support/Timing.h"
+#include "mlir/Target/LLVMIR/Dialect/All.h"
+#include "mlir/Target/LLVMIR/Export.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/ToolOutputFile.h"
+
+#include "aie/Conversion/Passes.h"
+#include "aie/Dialect/ADF/ADFDialect.h"
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+#include "aie/Dialect/AIEVec/IR/AIEVecDialect.h"
+#include "aie/Dialect/AIEVec/Pipelines/Passes.h"
+#include "aie/Dialect/AIEVec/Transforms/Passes.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+#include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
+
+using namespace llvm;
+using namespace mlir;
+using namespace xilinx::AIE;
+
+static cl::opt<std::string> inputFilename(cl::Positional,
+                                          cl::desc("<input file>"),
+                                          cl::init("-"));
+
+static cl::opt<std::string>
+    outputDir("output-dir", cl::desc("Directory for the per-core files"),
+              cl::init("."));
+
+static cl::opt<std::string> corePipeline(
+    "core-pipeline",
+    cl::desc("Pass pipeline to run on each core after standard lowering"),
+    cl::init(""));
+
+static cl::opt<bool>
+    emitMLIR("emit-mlir",
+             cl::desc("Write the lowered MLIR of each core (.opt.mlir)"),
+             cl::init(true));
+
+static cl::opt<bool>
+    emitLDScript("emit-ldscript",
+                 cl::desc("Write the linker script of each core (.ld.script)"),
+                 cl::init(false));
+
+static cl::opt<bool> emitBCF("emit-bcf",
+                             cl::desc("Write the bcf of each core (.bcf)"),
+                             cl::init(false));
+
+static cl::opt<unsigned>
+    numThreads("j", cl::desc("Number of threads (0 uses all available)"),
+               cl::init(0));
+
+static std::string coreFile(TileID coord, StringRef ext) {
+  SmallString<128> path(outputDir);
+  sys::path::append(path, "core_" + std::to_string(coord.first) + "_" +
+                              std::to_string(coord.second) + "." + ext.str());
+  return std::string(path);
+}
+
+static LogicalResult
+writeFile(StringRef filename,
+          function_ref<LogicalResult(raw_ostream &)> writeContents) {
+  std::string errorMessage;
+  auto output = openOutputFile(filename, &errorMessage);
+  if (!output) {
+    errs() << errorMessage << "\n";
+    return failure();
+  }
+  if (failed(writeContents(output->os())))
+    return failure();
+  output->keep();
+  return success();
+}
+
+// Lower the core at 'coord' in a private copy of the design.  Pass timings
+// are reported under a 'core_<col>_<row>' scope nested in 'timing'.
+static LogicalResult lowerCore(ModuleOp design, TileID coord,
+                               TimingScope &timing) {
+  MLIRContext *context = design.getContext();
+  OwningOpRef<ModuleOp> core(design.clone());
+
+  std::string pipeline = "AIE.device(aie-localize-locks),"
+                         "aie-standard-lowering{tilecol=" +
+                         std::to_string(coord.first) +
+                         " tilerow=" + std::to_string(coord.second) + "}";
+  if (!corePipeline.empty())
+    pipeline += "," + corePipeline;
+
+  PassManager pm(context, ModuleOp::getOperationName());
+  if (failed(parsePassPipeline(pipeline, pm, errs())))
+    return failure();
+  TimingScope coreTiming =
+      timing.nest("core_" + std::to_string(coord.first) + "_" +
+                  std::to_string(coord.second));
+  pm.enableTiming(coreTiming);
+  if (failed(pm.run(*core)))
+    return failure();
+
+  if (emitMLIR && failed(writeFile(coreFile(coord, "opt.mlir"),
+                                   [&](raw_ostream &os) {
+                                     core->print(os);
+                                     return success();
+                                   })))
+    return failure();
+
+  if (emitLDScript &&
+      failed(writeFile(coreFile(coord, "ld.script"), [&](raw_ostream &os) {
+        return AIETranslateToLdScript(design, os, coord.first, coord.second);
+      })))
+    return failure();
+
+  if (emitBCF &&
+      failed(writeFile(coreFile(coord, "bcf"), [&](raw_ostream &os) {
+        return AIETranslateToBCF(design, os, coord.first, coord.second);
+      })))
+    return failure();
+
+  // Each core gets its own LLVMContext, so the translations can proceed
+  // concurrently.
+  llvm::LLVMContext llvmContext;
+  auto llvmModule = translateModuleToLLVMIR(*core, llvmContext);
+  if (!llvmModule)
+    return core->emitError("failed to translate core (")
+           << coord.first << ", " << coord.second << ") to LLVM IR";
+  return writeFile(coreFile(coord, "ll"), [&](raw_ostream &os) {
+    llvmModule->print(os, nullptr);
+    return success();
+  });
+}
+
+int main(int argc, char **argv) {
+  InitLLVM y(argc, argv);
+
+  registerAllPasses();
+  xilinx::registerConversionPasses();
+  aie::registerAIEPasses();
+  xilinx::AIEX::registerAIEXPasses();
+  xilinx::aievec::registerAIEVecPasses();
+  xilinx::aievec::registerAIEVecPipelines();
+  registerDefaultTimingManagerCLOptions();
+
+  cl::ParseCommandLineOptions(argc, argv, "AIE per-core lowering driver\n");
+
+  DialectRegistry registry;
+  registerAllDialects(registry);
+  registerAllToLLVMIRTranslations(registry);
+  registry.insert<xilinx::AIE::AIEDialect>();
+  registry.insert<xilinx::AIEX::AIEXDialect>();
+  registry.insert<xilinx::aievec::AIEVecDialect>();
+  registry.insert<xilinx::ADF::ADFDialect>();
+
+  MLIRContext context(registry, MLIRContext::Threading::DISABLED);
+  std::unique_ptr<ThreadPool> threadPool;
+  if (numThreads != 1) {
+    threadPool = std::make_unique<ThreadPool>(hardware_concurrency(numThreads));
+    context.setThreadPool(*threadPool);
+  }
+  context.loadAllAvailableDialects();
+
+  DefaultTimingManager tm;
+  applyDefaultTimingManagerCLOptions(tm);
+  TimingScope timing = tm.getRootScope();
+
+  std::string errorMessage;
+  auto file = openInputFile(inputFilename, &errorMessage);
+  if (!file) {
+    errs() << errorMessage << "\n";
+    return 1;
+  }
+  SourceMgr sourceMgr;
+  sourceMgr.AddNewSourceBuffer(std::move(file), SMLoc());
+  SourceMgrDiagnosticHandler diagHandler(sourceMgr, &context);
+
+  TimingScope parserTiming = timing.nest("Parser");
+  OwningOpRef<ModuleOp> design = parseSourceFile<ModuleOp>(sourceMgr, &context);
+  parserTiming.stop();
+  if (!design)
+    return 1;
+
+  if (design->getOps<DeviceOp>().empty()) {
+    design->emitOpError("expected AIE.device operation at toplevel");
+    return 1;
+  }
+  DeviceOp device = *(design->getOps<DeviceOp>().begin());
+
+  SmallVector<TileID> cores;
+  for (auto tile : device.getOps<TileOp>())
+    if (tile.getCoreOp())
+      cores.push_back({tile.colIndex(), tile.rowIndex()});
+
+  if (failed(failableParallelForEach(&context, cores, [&](TileID coord) {
+        return lowerCore(*design, coord, timing);
+      })))
+    return 1;
+  return 0;
+}
@@ -0,0 +1,143 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2023 Xilinx Inc.
+
+"""
+Content-addressed artifact cache for per-core compilation.
+
+Each core's artifacts (.o/.elf) are stored under a key derived from the
+lowered core code, the linker script/bcf, the identity of every tool in the
+flow and the command line flags that influence code generation.  A rebuild
+that doesn't change any of those inputs can copy the artifacts back instead
+of rerunning opt/llc/xchesscc and the linker.
+"""
+
+import hashlib
+import os
+import re
+import shutil
+import tempfile
+
+# Bump this whenever the layout of a cache entry or the set of hashed inputs
+# changes, so that stale entries from older versions of aiecc are ignored.
+CACHE_FORMAT_VERSION = 1
+
+# The objects that a linker script (INPUT(...)) or bcf (_include _file ...)
+# links into the elf of a core, i.e. the objects named by link_with.
+def linked_inputs(filename):
+    if(not (filename.endswith('.ld.script') or filename.endswith('.bcf'))):
+      return []
+    if(not os.path.isfile(filename)):
+      return []
+    with open(filename, 'r') as f:
+      text = f.read()
+    return re.findall(r'^INPUT\((\S+)\)', text, re.MULTILINE) + \
+           re.findall(r'^_include _file (\S+)', text, re.MULTILINE)
+
+class artifact_cache:
+  def __init__(self, cachedir):
+      self.cachedir = os.path.abspath(cachedir)
+      os.makedirs(self.cachedir, exist_ok=True)
+      self.toolids = dict()
+      self.hits = 0
+      self.misses = 0
+
+  # Identify a tool by its resolved path, size and modification time.  This
+  # is much cheaper than asking every tool for --version and also catches
+  # locally rebuilt tools that don't bump their version string.
+  def tool_identity(self, tool):
+      if(tool not in self.toolids):
+        path = shutil.which(tool)
+        if(path):
+          path = os.path.realpath(path)
+          st = os.stat(path)
+          self.toolids[tool] = "%s:%d:%d" % (path, st.st_size, st.st_mtime_ns)
+        else:
+          self.toolids[tool] = "%s:<missing>" % tool
+      return self.toolids[tool]
+
+  def file_identity(self, filename):
+      if(not os.path.isfile(filename)):
+        return "<missing>"
+      h = hashlib.sha256()
+      with open(filename, 'rb') as f:
+        for chunk in iter(lambda: f.read(1 << 20), b''):
+          h.update(chunk)
+      return h.hexdigest()
+
+  # Compute the key for a core.  'files' are hashed by content, 'tools' by
+  # identity and 'flags' verbatim.  Objects pulled in by the linker script
+  # (INPUT(...)) or bcf (_include _file ...) are hashed as well, since they
+  # are part of the final elf.
+  def key(self, files, tools, flags):
+      h = hashlib.sha256()
+      h.update(b'aiecc-cache-v%d\0' % CACHE_FORMAT_VERSION)
+      for tool in sorted(set(tools)):
+        h.update(self.tool_identity(tool).encode() + b'\0')
+      for flag in flags:
+        h.update(str(flag).encode() + b'\0')
+      for filename in files:
+        h.update(self.file_identity(filename).encode() + b'\0')
+        for linked in linked_inputs(filename):
+          h.update(linked.encode() + b'=' + self.file_identity(linked).encode() + b'\0')
+      return h.hexdigest()
+
+
+  def entry(self, key):
+      return os.path.join(self.cachedir, key[0:2], key)
+
+  # Copy the cached artifacts for 'key' to the given destinations.  Returns
+  # False (and copies nothing) unless every artifact is present.
+  def fetch(self, key, artifacts):
+      entrydir = self.entry(key)
+      sources = [os.path.join(entrydir, name) for name in artifacts.keys()]
+      if(not all(os.path.isfile(s) for s in sources)):
+        self.misses += 1
+        return False
+      for (src, dst) in zip(sources, artifacts.values()):
+        shutil.copyfile(src, dst)
+      self.hits += 1
+      return True
+
+  # Store the artifacts for 'key'.  Entries are populated in a private
+  # directory and renamed into place, so concurrent aiecc invocations sharing
+  # a cache never observe a partially written entry.
+  def store(self, key, artifacts):
+      entrydir = self.entry(key)
+      if(os.path.isdir(entrydir)):
+        return
+      if(not all(os.path.isfile(f) for f in artifacts.values())):
+        return
+      parent = os.path.dirname(entrydir)
+      os.makedirs(parent, exist_ok=True)
+      stagedir = tempfile.mkdtemp(dir=parent, prefix='.tmp-')
+      try:
+        for (name, src) in artifacts.items():
+          shutil.copyfile(src, os.path.join(stagedir, name))
+        os.rename(stagedir, entrydir)
+      except OSError:
+        # Somebody else won the race, their entry is just as good.
+        shutil.rmtree(stagedir, ignore_errors=True)
+
+  # Content-addressed storage of single files.  This is how the remote
+  # executor moves the inputs and outputs of a command between aiecc and its
+  # workers, which therefore need to share the cache directory.
+  def blob(self, digest):
+      return os.path.join(self.cachedir, 'blobs', digest[0:2], digest)
+
+  def put_blob(self, filename):
+      digest = self.file_identity(filename)
+      blob = self.blob(digest)
+      if(not os.path.isfile(blob)):
+        os.makedirs(os.path.dirname(blob), exist_ok=True)
+        (fd, staged) = tempfile.mkstemp(dir=os.path.dirname(blob), prefix='.tmp-')
+        os.close(fd)
+        shutil.copyfile(filename, staged)
+        os.replace(staged, blob)
+      return digest
+
+  def get_blob(self, digest, filename):
+      shutil.copyfile(self.blob(digest), filename)
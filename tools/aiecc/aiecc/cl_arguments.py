@@ -117,7 +117,7 @@ def parse_args():
             dest="profiling",
             default=False,
             action='store_true',
-            help='Profile commands to find the most expensive executions.')
+            help='Profile commands to find the most expensive executions.  Also reports the most expensive MLIR passes and worker utilization, and writes a Chrome trace of the build to aiecc.trace.json in the project directory.')
     parser.add_argument('--unified',
             dest="unified",
             default=aie_unified_compile,
@@ -128,11 +128,56 @@ def parse_args():
             default=not aie_unified_compile,
             action='store_false',
             help='Compile cores independently in separate processes')
+    parser.add_argument('--in-process-lowering',
+            dest="in_process_lowering",
+            default=False,
+            action='store_true',
+            help='Lower all cores in a single aie-lower-cores process (only with --no-unified)')
+    parser.add_argument('--no-in-process-lowering',
+            dest="in_process_lowering",
+            default=False,
+            action='store_false',
+            help='Lower each core with separate aie-opt and aie-translate processes')
     parser.add_argument('-n',
             dest="execute",
             default=True,
             action='store_false',
             help='Disable actually executing any commands.')
+    parser.add_argument('--dedup-cores',
+            dest="dedup_cores",
+            default=False,
+            action='store_true',
+            help='Compile cores with identical code (up to tile-relative symbols) once and link each tile from the shared object')
+    parser.add_argument('--no-dedup-cores',
+            dest="dedup_cores",
+            default=False,
+            action='store_false',
+            help='Compile every core independently')
+    parser.add_argument('--lto',
+            dest="lto",
+            default=False,
+            action='store_true',
+            help='Compile the external kernels of each core (link_with) from source to LLVM IR and optimize them together with the core, so that they can be inlined and specialized.  The source must be next to the object, with a .cc, .cpp or .c extension.  Only applies to the non-unified flow compiling with Peano')
+    parser.add_argument('--no-lto',
+            dest="lto",
+            default=False,
+            action='store_false',
+            help='Link the external kernels of each core as objects')
+    parser.add_argument('--pgo-profile',
+            dest="pgo_profile",
+            metavar="profile",
+            default=None,
+            help='Choose the optimization of each core from the cycles measured for it, given as JSON (see aiecc/pgo.py).  Hot cores are optimized for speed and cold cores are built at -O1, unless their compile_options say otherwise.  Only applies to the non-unified flow compiling with Peano')
+    parser.add_argument('--cache-dir',
+            dest="cachedir",
+            metavar="cachedir",
+            default=None,
+            help='Reuse per-core compilation artifacts from this directory when the lowered core code, tools and flags are unchanged')
+    parser.add_argument('--remote-workers',
+            dest="remote_workers",
+            metavar="addresses",
+            default=None,
+            help='Run core code generation on aiecc workers (python3 -m aiecc.executor) at these comma separated host:port or unix:/path addresses.  Files are exchanged through the cache directory, which must be shared with the workers')
     parser.add_argument('--progress',
             dest="progress",
             default=False,
@@ -0,0 +1,214 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2023 Xilinx Inc.
+
+"""
+Executors run the commands issued by aiecc.
+
+The local executor runs commands as subprocesses of aiecc.  The remote
+executor sends the per-core code generation commands (opt, llc and
+llvm-objcopy) to workers listening on a socket and runs everything else
+locally.  Input and output files travel through the blob store of the cache
+directory, which aiecc and all of its workers must share, e.g. over NFS.
+Paths outside of the command line (such as tools or runtime libraries) are
+not transferred, so workers need the same installation as aiecc.
+
+A worker is started with
+
+  python3 -m aiecc.executor --listen host:port --cache-dir DIR -j N
+
+and aiecc is pointed at one or more workers with
+--remote-workers host:port[,host:port...] --cache-dir DIR.  Addresses of the
+form unix:/path use a unix domain socket instead.
+
+Workers don't authenticate their clients.  They only run the tools in
+remote_tools, on files in their scratch directory, but anybody who can
+connect can still make them do so.  Bind --listen to a trusted interface (or
+a unix socket with restrictive permissions), never to a public one.
+"""
+
+import argparse
+import asyncio
+import json
+import os
+import re
+import shutil
+import sys
+import tempfile
+
+import aiecc.cache
+
+# Commands that only read the files named on their command line and write
+# the file named by -o (or, for llvm-objcopy, the last argument).
+remote_tools = ['opt', 'llc', 'llvm-objcopy']
+
+# Options that make a tool load code, which a worker must never accept from a
+# client.
+plugin_options = ['-load', '-load-pass-plugin', '-pass-plugin']
+
+def output_files(command):
+    if(os.path.basename(command[0]) == 'llvm-objcopy'):
+      return [command[-1]]
+    return [command[i+1] for (i, arg) in enumerate(command[:-1]) if arg == '-o']
+
+async def open_connection(address):
+    if(address.startswith('unix:')):
+      return await asyncio.open_unix_connection(address[len('unix:'):])
+    (host, port) = address.rsplit(':', 1)
+    return await asyncio.open_connection(host, int(port))
+
+async def start_server(callback, address):
+    if(address.startswith('unix:')):
+      return await asyncio.start_unix_server(callback, address[len('unix:'):])
+    (host, port) = address.rsplit(':', 1)
+    return await asyncio.start_server(callback, host, int(port))
+
+class local_executor:
+  # Run the command and return its exit code and, if 'capture_stderr' is set,
+  # its standard error.
+  async def run(self, command, capture_stderr=False):
+      if(capture_stderr):
+        proc = await asyncio.create_subprocess_exec(*command, stderr=asyncio.subprocess.PIPE)
+        (_, stderr) = await proc.communicate()
+        return (proc.returncode, stderr.decode(errors='replace'))
+      proc = await asyncio.create_subprocess_exec(*command)
+      await proc.wait()
+      return (proc.returncode, None)
+
+class remote_executor:
+  def __init__(self, addresses, cache):
+      self.local = local_executor()
+      self.cache = cache
+      # Commands in flight on each worker, used to pick the least busy one.
+      self.load = dict((address, 0) for address in addresses)
+
+  async def run(self, command, capture_stderr=False):
+      if(os.path.basename(command[0]) not in remote_tools):
+        return await self.local.run(command, capture_stderr)
+
+      outputs = output_files(command)
+      inputs = dict((arg, self.cache.put_blob(arg)) for arg in command[1:]
+                    if arg not in outputs and os.path.isfile(arg))
+      request = {'command': command, 'inputs': inputs, 'outputs': outputs}
+
+      address = min(self.load, key=self.load.get)
+      self.load[address] += 1
+      try:
+        (reader, writer) = await open_connection(address)
+        writer.write(json.dumps(request).encode() + b'\n')
+        await writer.drain()
+        reply = json.loads(await reader.readline())
+        writer.close()
+      except (OSError, ValueError) as e:
+        print("Worker %s failed (%s), running locally: %s" % (address, e, " ".join(command)))
+        return await self.local.run(command, capture_stderr)
+      finally:
+        self.load[address] -= 1
+
+      for (filename, digest) in reply['outputs'].items():
+        self.cache.get_blob(digest, filename)
+      stderr = reply['stderr']
+      if(not capture_stderr):
+        sys.stderr.write(stderr)
+        stderr = None
+      return (reply['returncode'], stderr)
+
+class worker:
+  def __init__(self, cache, nthreads):
+      self.cache = cache
+      self.limit = asyncio.Semaphore(nthreads)
+
+  # Check a request before running anything for it.  Only the tools in
+  # remote_tools may run, only the files named as inputs or outputs are
+  # replaced by their copies in the scratch directory, and other arguments
+  # may neither name files outside of it nor load plugins.  Returns the
+  # reason a request is refused, or None.
+  def check_request(self, request):
+      command = request['command']
+      if(not command or command[0] not in remote_tools):
+        return "refusing to run %s: not one of %s" % (command[0] if command else "nothing", ", ".join(remote_tools))
+      for digest in request['inputs'].values():
+        if(not re.fullmatch(r'[0-9a-f]{64}', digest)):
+          return "refusing to fetch blob %s" % digest
+      files = set(request['inputs']) | set(request['outputs'])
+      for arg in command[1:]:
+        if(arg in files):
+          continue
+        option = arg.lstrip('-').partition('=')[0]
+        if(arg.startswith('-') and '-' + option in plugin_options):
+          return "refusing to load plugins: %s" % arg
+        values = re.split(r'[=,]', arg)
+        if('..' in arg or any(os.path.isabs(value) for value in values)):
+          return "refusing to access files outside of the scratch directory: %s" % arg
+      return None
+
+  # Run one command in a private scratch directory.  The files named on the
+  # command line are replaced by local copies fetched from the blob store,
+  # and the outputs are put back into the blob store when it succeeds.
+  async def handle(self, reader, writer):
+      request = json.loads(await reader.readline())
+      refusal = self.check_request(request)
+      if(refusal):
+        reply = {'returncode': 1, 'stderr': refusal + '\n', 'outputs': {}}
+        writer.write(json.dumps(reply).encode() + b'\n')
+        await writer.drain()
+        writer.close()
+        return
+      async with self.limit:
+        scratch = tempfile.mkdtemp(prefix='aiecc-worker-')
+        try:
+          local = dict()
+          for (i, filename) in enumerate(list(request['inputs']) + request['outputs']):
+            local[filename] = os.path.join(scratch, '%d-%s' % (i, os.path.basename(filename)))
+          for (filename, digest) in request['inputs'].items():
+            self.cache.get_blob(digest, local[filename])
+          command = [local.get(arg, arg) for arg in request['command']]
+          proc = await asyncio.create_subprocess_exec(*command, cwd=scratch,
+                                                      stderr=asyncio.subprocess.PIPE)
+          (_, stderr) = await proc.communicate()
+          outputs = dict()
+          if(proc.returncode == 0):
+            outputs = dict((filename, self.cache.put_blob(local[filename]))
+                           for filename in request['outputs'])
+          reply = {'returncode': proc.returncode,
+                   'stderr': stderr.decode(errors='replace'),
+                   'outputs': outputs}
+        except OSError as e:
+          reply = {'returncode': 1, 'stderr': str(e) + '\n', 'outputs': {}}
+        finally:
+          shutil.rmtree(scratch, ignore_errors=True)
+      writer.write(json.dumps(reply).encode() + b'\n')
+      await writer.drain()
+      writer.close()
+
+async def serve(address, cachedir, nthreads):
+    w = worker(aiecc.cache.artifact_cache(cachedir), nthreads)
+    server = await start_server(w.handle, address)
+    print("aiecc worker listening on %s with %d threads" % (address, nthreads))
+    async with server:
+      await server.serve_forever()
+
+def main():
+    parser = argparse.ArgumentParser(prog='aiecc.executor',
+            description='Run aiecc core compilation commands for remote clients')
+    parser.add_argument('--listen',
+            dest="address",
+            required=True,
+            help='Address to listen on, host:port or unix:/path.  Clients are not authenticated, so only listen on a trusted interface')
+    parser.add_argument('--cache-dir',
+            dest="cachedir",
+            required=True,
+            help='Cache directory shared with the aiecc clients')
+    parser.add_argument('-j',
+            dest="nthreads",
+            type=int,
+            default=os.cpu_count(),
+            help='Number of commands to run concurrently (default is the number of processors)')
+    opts = parser.parse_args()
+    asyncio.run(serve(opts.address, opts.cachedir, opts.nthreads))
+
+if __name__ == '__main__':
+    main()
@@ -9,6 +9,7 @@
 aiecc - AIE compiler driver for MLIR tools
 """
 
+import hashlib
 import itertools
 import os
 import stat
@@ -23,6 +24,10 @@ import asyncio
 
 import aiecc.cl_arguments
 import aiecc.configure
+import aiecc.cache
+import aiecc.executor
+import aiecc.profile
+import aiecc.pgo
 
 import rich.progress as progress
 import re
@@ -41,14 +46,68 @@ aie_opt_passes = ['--aie-normalize-address-spaces',
                   '--canonicalize',
                   '--cse']
 
+# Tools whose identity is part of the cache key of every core.
+aie_core_tools = ['aie-opt', 'aie-translate', 'opt', 'llc', 'clang',
+                  'llvm-objcopy', 'xchesscc', 'xchesscc_wrapper']
+
+# Convert a list of aie-opt pass flags to a textual pass pipeline, e.g.
+# ['--cse', '--convert-func-to-llvm=use-bare-ptr-memref-call-conv'] becomes
+# 'cse,convert-func-to-llvm{use-bare-ptr-memref-call-conv}'.
+def pass_pipeline(passes):
+    def convert(flag):
+      (name, _, options) = flag.lstrip('-').partition('=')
+      return name + ('{' + options + '}' if options else '')
+    return ','.join(convert(flag) for flag in passes)
+
+# Fingerprint the LLVM IR of a core modulo its tile-relative symbols.  The
+# per-tile lowering differs between replicated cores only in the name of the
+# core function and the names of the buffers it touches (lock ids are already
+# tile-relative after --aie-localize-locks).  Every buffer of the design is
+# declared in the module of each core, so the declarations of the buffers that
+# the core doesn't touch are dropped, and the remaining symbols are replaced
+# by placeholders numbered in the order of their first use.  Returns the
+# fingerprint and the original symbol names in placeholder order, so that an
+# object compiled for one core can be retargeted to another by renaming
+# symbols.
+llvm_ident = r'[-a-zA-Z$._0-9]+'
+
+def core_fingerprint(file_core_llvmir):
+    with open(file_core_llvmir, 'r') as f:
+      text = f.read()
+    text = re.sub(r'^(; ModuleID|source_filename).*$', '', text, flags=re.MULTILINE)
+    uses = re.findall(r'@(' + llvm_ident + r')', text)
+    for sym in re.findall(r'^@(' + llvm_ident + r') = external global ', text, re.MULTILINE):
+      if(uses.count(sym) == 1):
+        text = re.sub(r'^@' + re.escape(sym) + r' = external global .*\n', '', text, flags=re.MULTILINE)
+    defined = set(re.findall(r'^@(' + llvm_ident + r') = ', text, re.MULTILINE))
+    symbols = re.findall(r'^define\b.*@(core_[0-9]+_[0-9]+)\(', text, re.MULTILINE)
+    for sym in re.findall(r'@(' + llvm_ident + r')', text):
+      if(sym in defined and sym not in symbols):
+        symbols.append(sym)
+    placeholders = dict((sym, '__aiecc_sym%d' % i) for (i, sym) in enumerate(symbols))
+    canonical = re.sub(r'@(' + llvm_ident + r')',
+                       lambda m: '@' + placeholders.get(m.group(1), m.group(1)),
+                       text)
+    return (hashlib.sha256(canonical.encode()).hexdigest(), symbols)
+
 class flow_runner:
   def __init__(self, opts, tmpdirname):
       self.opts = opts
       self.tmpdirname = tmpdirname
       self.runtimes = dict()
+      self.profiler = aiecc.profile.profiler() if opts.profiling else None
       self.progress_bar = None
       self.maxtasks = 5
       self.stopall = False
+      self.cache = None
+      self.shared_objects = dict()
+      self.kernels = dict()
+      if(opts.cachedir and opts.execute):
+        self.cache = aiecc.cache.artifact_cache(opts.cachedir)
+      if(opts.remote_workers and self.cache):
+        self.executor = aiecc.executor.remote_executor(opts.remote_workers.split(','), self.cache)
+      else:
+        self.executor = aiecc.executor.local_executor()
 
   async def do_call(self, task, command, force=False):
       if(self.stopall):
@@ -60,16 +119,26 @@ class flow_runner:
       start = time.time()
       if(self.opts.verbose):
           print(commandstr)
+      mlir_timing = None
       if(self.opts.execute or force):
-        proc = await asyncio.create_subprocess_exec(*command)
-        await proc.wait()
-        ret = proc.returncode
+        if(self.profiler and self.profiler.wants_mlir_timing(command)):
+          # Collect the pass timings from stderr and pass through anything
+          # else the tool had to say.
+          (ret, stderr) = await self.executor.run(command + aiecc.profile.mlir_timing_args, capture_stderr=True)
+          report = stderr.find('===-')
+          if(report >= 0 and 'Execution time report' in stderr[report:]):
+            (stderr, mlir_timing) = (stderr[0:report], stderr[report:])
+          sys.stderr.write(stderr)
+        else:
+          (ret, _) = await self.executor.run(command)
       else:
         ret = 0
       end = time.time()
       if(self.opts.verbose):
           print("Done in %.3f sec: %s" % (end-start, commandstr))
       self.runtimes[commandstr] = end-start
+      if(self.profiler):
+        self.profiler.record(command, start, end, mlir_timing)
       if(task):
         self.progress_bar.update(task, advance=1, command="")
         self.maxtasks = max(self.progress_bar._tasks[task].completed, self.maxtasks)
@@ -108,37 +177,15 @@ class flow_runner:
       t = self.do_run(['awk', '/_include _file/ {print($3)}', file_core_bcf])
       return ' '.join(t.stdout.split())
 
-  # In order to run xchesscc on modern ll code, we need a bunch of hacks.
-  async def chesshack(self, task, llvmir):
-      llvmir_chesshack = llvmir + "chesshack.ll"
-      await self.do_call(task, ['cp', llvmir, llvmir_chesshack])
-      await self.do_call(task, ['sed', '-i', 's/noundef//', llvmir_chesshack])
-      await self.do_call(task, ['sed', '-i', 's/noalias_sidechannel[^,],//', llvmir_chesshack])
-      llvmir_chesslinked = llvmir + "chesslinked.ll"
-      # Note that chess-clang comes from a time before opaque pointers
-      #await self.do_call(task, ['clang', "-Xclang -no-opaque-pointers", llvmir_chesshack, self.chess_intrinsic_wrapper, '-S', '-emit-llvm', '-o', llvmir_chesslinked])
-      await self.do_call(task, ['llvm-link', '--opaque-pointers=0', llvmir_chesshack, self.chess_intrinsic_wrapper, '-S', '-o', llvmir_chesslinked])
-      await self.do_call(task, ['sed', '-i', 's/noundef//', llvmir_chesslinked])
-      # Formal function argument names not used in older LLVM
-      await self.do_call(task, ['sed', '-i', '-E', '/define .*@/ s/%[0-9]*//g', llvmir_chesslinked])
-      await self.do_call(task, ['sed', '-i', '-E', 's/mustprogress//g', llvmir_chesslinked])
-      await self.do_call(task, ['sed', '-i', '-E', 's/poison/undef/g', llvmir_chesslinked])
-      await self.do_call(task, ['sed', '-i', '-E', 's/nocallback//g', llvmir_chesslinked])
-      await self.do_call(task, ['sed', '-i', '-E', 's/memory\(none\)/readnone/g', llvmir_chesslinked])
-      await self.do_call(task, ['sed', '-i', '-E', 's/memory\(read\)/readonly/g', llvmir_chesslinked])
-      await self.do_call(task, ['sed', '-i', '-E', 's/memory\(write\)/writeonly/g', llvmir_chesslinked])
-      await self.do_call(task, ['sed', '-i', '-E', 's/memory\(argmem: readwrite\)/argmemonly/g', llvmir_chesslinked])
-      await self.do_call(task, ['sed', '-i', '-E', 's/memory\(argmem: read\)/argmemonly readonly/g', llvmir_chesslinked])
-      await self.do_call(task, ['sed', '-i', '-E', 's/memory\(argmem: write\)/argmemonly writeonly/g', llvmir_chesslinked])
-      await self.do_call(task, ['sed', '-i', '-E', 's/memory\(inaccessiblemem: readwrite\)/inaccessiblememonly/g', llvmir_chesslinked])
-      await self.do_call(task, ['sed', '-i', '-E', 's/memory\(inaccessiblemem: read\)/inaccessiblememonly readonly/g', llvmir_chesslinked])
-      await self.do_call(task, ['sed', '-i', '-E', 's/memory\(inaccessiblemem: write\)/inaccessiblememonly writeonly/g', llvmir_chesslinked])
-      await self.do_call(task, ['sed', '-i', '-E', 's/memory\(argmem: readwrite, inaccessiblemem: readwrite\)/inaccessiblemem_or_argmemonly/g', llvmir_chesslinked])
-      await self.do_call(task, ['sed', '-i', '-E', 's/memory\(argmem: read, inaccessiblemem: read\)/inaccessiblemem_or_argmemonly readonly/g', llvmir_chesslinked])
-      await self.do_call(task, ['sed', '-i', '-E', 's/memory\(argmem: write, inaccessiblemem: write\)/inaccessiblemem_or_argmemonly writeonly/g', llvmir_chesslinked])
+  # xchesscc is based on an older LLVM.  aie-translate emits LLVM IR in the
+  # older syntax and links in the chess intrinsic wrapper.
+  async def chess_llvmir(self, task, file_opt, llvmir_chesslinked):
+      await self.do_call(task, ['aie-translate', '--opaque-pointers=0', '--aie-generate-chess-llvmir',
+                                '--chess-intrinsic-wrapper=' + self.chess_intrinsic_wrapper,
+                                file_opt, '-o', llvmir_chesslinked])
       return llvmir_chesslinked
 
-  async def prepare_for_chesshack(self, task):
+  async def prepare_chess_intrinsic_wrapper(self, task):
       if(opts.compile and opts.xchesscc):
         thispath = os.path.dirname(os.path.realpath(__file__))
         runtime_lib_path = os.path.join(thispath, '..','..','aie_runtime_lib')
@@ -146,10 +193,6 @@ class flow_runner:
 
         self.chess_intrinsic_wrapper = os.path.join(self.tmpdirname, 'chess_intrinsic_wrapper.ll')
         await self.do_call(task, ['xchesscc_wrapper', self.aie_target.lower(), '+w', os.path.join(self.tmpdirname, 'work'), '-c', '-d', '-f', '+f', '+P', '4', chess_intrinsic_wrapper_cpp, '-o', self.chess_intrinsic_wrapper])
-        await self.do_call(task, ['sed', '-i', 's/^target.*//', self.chess_intrinsic_wrapper])
-
-        await self.do_call(task, ['sed', '-i', 's/noalias_sidechannel[^,]*,//', self.chess_intrinsic_wrapper])
-        await self.do_call(task, ['sed', '-i', 's/nocallback[^,]*,//', self.chess_intrinsic_wrapper])
 
 
   async def process_core(self, core):
@@ -180,34 +223,65 @@ class flow_runner:
         task = None
 
       (corecol, corerow, elf_file) = core
+      # With in-process lowering, aie-lower-cores has already produced the
+      # lowered MLIR, LLVM IR and linker script/bcf of every core.
+      lowered = not opts.unified and opts.in_process_lowering
       if(not opts.unified):
         file_core = self.tmpcorefile(core, "mlir")
-        await self.do_call(task, ['aie-opt', '--aie-localize-locks',
-                            '--aie-standard-lowering=tilecol=%d tilerow=%d' % core[0:2],
-                            self.file_with_addresses, '-o', file_core])
         file_opt_core = self.tmpcorefile(core, "opt.mlir")
-        await self.do_call(task, ['aie-opt', *aie_opt_passes, file_core, '-o', file_opt_core])
+        if(not lowered):
+          await self.do_call(task, ['aie-opt', '--aie-localize-locks',
+                              '--aie-standard-lowering=tilecol=%d tilerow=%d' % core[0:2],
+                              self.file_with_addresses, '-o', file_core])
+          await self.do_call(task, ['aie-opt', *aie_opt_passes, file_core, '-o', file_opt_core])
       if(self.opts.xbridge):
         file_core_bcf = self.tmpcorefile(core, "bcf")
-        await self.do_call(task, ['aie-translate', self.file_with_addresses, '--aie-generate-bcf', '--tilecol=%d' % corecol, '--tilerow=%d' % corerow, '-o', file_core_bcf])
+        if(not lowered):
+          await self.do_call(task, ['aie-translate', self.file_with_addresses, '--aie-generate-bcf', '--tilecol=%d' % corecol, '--tilerow=%d' % corerow, '-o', file_core_bcf])
       else:
         file_core_ldscript = self.tmpcorefile(core, "ld.script")
-        await self.do_call(task, ['aie-translate', self.file_with_addresses, '--aie-generate-ldscript', '--tilecol=%d' % corecol, '--tilerow=%d' % corerow, '-o', file_core_ldscript])
+        if(not lowered):
+          await self.do_call(task, ['aie-translate', self.file_with_addresses, '--aie-generate-ldscript', '--tilecol=%d' % corecol, '--tilerow=%d' % corerow, '-o', file_core_ldscript])
       if(not self.opts.unified):
         file_core_llvmir = self.tmpcorefile(core, "ll")
-        await self.do_call(task, ['aie-translate', '--opaque-pointers=0', '--mlir-to-llvmir', file_opt_core, '-o', file_core_llvmir])
+        if(not lowered):
+          await self.do_call(task, ['aie-translate', '--opaque-pointers=0', '--mlir-to-llvmir', file_opt_core, '-o', file_core_llvmir])
         file_core_obj = self.tmpcorefile(core, "o")
 
       file_core_elf = elf_file if elf_file else self.corefile(".", core, "elf")
 
+      # Only the non-unified flow has per-core lowered code that we can key
+      # on.  In the unified flow all cores share a single object anyway.
+      file_core_linkinfo = file_core_bcf if self.opts.xbridge else file_core_ldscript
+      kernel_sources = []
+      if(opts.lto and not opts.unified and opts.compile and not opts.xchesscc):
+        kernel_sources = self.kernel_sources(file_core_linkinfo)
+
+      cache_key = None
+      if(self.cache and not opts.unified and opts.compile):
+        cache_artifacts = self.core_cache_artifacts(core, file_core_elf)
+        cache_inputs = [file_opt_core, file_core_linkinfo, me_basic_o, libc, *kernel_sources]
+        if(opts.xchesscc):
+          cache_inputs.append(self.chess_intrinsic_wrapper)
+        cache_key = self.cache.key(cache_inputs,
+                                   aie_core_tools,
+                                   self.core_cache_flags(core))
+        if(self.cache.fetch(cache_key, cache_artifacts)):
+          if(self.opts.verbose):
+            print("Reusing cached artifacts for core (%d, %d)" % core[0:2])
+          self.progress_bar.update(self.progress_bar.task_completed,advance=1)
+          if(task):
+            self.progress_bar.update(task,advance=0,visible=False)
+          return
+
       if(opts.compile and opts.xchesscc):
         if(not opts.unified):
-          file_core_llvmir_chesslinked = await self.chesshack(task, file_core_llvmir)
           if(self.opts.link and self.opts.xbridge):
+            file_core_llvmir_chesslinked = await self.chess_llvmir(task, self.tmpcorefile(core, "opt.mlir"), self.tmpcorefile(core, "chesslinked.ll"))
             link_with_obj = self.extract_input_files(file_core_bcf)
             await self.do_call(task, ['xchesscc_wrapper', self.aie_target.lower(), '+w', os.path.join(self.tmpdirname, 'work'), '-d', '-f', '+P', '4', file_core_llvmir_chesslinked, link_with_obj, '+l', file_core_bcf, '-o', file_core_elf])
           elif(self.opts.link):
-            await self.do_call(task, ['xchesscc_wrapper', self.aie_target.lower(), '+w', os.path.join(self.tmpdirname, 'work'), '-c', '-d', '-f', '+P', '4', file_core_llvmir_chesslinked, '-o', file_core_obj])
+            await self.compile_core_obj(task, core, file_core_llvmir, file_core_obj)
             await self.do_call(task, ['clang', '-O2', '--target=' + self.aie_peano_target, file_core_obj, *clang_link_args,
                                       '-Wl,-T,'+file_core_ldscript, '-o', file_core_elf])
         else:
@@ -221,9 +295,8 @@ class flow_runner:
 
       elif(opts.compile):
         if(not opts.unified):
-          file_core_llvmir_stripped = self.tmpcorefile(core, "stripped.ll")
-          await self.do_call(task, ['opt', '--passes=default<O2>,strip', '-S', file_core_llvmir, '-o', file_core_llvmir_stripped])
-          await self.do_call(task, ['llc', file_core_llvmir_stripped, '-O2', '--march=aie', '--function-sections', '--filetype=obj', '-o', file_core_obj])
+          kernels = await self.kernel_llvmir(task, kernel_sources)
+          await self.compile_core_obj(task, core, file_core_llvmir, file_core_obj, kernels)
         else:
           file_core_obj = self.file_obj
         if(opts.link and opts.xbridge):
@@ -233,10 +306,121 @@ class flow_runner:
           await self.do_call(task, ['clang', '-O2', '--target=' + self.aie_peano_target, file_core_obj, *clang_link_args,
                                     '-Wl,-T,'+file_core_ldscript, '-o', file_core_elf])
 
+      if(cache_key):
+        self.cache.store(cache_key, cache_artifacts)
+
       self.progress_bar.update(self.progress_bar.task_completed,advance=1)
       if(task):
         self.progress_bar.update(task,advance=0,visible=False)
 
+  # Compile the LLVM IR of a single core to a relocatable object.  With
+  # --dedup-cores, cores whose code is identical up to the names of their
+  # tile-relative symbols share a single compilation: the first such core
+  # compiles, the others rename the symbols of its object to their own.
+  async def compile_core_obj(self, task, core, file_core_llvmir, file_core_obj, kernels=[]):
+      if(not (self.opts.dedup_cores and self.opts.execute)):
+        await self.codegen_core_obj(task, core, file_core_llvmir, file_core_obj, kernels)
+        return
+
+      (fingerprint, symbols) = core_fingerprint(file_core_llvmir)
+      fingerprint = ':'.join([fingerprint, *kernels, repr(self.core_opt_flags(core))])
+      if(fingerprint in self.shared_objects):
+        (compiled, rep_core, rep_symbols) = self.shared_objects[fingerprint]
+        rep_obj = await compiled
+        if(self.opts.verbose):
+          print("Core (%d, %d) shares code with core (%d, %d)" % (*core[0:2], *rep_core[0:2]))
+        renames = ['--redefine-sym=%s=%s' % (old, new)
+                   for (old, new) in zip(rep_symbols, symbols) if old != new]
+        await self.do_call(task, ['llvm-objcopy', *renames, rep_obj, file_core_obj])
+        return
+
+      compiled = asyncio.get_running_loop().create_future()
+      self.shared_objects[fingerprint] = (compiled, core, symbols)
+      await self.codegen_core_obj(task, core, file_core_llvmir, file_core_obj, kernels)
+      compiled.set_result(file_core_obj)
+
+  async def codegen_core_obj(self, task, core, file_core_llvmir, file_core_obj, kernels=[]):
+      if(self.opts.xchesscc):
+        file_core_llvmir_chesslinked = await self.chess_llvmir(task, self.tmpcorefile(core, "opt.mlir"), self.tmpcorefile(core, "chesslinked.ll"))
+        await self.do_call(task, ['xchesscc_wrapper', self.aie_target.lower(), '+w', os.path.join(self.tmpdirname, 'work'), '-c', '-d', '-f', '+P', '4', file_core_llvmir_chesslinked, '-o', file_core_obj])
+      else:
+        (opt_level, opt_flags) = self.core_opt_flags(core)
+        file_core_llvmir_stripped = self.tmpcorefile(core, "stripped.ll")
+        if(kernels):
+          file_core_llvmir_lto = self.tmpcorefile(core, "lto.ll")
+          await self.do_call(task, ['llvm-link', '--opaque-pointers=0', file_core_llvmir, *kernels, '-S', '-o', file_core_llvmir_lto])
+          # Only the entry point of the core stays visible.  The kernels can
+          # then be inlined and specialized, and don't clash with the kernel
+          # objects that are still linked in.
+          await self.do_call(task, ['opt', '--passes=internalize,default<O%d>,strip' % opt_level, *opt_flags,
+                                    '--internalize-public-api-list=core_%d_%d' % core[0:2],
+                                    '-S', file_core_llvmir_lto, '-o', file_core_llvmir_stripped])
+        else:
+          await self.do_call(task, ['opt', '--passes=default<O%d>,strip' % opt_level, *opt_flags, '-S', file_core_llvmir, '-o', file_core_llvmir_stripped])
+        await self.do_call(task, ['llc', file_core_llvmir_stripped, '-O%d' % opt_level, '--march=aie', '--function-sections', '--filetype=obj', '-o', file_core_obj])
+
+  # The optimization level and the opt flags for a core, as selected by the
+  # compile_options attribute of the core and the profile (--pgo-profile).
+  def core_opt_flags(self, core):
+      options = self.core_options.get(tuple(core[0:2]), {})
+      flags = []
+      if('inline_threshold' in options):
+        flags.append('-inline-threshold=%d' % options['inline_threshold'])
+      if('unroll_threshold' in options):
+        flags.append('-unroll-threshold=%d' % options['unroll_threshold'])
+      if('vector_width' in options):
+        flags.append('-force-vector-width=%d' % options['vector_width'])
+      if('interleave' in options):
+        flags.append('-force-vector-interleave=%d' % options['interleave'])
+      if(options.get('unroll_runtime')):
+        flags.append('-unroll-runtime')
+      return (options.get('opt_level', 2), flags)
+
+  # The sources of the external kernels linked with a core, found next to
+  # their objects.  Kernels without a source are only linked as objects.
+  def kernel_sources(self, file_core_linkinfo):
+      sources = []
+      for obj in aiecc.cache.linked_inputs(file_core_linkinfo):
+        base = os.path.splitext(obj)[0]
+        candidates = [base + ext for ext in ['.cc', '.cpp', '.c'] if os.path.isfile(base + ext)]
+        if(candidates):
+          sources.append(candidates[0])
+        elif(self.opts.verbose):
+          print("No source found for %s, linking it without LTO" % obj)
+      return sources
+
+  # Compile kernel sources to LLVM IR.  Each source is compiled once, no
+  # matter how many cores use it.
+  async def kernel_llvmir(self, task, sources):
+      result = []
+      for source in sources:
+        if(source not in self.kernels):
+          file_kernel_llvmir = os.path.join(self.tmpdirname, os.path.splitext(os.path.basename(source))[0] + '.kernel.ll')
+          compiled = asyncio.ensure_future(self.do_call(task, ['clang', '-O2', '--target=' + self.aie_peano_target, *self.aie_target_defines(),
+                                                               '-Xclang', '-no-opaque-pointers', '-emit-llvm', '-S', source, '-o', file_kernel_llvmir]))
+          self.kernels[source] = (compiled, file_kernel_llvmir)
+        (compiled, file_kernel_llvmir) = self.kernels[source]
+        await compiled
+        result.append(file_kernel_llvmir)
+      return result
+
+  # The artifacts produced for a core, keyed by their name in the cache.
+  def core_cache_artifacts(self, core, file_core_elf):
+      if(self.opts.link):
+        return {'core.elf': file_core_elf}
+      return {'core.o': self.tmpcorefile(core, "o")}
+
+  # Everything besides the input files and tools that changes the code
+  # generated for a core.
+  def core_cache_flags(self, core):
+      return [self.aie_target,
+              repr(self.core_opt_flags(core)),
+              'xchesscc=%s' % self.opts.xchesscc,
+              'xbridge=%s' % self.opts.xbridge,
+              'link=%s' % self.opts.link,
+              'lto=%s' % self.opts.lto,
+              *aie_opt_passes]
+
   async def process_host_cgen(self):
     async with self.limit:
       if(self.stopall):
@@ -247,11 +431,16 @@ class flow_runner:
       else:
         task = None
 
-      # Generate the included host interface
+      # Route the design.  Broadcast, packet and multicast flows have already
+      # been lowered in input_with_addresses.mlir, so only the circuit
+      # switched flows are left.  The result is shared with gen_sim.
       file_physical = os.path.join(self.tmpdirname, 'input_physical.mlir')
-      await self.do_call(task, ['aie-opt', '--aie-create-pathfinder-flows', '--aie-lower-broadcast-packet', '--aie-create-packet-flows', '--aie-lower-multicast', self.file_with_addresses, '-o', file_physical]);
+      await self.do_call(task, ['aie-opt', '--aie-create-pathfinder-flows', self.file_with_addresses, '-o', file_physical]);
+
+      # Generate the included host interface
       file_inc_cpp = os.path.join(self.tmpdirname, 'aie_inc.cpp')
       await self.do_call(task, ['aie-translate', '--aie-generate-xaie', file_physical, '-o', file_inc_cpp])
+      self.host_interface_ready.set()
 
       cmd = ['clang','-std=c++11']
       if(opts.host_target):
@@ -296,6 +485,10 @@ class flow_runner:
         self.progress_bar.update(task,advance=0,visible=False)
 
   async def gen_sim(self, task):
+      # The simulation build needs the routed design and aie_inc.cpp from
+      # process_host_cgen, but not the host program itself.
+      await self.host_interface_ready.wait()
+
       # For simulation, we need to additionally parse the 'remaining' options to avoid things
       # which conflict with the options below (e.g. -o)
       print(opts.host_args)
@@ -395,7 +588,8 @@ class flow_runner:
       if(nworkers == 0):
         nworkers = os.cpu_count()
 
-      self.limit = asyncio.Semaphore(nworkers)
+      self.nworkers = nworkers
+      self.limit = aiecc.profile.worker_pool(nworkers)
       with progress.Progress(
         *progress.Progress.get_default_columns(),
         progress.TimeElapsedColumn(),
@@ -420,6 +614,14 @@ class flow_runner:
                                           '-convert-scf-to-cf', opts.filename, '-o', self.file_with_addresses], True)
         t = self.do_run(['aie-translate', '--aie-generate-corelist', self.file_with_addresses])
         cores = eval(t.stdout)
+        t = self.do_run(['aie-translate', '--aie-generate-core-options', self.file_with_addresses])
+        self.core_options = eval(t.stdout)
+        if(opts.pgo_profile):
+          # Options set on the cores themselves win over the profile.
+          for (coord, options) in aiecc.pgo.core_options(aiecc.pgo.load(opts.pgo_profile)).items():
+            self.core_options[coord] = {**options, **self.core_options.get(coord, {})}
+            if(opts.verbose):
+              print("Profile selects %s for core (%d, %d)" % (self.core_options[coord], *coord))
         t = self.do_run(['aie-translate', '--aie-generate-target-arch', self.file_with_addresses])
         self.aie_target = t.stdout.strip()
         if(not re.fullmatch('AIE.?', self.aie_target)):
@@ -427,7 +629,7 @@ class flow_runner:
           exit(-3)
         self.aie_peano_target = self.aie_target.lower() + "-none-elf"
 
-        await self.prepare_for_chesshack(progress_bar.task)
+        await self.prepare_chess_intrinsic_wrapper(progress_bar.task)
 
         if(opts.unified):
           self.file_opt_with_addresses = os.path.join(self.tmpdirname, 'input_opt_with_addresses.mlir')
@@ -441,7 +643,7 @@ class flow_runner:
 
           self.file_obj = os.path.join(self.tmpdirname, 'input.o')
           if(opts.compile and opts.xchesscc):
-            file_llvmir_hacked = await self.chesshack(progress_bar.task, self.file_llvmir)
+            file_llvmir_hacked = await self.chess_llvmir(progress_bar.task, self.file_opt_with_addresses, os.path.join(self.tmpdirname, 'input.chesslinked.ll'))
             await self.do_call(progress_bar.task, ['xchesscc_wrapper', self.aie_target.lower(), '+w', os.path.join(self.tmpdirname, 'work'), '-c', '-d', '-f', '+P', '4', file_llvmir_hacked, '-o', self.file_obj])
           elif(opts.compile):
             self.file_llvmir_opt= os.path.join(self.tmpdirname, 'input.opt.ll')
@@ -449,12 +651,23 @@ class flow_runner:
 
             await self.do_call(progress_bar.task, ['llc', self.file_llvmir_opt, '-O2', '--march=aie', '--function-sections', '--filetype=obj', '-o', self.file_obj])
 
+        elif(opts.in_process_lowering):
+          # Parse the design once and lower all the cores in parallel,
+          # instead of running aie-opt and aie-translate for each core.
+          await self.do_call(progress_bar.task, ['aie-lower-cores', '--opaque-pointers=0',
+                              '--core-pipeline=' + pass_pipeline(aie_opt_passes),
+                              '--emit-bcf' if opts.xbridge else '--emit-ldscript',
+                              '-j', str(nworkers),
+                              '--output-dir', self.tmpdirname,
+                              self.file_with_addresses])
+
         progress_bar.update(progress_bar.task,advance=0,visible=False)
         progress_bar.task_completed = progress_bar.add_task("[green] AIE Compilation:", total=len(cores)+1, command="%d Workers" % nworkers)
 
+        # Host code generation only depends on input_with_addresses.mlir, so
+        # it runs alongside the cores instead of ahead of them.
+        self.host_interface_ready = asyncio.Event()
         processes = [self.process_host_cgen()]
-        await asyncio.gather(*processes) # ensure that process_host_cgen finishes before running gen_sim
-        processes = []
         if(opts.aiesim):
           processes.append(self.gen_sim(progress_bar.task))
         for core in cores:
@@ -466,6 +679,11 @@ class flow_runner:
       for i in range(50):
         if(i < len(sortedruntimes)):
           print("%.4f sec: %s" % (sortedruntimes[i][1], sortedruntimes[i][0]))
+      if(self.profiler and self.profiler.events):
+        self.profiler.dump_summary(self.nworkers)
+        tracefile = os.path.join(self.tmpdirname, 'aiecc.trace.json')
+        self.profiler.write_trace(tracefile, self.nworkers)
+        print("Trace written to " + tracefile)
 
 
 def main(builtin_params={}):
@@ -516,6 +734,12 @@ def main(builtin_params={}):
     if(opts.aiesim and not opts.xbridge):
       sys.exit("AIE Simulation (--aiesim) currently requires --xbridge")
 
+    if(opts.lto and (opts.xchesscc or opts.unified)):
+      sys.exit("LTO (--lto) requires the non-unified flow compiling with Peano (--no-unified --no-xchesscc)")
+
+    if(opts.remote_workers and not opts.cachedir):
+      sys.exit("Remote workers (--remote-workers) require a shared cache directory (--cache-dir)")
+
     if(opts.verbose):
         sys.stderr.write('\ncompiling %s\n' % opts.filename)
 
@@ -536,3 +760,6 @@ def main(builtin_params={}):
 
     if(opts.profiling):
       runner.dumpprofile()
+
+    if(runner.cache and opts.verbose):
+      print("Cache: %d hits, %d misses" % (runner.cache.hits, runner.cache.misses))
@@ -0,0 +1,70 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2023 Xilinx Inc.
+
+"""
+Profile-guided selection of per-core compile options.
+
+A profile is a JSON file with the cycles measured for each core (from the
+performance counters or aiesim), optionally broken down by loop:
+
+  {
+    "cores": {
+      "1,2": {"cycles": 1200000,
+              "loops": [{"trip_count": 256, "cycles": 1100000}]},
+      "2,2": {"cycles": 5000}
+    }
+  }
+
+Cores that account for a large share of the cycles are built for speed:
+more inlining and unrolling, and runtime unrolling when their hot loops run
+long.  Cores that barely run are built at -O1, which inlines and unrolls
+little, so that they don't spend program memory on code that doesn't pay off.
+Options given explicitly with compile_options on a core always take
+precedence over the ones derived from the profile.
+"""
+
+import json
+
+# Share of the total cycles above which a core is hot, and below which it is
+# cold.
+HOT_SHARE = 0.10
+COLD_SHARE = 0.01
+
+# Loops of hot cores with at least this many iterations are unrolled at
+# runtime.
+RUNTIME_UNROLL_TRIP_COUNT = 64
+
+hot_options = {'opt_level': 3, 'inline_threshold': 1000, 'unroll_threshold': 1200}
+cold_options = {'opt_level': 1}
+
+def load(filename):
+    with open(filename, 'r') as f:
+      profile = json.load(f)
+    cores = dict()
+    for (coord, data) in profile.get('cores', {}).items():
+      (col, row) = (int(x) for x in coord.split(','))
+      cores[(col, row)] = data
+    return cores
+
+# Derive the compile options of each core in the profile.
+def core_options(cores):
+    total = sum(data.get('cycles', 0) for data in cores.values())
+    result = dict()
+    if(total == 0):
+      return result
+    for (coord, data) in cores.items():
+      share = data.get('cycles', 0) / total
+      if(share >= HOT_SHARE):
+        options = dict(hot_options)
+        loops = data.get('loops', [])
+        hot_loops = [l for l in loops if l.get('cycles', 0) >= HOT_SHARE * data['cycles']]
+        if(any(l.get('trip_count', 0) >= RUNTIME_UNROLL_TRIP_COUNT for l in hot_loops)):
+          options['unroll_runtime'] = 1
+        result[coord] = options
+      elif(share < COLD_SHARE):
+        result[coord] = dict(cold_options)
+    return result
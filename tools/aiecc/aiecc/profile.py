@@ -0,0 +1,182 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2023 Xilinx Inc.
+
+"""
+Build profiling for aiecc.
+
+Every command is recorded with its start and end time and the worker slot it
+ran in.  MLIR tools are run with --mlir-timing so that the time spent in each
+pass is known as well.  The result can be written as a Chrome trace
+(chrome://tracing or https://ui.perfetto.dev) and summarized on the console.
+The summary includes the critical path of the build, i.e. the chain of
+commands that determined how long it took.
+"""
+
+import asyncio
+import contextvars
+import json
+import os
+import re
+
+# The worker slot of the running coroutine.  Slot 0 is the driver itself,
+# i.e. commands that are not issued from within a worker_pool.
+current_slot = contextvars.ContextVar('current_slot', default=0)
+
+# Tools that accept the MLIR timing options.
+mlir_tools = ['aie-opt', 'aie-lower-cores']
+mlir_timing_args = ['--mlir-timing', '--mlir-timing-display=tree']
+
+# A limit on the number of concurrently running workers, like
+# asyncio.Semaphore, that also hands out a slot number to each worker.
+class worker_pool:
+  def __init__(self, nworkers):
+      self.nworkers = nworkers
+      self.semaphore = asyncio.Semaphore(nworkers)
+      self.free = list(range(nworkers, 0, -1))
+
+  async def __aenter__(self):
+      await self.semaphore.acquire()
+      current_slot.set(self.free.pop())
+
+  async def __aexit__(self, exc_type, exc, tb):
+      self.free.append(current_slot.get())
+      current_slot.set(0)
+      self.semaphore.release()
+
+class event:
+  def __init__(self, name, start, end, slot, args):
+      self.name = name
+      self.start = start
+      self.end = end
+      self.slot = slot
+      self.args = args
+      self.children = []
+
+class profiler:
+  def __init__(self):
+      self.events = []
+      self.origin = None
+
+  def wants_mlir_timing(self, command):
+      return os.path.basename(command[0]) in mlir_tools
+
+  def record(self, command, start, end, mlir_timing=None):
+      if(self.origin is None):
+        self.origin = start
+      e = event(os.path.basename(command[0]), start, end, current_slot.get(),
+                {'command': " ".join(command)})
+      if(mlir_timing):
+        e.children = self.parse_mlir_timing(mlir_timing, start)
+      self.events.append(e)
+
+  # Parse the tree display of --mlir-timing, e.g.
+  #
+  #   ----Wall Time----  ----Name----
+  #     0.0030 ( 14.9%)  Parser
+  #     0.0150 ( 74.2%)  'AIE.device' Pipeline
+  #     0.0100 ( 49.6%)    AIELocalizeLocks
+  #     0.0203 (100.0%)  Total
+  #
+  # into nested events.  Nesting follows the indentation of the names and
+  # siblings are laid out back to back from the start of their parent, which
+  # matches the execution order for the sequential parts of the pipeline.
+  # When user time is reported as well, the last (wall) time is used.
+  def parse_mlir_timing(self, text, start):
+      line_re = re.compile(r'^\s*(?:[0-9.]+ \(\s*[0-9.]+%\)\s+)*([0-9.]+) \(\s*[0-9.]+%\)  ( *)(\S.*)$')
+      roots = []
+      stack = [] # (depth, event, next child start)
+      cursor = start
+      for line in text.splitlines():
+        m = line_re.match(line)
+        if(not m):
+          continue
+        (seconds, indent, name) = m.groups()
+        if(name == 'Total'):
+          continue
+        depth = len(indent) // 2
+        while(stack and stack[-1][0] >= depth):
+          stack.pop()
+        if(stack):
+          (_, parent, childstart) = stack[-1]
+        else:
+          (parent, childstart) = (None, cursor)
+        e = event(name, childstart, childstart + float(seconds), current_slot.get(), {})
+        if(parent):
+          parent.children.append(e)
+          stack[-1] = (stack[-1][0], parent, e.end)
+        else:
+          roots.append(e)
+          cursor = e.end
+        stack.append((depth, e, e.start))
+      return roots
+
+  def all_events(self, events=None):
+      for e in (self.events if events is None else events):
+        yield e
+        yield from self.all_events(e.children)
+
+  def write_trace(self, filename, nworkers):
+      def us(t):
+        return int((t - self.origin) * 1e6)
+      critical = self.critical_path()
+      trace = []
+      for slot in range(nworkers + 1):
+        trace.append({'name': 'thread_name', 'ph': 'M', 'pid': 1, 'tid': slot,
+                      'args': {'name': 'worker %d' % slot if slot else 'driver'}})
+      for e in self.all_events():
+        trace.append({'name': e.name, 'cat': 'pass' if e not in self.events else 'command',
+                      'ph': 'X', 'pid': 1, 'tid': e.slot,
+                      'ts': us(e.start), 'dur': max(us(e.end) - us(e.start), 1),
+                      'args': dict(e.args, critical_path=True) if e in critical else e.args})
+      with open(filename, 'w') as f:
+        json.dump({'traceEvents': trace, 'displayTimeUnit': 'ms'}, f)
+
+  # Fraction of the available worker time that was spent running commands.
+  def utilization(self, nworkers):
+      slotted = [e for e in self.events if e.slot != 0]
+      if(not slotted):
+        return 0.0
+      first = min(e.start for e in slotted)
+      last = max(e.end for e in slotted)
+      busy = sum(e.end - e.start for e in slotted)
+      return busy / (nworkers * (last - first)) if last > first else 1.0
+
+  # The chain of commands that determined the duration of the build.  Commands
+  # don't record what they waited for, so starting from the command that ended
+  # last, the command that a command waited for is taken to be the one that
+  # ended last before it started.  The time between them was spent in the
+  # driver.
+  def critical_path(self):
+      path = []
+      current = max(self.events, key=lambda e: e.end, default=None)
+      while(current):
+        path.append(current)
+        preceding = [e for e in self.events if e.end <= current.start]
+        current = max(preceding, key=lambda e: e.end, default=None)
+      path.reverse()
+      return path
+
+  def dump_summary(self, nworkers):
+      passes = dict()
+      for command in self.events:
+        for e in self.all_events(command.children):
+          if(not e.children):
+            passes[e.name] = passes.get(e.name, 0.0) + (e.end - e.start)
+      if(passes):
+        print("Most expensive MLIR passes (summed over all invocations):")
+        for (name, seconds) in sorted(passes.items(), key=lambda item: item[1], reverse=True)[0:20]:
+          print("%.4f sec: %s" % (seconds, name))
+      path = self.critical_path()
+      if(path):
+        commands = dict()
+        for e in path:
+          commands[e.name] = commands.get(e.name, 0.0) + (e.end - e.start)
+        print("Critical path: %.4f sec in %d commands, %.4f sec from first to last command:" %
+              (sum(commands.values()), len(path), path[-1].end - path[0].start))
+        for (name, seconds) in sorted(commands.items(), key=lambda item: item[1], reverse=True):
+          print("%.4f sec: %s" % (seconds, name))
+      print("Worker utilization: %.1f%% of %d workers" % (100.0 * self.utilization(nworkers), nworkers))